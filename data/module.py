@@ -5,13 +5,16 @@ vertexShader = """
 #version 150
 in vec3 position;
 in vec3 normal;
-uniform mat4 mvp;
+layout(std140) uniform Object
+{
+    mat4 mvp[64];
+};
 out vec3 n;
 void main()
 {
     n = 0.5*normalize(normal) + 0.5;
     vec4 pos = vec4(position, 1);
-    gl_Position = mvp * pos;
+    gl_Position = mvp[gl_InstanceID] * pos;
 }
 """
 pixelShader = """
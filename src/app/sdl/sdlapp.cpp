@@ -16,6 +16,7 @@
 
 #include "render/glcontext.h"
 #include "base/log.h"
+#include "base/profiler.h"
 
 #include "engine/engine.h"
 
@@ -145,8 +146,13 @@ void SDLApp::Run()
     Pump();
 
     while( run_ ) {
-        OnFrame();
-        Pump();
+        Engine::beginFrame();
+        {
+            PROFILER_SCOPE( "frame" );
+            OnFrame();
+            Pump();
+        }
+        Profiler::endFrame();
     }
 }
 
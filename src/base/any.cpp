@@ -1,10 +1,24 @@
 #include "base/any.h"
-#include <algorithm>
 
 namespace base {
 
 any& any::swap(any& rhs) {
-    std::swap(content, rhs.content);
+    if (this == &rhs)
+        return *this;
+    any tmp(std::move(rhs));
+    if (!empty())
+        manager_->move(*this, rhs);
+    if (!tmp.empty())
+        tmp.manager_->move(tmp, *this);
+    return *this;
+}
+
+any& any::operator=(any&& rhs) {
+    if (this != &rhs) {
+        clear();
+        if (!rhs.empty())
+            rhs.manager_->move(rhs, *this);
+    }
     return *this;
 }
 
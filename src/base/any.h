@@ -2,60 +2,158 @@
 
 #include "base/types.h"
 #include <type_traits>
+#include <utility>
+#include <new>
 
 namespace base {
 
 //! Any type holder
 //! Unsafe version of boost.any class
 //! https://github.com/ryppl/boost-svn/blob/master/boost/any.hpp
+//! Values up to BufferSize bytes (ints, vectors, Matrix4) are stored inline,
+//! larger ones are allocated on heap
 class NEGINE_API any
 {
+public:
+    static const u32 BufferSize = 64;
+    static const u32 BufferAlign = 16;
+
+    //! Returns true if value of type is stored without allocation
+    template<typename ValueType>
+    static constexpr bool isInline() {
+        return sizeof(ValueType) <= BufferSize && alignof(ValueType) <= BufferAlign;
+    }
+
 private:
-    class placeholder
+    //! Operations of stored type
+    struct manager
+    {
+        void (*destroy)(any& self);
+        void (*copy)(const any& src, any& dst);
+        //! Moves value to empty dst, src is left empty
+        void (*move)(any& src, any& dst);
+        void* (*get)(any& self);
+    };
+
+    template<typename ValueType>
+    struct inline_manager
     {
-    public:
-        virtual ~placeholder() {}
-        virtual placeholder* clone() = 0;
+        static ValueType* ptr(any& self) {
+            return reinterpret_cast<ValueType*>(&self.storage_);
+        }
+        static void destroy(any& self) {
+            ptr(self)->~ValueType();
+        }
+        static void copy(const any& src, any& dst) {
+            new (&dst.storage_) ValueType(*ptr(const_cast<any&>(src)));
+            dst.manager_ = src.manager_;
+        }
+        static void move(any& src, any& dst) {
+            new (&dst.storage_) ValueType(std::move(*ptr(src)));
+            dst.manager_ = src.manager_;
+            destroy(src);
+            src.manager_ = nullptr;
+        }
+        static void* get(any& self) {
+            return ptr(self);
+        }
+        static const manager* instance() {
+            static const manager m = { &destroy, &copy, &move, &get };
+            return &m;
+        }
     };
 
     template<typename ValueType>
-    class holder : public placeholder
+    struct heap_manager
     {
-    public:
-        holder(const ValueType& value) : held(value) {}
-        placeholder* clone() { return new holder(held); }
-        ValueType held;
+        static ValueType*& ptr(any& self) {
+            return *reinterpret_cast<ValueType**>(&self.storage_);
+        }
+        static void destroy(any& self) {
+            delete ptr(self);
+        }
+        static void copy(const any& src, any& dst) {
+            ptr(dst) = new ValueType(*ptr(const_cast<any&>(src)));
+            dst.manager_ = src.manager_;
+        }
+        static void move(any& src, any& dst) {
+            ptr(dst) = ptr(src);
+            dst.manager_ = src.manager_;
+            src.manager_ = nullptr;
+        }
+        static void* get(any& self) {
+            return ptr(self);
+        }
+        static const manager* instance() {
+            static const manager m = { &destroy, &copy, &move, &get };
+            return &m;
+        }
     };
+
+    template<typename ValueType, typename Arg>
+    void construct(Arg&& value, std::true_type) {
+        new (&storage_) ValueType(std::forward<Arg>(value));
+        manager_ = inline_manager<ValueType>::instance();
+    }
+
+    template<typename ValueType, typename Arg>
+    void construct(Arg&& value, std::false_type) {
+        heap_manager<ValueType>::ptr(*this) = new ValueType(std::forward<Arg>(value));
+        manager_ = heap_manager<ValueType>::instance();
+    }
+
+    template<typename ValueType>
+    using enable_value = typename std::enable_if<
+        !std::is_same<typename std::decay<ValueType>::type, any>::value>::type;
+
 public:
     template<typename ValueType>
     friend ValueType* any_cast(any*);
 
-    any() : content(nullptr) {}
+    any() : manager_(nullptr) {}
 
-    any(const any& rhs) : content(nullptr) {
-        if (!rhs.empty()) 
-            content = rhs.content->clone();
+    any(const any& rhs) : manager_(nullptr) {
+        if (!rhs.empty())
+            rhs.manager_->copy(rhs, *this);
     }
 
-    template<typename ValueType>
-    any(const ValueType& value) : content(new holder<ValueType>(value)) {}
+    any(any&& rhs) : manager_(nullptr) {
+        if (!rhs.empty())
+            rhs.manager_->move(rhs, *this);
+    }
 
-    ~any() { delete content; }
+    template<typename ValueType, typename = enable_value<ValueType>>
+    any(ValueType&& value) : manager_(nullptr) {
+        typedef typename std::decay<ValueType>::type T;
+        construct<T>(std::forward<ValueType>(value),
+            std::integral_constant<bool, isInline<T>()>());
+    }
 
-    any& swap(any& rhs);
-    any& operator=(any rhs) { rhs.swap(*this); return *this; }
-    template<typename ValueType>
-    any& operator=(const ValueType& value) { any(value).swap(*this); return *this; }
+    ~any() { clear(); }
 
-    bool empty() const { return !content; }
+    any& swap(any& rhs);
+    any& operator=(const any& rhs) { any(rhs).swap(*this); return *this; }
+    any& operator=(any&& rhs);
+    template<typename ValueType, typename = enable_value<ValueType>>
+    any& operator=(ValueType&& value) { any(std::forward<ValueType>(value)).swap(*this); return *this; }
+
+    bool empty() const { return !manager_; }
+
+    void clear() {
+        if (manager_) {
+            manager_->destroy(*this);
+            manager_ = nullptr;
+        }
+    }
 
 private:
-    placeholder* content;
+    typename std::aligned_storage<BufferSize, BufferAlign>::type storage_;
+    const manager* manager_;
 };
 
 template<typename ValueType>
 inline ValueType* any_cast(any* operand) {
-    return &static_cast<any::holder<ValueType>*>(operand->content)->held;
+    return static_cast<ValueType*>(operand->manager_->get(*operand));
 }
 
 template<typename ValueType>
@@ -0,0 +1,158 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "base/cpu.h"
+#include "base/env.h"
+#include <string.h>
+
+#if defined(OS_CPU_X86)
+# if defined(COMPILER_MSVC)
+#  include <intrin.h>
+#  include <immintrin.h>
+# else
+#  include <cpuid.h>
+# endif
+#endif
+
+namespace base
+{
+namespace cpu
+{
+
+namespace {
+
+const char* kTierNames[] = { "baseline", "sse41", "avx2" };
+
+#if defined(OS_CPU_X86)
+
+void cpuid(u32 leaf, u32 subleaf, u32 regs[4])
+{
+# if defined(COMPILER_MSVC)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; i++)
+        regs[i] = static_cast<u32>(info[i]);
+# else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+# endif
+}
+
+//! Extended control register 0: which register states OS saves on context switch
+u64 xgetbv0()
+{
+# if defined(COMPILER_MSVC)
+    return _xgetbv(0);
+# else
+    u32 lo, hi;
+    __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<u64>(hi) << 32) | lo;
+# endif
+}
+
+u32 detect()
+{
+    u32 regs[4];
+    cpuid(0, 0, regs);
+    const u32 maxLeaf = regs[0];
+    if (maxLeaf < 1)
+        return 0;
+
+    u32 result = 0;
+    cpuid(1, 0, regs);
+    const u32 ecx1 = regs[2];
+    if (ecx1 & (1u << 19))
+        result |= Features::SSE41;
+    // AVX needs both CPU support and OS saving xmm and ymm state
+    const bool osxsave = (ecx1 & (1u << 27)) != 0;
+    if (osxsave && (ecx1 & (1u << 28)) && (xgetbv0() & 0x6) == 0x6) {
+        result |= Features::AVX;
+        if (ecx1 & (1u << 12))
+            result |= Features::FMA;
+        if (maxLeaf >= 7) {
+            cpuid(7, 0, regs);
+            if (regs[1] & (1u << 5))
+                result |= Features::AVX2;
+        }
+    }
+    return result;
+}
+
+#else
+
+u32 detect()
+{
+    return 0;
+}
+
+#endif
+
+Tier tierOf(u32 features)
+{
+    const u32 avx2 = Features::AVX | Features::AVX2 | Features::FMA;
+    if ((features & avx2) == avx2)
+        return Tier::AVX2;
+    if (features & Features::SSE41)
+        return Tier::SSE41;
+    return Tier::Baseline;
+}
+
+const u32 features_ = detect();
+
+Tier initialTier()
+{
+    Tier supported = tierOf(features_);
+    std::string name = env::variable("NEGINE_CPU", "");
+    if (name.empty())
+        return supported;
+    Tier forced;
+    if (!parseTier(name.c_str(), forced))
+        return supported;
+    return forced < supported ? forced : supported;
+}
+
+Tier tier_ = initialTier();
+
+} // namespace
+
+u32 features()
+{
+    return features_;
+}
+
+Tier supportedTier()
+{
+    return tierOf(features_);
+}
+
+Tier tier()
+{
+    return tier_;
+}
+
+Tier setTier(Tier tier)
+{
+    Tier supported = supportedTier();
+    tier_ = tier < supported ? tier : supported;
+    return tier_;
+}
+
+const char* tierName(Tier tier)
+{
+    return kTierNames[static_cast<u32>(tier)];
+}
+
+bool parseTier(const char* name, Tier& tier)
+{
+    for (u32 i = 0; i < sizeof(kTierNames) / sizeof(kTierNames[0]); i++) {
+        if (strcmp(name, kTierNames[i]) == 0) {
+            tier = static_cast<Tier>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace cpu
+} // namespace base
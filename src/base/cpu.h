@@ -0,0 +1,62 @@
+/**
+ * \file
+ * \brief       CPU feature detection and kernel tier selection
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ *
+ * Build targets baseline x86-64 (SSE2). Kernels which have wider variants
+ * check cpu::tier() and call the best one supported by running CPU.
+ * NEGINE_CPU environment variable (baseline, sse41, avx2) lowers the tier,
+ * e.g. to compare variants in benchmarks
+ **/
+#pragma once
+
+#include "base/types.h"
+
+namespace base
+{
+namespace cpu
+{
+
+//! Instruction set extensions above baseline
+namespace Features
+{
+enum Feature {
+    SSE41 = 1 << 0,
+    AVX   = 1 << 1,     //!< includes OS support of ymm registers
+    AVX2  = 1 << 2,
+    FMA   = 1 << 3,
+};
+}
+typedef Features::Feature Feature;
+
+//! Kernel variants, ordered
+enum class Tier : u8 {
+    Baseline,       //!< SSE2 on x86-64, scalar elsewhere
+    SSE41,
+    AVX2,           //!< AVX2 and FMA
+};
+
+//! Detected features, bit mask of Feature
+NEGINE_API u32 features();
+
+inline bool has(Feature feature) {
+    return (features() & feature) != 0;
+}
+
+//! Best tier supported by CPU
+NEGINE_API Tier supportedTier();
+
+//! Tier used by kernels
+NEGINE_API Tier tier();
+
+//! Changes tier used by kernels, clamped to supported one. Returns tier set
+NEGINE_API Tier setTier(Tier tier);
+
+NEGINE_API const char* tierName(Tier tier);
+
+//! Parses tier name, returns false for unknown one
+NEGINE_API bool parseTier(const char* name, Tier& tier);
+
+} // namespace cpu
+} // namespace base
@@ -2,22 +2,29 @@
 #ifdef OS_UNIX
     #include <unistd.h>
 #endif
-#include <fstream>
+#include <sys/stat.h>
+#include <stdlib.h>
 
 namespace base {
-    
-#ifdef OS_UNIX
-    std::string Env::variable(const std::string& name, const std::string& def)
+namespace env {
+
+    std::string variable(const std::string& name, const std::string& def)
     {
         char* value = getenv(name.c_str());
         if (!value) return def;
         return std::string(value);
     }
-#endif
 
     bool fileExists( const std::string& name )
     {
-        std::ifstream f( name.c_str() );;
-        return f.is_open() && f.good();
+        // stat only, opening a stream costs open/close and buffer allocation
+#ifdef OS_WIN
+        struct _stat64 st;
+        return _stat64( name.c_str(), &st ) == 0;
+#else
+        struct stat st;
+        return stat( name.c_str(), &st ) == 0;
+#endif
     }
 }
+}
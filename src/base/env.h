@@ -5,7 +5,7 @@
 
 namespace base {
     namespace env {
-        static std::string variable(const std::string& name, const std::string& def);
+        std::string variable(const std::string& name, const std::string& def);
         bool fileExists(const std::string& name);
     }
-}
\ No newline at end of file
+}
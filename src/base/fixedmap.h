@@ -60,7 +60,7 @@ public:
     }
     void merge(const SelfT& other) {
         for (Iterator it = other.iterator(); !it.isDone(); it.advance())
-            (*this)[it.name()] = it.value();
+            (*this)[it.key()] = it.value();
     }
     void clear() {
         map_.clear();
@@ -0,0 +1,96 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "base/frameallocator.h"
+#include "base/debug.h"
+
+namespace base {
+
+FrameAllocator::FrameAllocator(foundation::Allocator& backing, u32 size)
+    : backing_(backing)
+    , current_(0)
+    , lastFrameUsed_(0)
+    , lastFrameOverflows_(0)
+    , highWater_(0)
+{
+    for (Arena& arena : arenas_) {
+        arena.data = nullptr;
+        arena.size = 0;
+        arena.offset.store(0, std::memory_order_relaxed);
+        arena.overflowBytes = 0;
+        reset(arena, size);
+    }
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    for (Arena& arena : arenas_) {
+        reset(arena, 0);
+    }
+}
+
+void FrameAllocator::reset(Arena& arena, u32 size)
+{
+    for (void* p : arena.overflow)
+        backing_.deallocate(p);
+    arena.overflow.clear();
+    arena.overflowBytes = 0;
+    if (size != arena.size) {
+        backing_.deallocate(arena.data);
+        arena.data = size != 0 ? static_cast<u8*>(backing_.allocate(size, 16)) : nullptr;
+        arena.size = size;
+    }
+    arena.offset.store(0, std::memory_order_relaxed);
+}
+
+void* FrameAllocator::allocate(u32 size, u32 align)
+{
+    Arena& arena = arenas_[current_];
+    // reserve worst case padding, so bump is a single atomic add
+    u32 reserve = size + align - 1;
+    u32 offset = arena.offset.fetch_add(reserve, std::memory_order_relaxed);
+    if (offset + reserve <= arena.size && offset + reserve >= offset) {
+        void* p = foundation::memory::align_forward(arena.data + offset, align);
+        return p;
+    }
+    return allocateOverflow(arena, size, align);
+}
+
+void* FrameAllocator::allocateOverflow(Arena& arena, u32 size, u32 align)
+{
+    std::lock_guard<std::mutex> guard(overflowLock_);
+    void* p = backing_.allocate(size, align);
+    arena.overflow.push_back(p);
+    arena.overflowBytes += size;
+    return p;
+}
+
+u32 FrameAllocator::used() const
+{
+    const Arena& arena = arenas_[current_];
+    u32 offset = arena.offset.load(std::memory_order_relaxed);
+    if (offset > arena.size)
+        offset = arena.size;
+    return offset + arena.overflowBytes;
+}
+
+void FrameAllocator::beginFrame()
+{
+    Arena& finished = arenas_[current_];
+    lastFrameUsed_ = used();
+    lastFrameOverflows_ = static_cast<u32>(finished.overflow.size());
+    if (lastFrameUsed_ > highWater_)
+        highWater_ = lastFrameUsed_;
+
+    current_ ^= 1;
+    Arena& next = arenas_[current_];
+    // grow arena, so the high-water frame fits without overflow
+    u32 size = next.size;
+    if (highWater_ > size)
+        size = highWater_ + highWater_ / 4;
+    reset(next, size);
+}
+
+} // namespace base
@@ -0,0 +1,77 @@
+/**
+ * \file
+ * \brief       double-buffered per-frame linear allocator
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "foundation/memory.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace base {
+
+//! Linear arena for transient per-frame allocations
+//!
+//! Allocation is an atomic pointer bump, deallocate() does nothing.
+//! There are two arenas: memory of the previous frame stays valid during
+//! the current one, beginFrame() releases the frame before the previous.
+//! When an arena is exhausted, overflow blocks are taken from the backing
+//! allocator, the arena grows to the high-water mark on the next reset.
+class FrameAllocator : public foundation::Allocator
+{
+public:
+    NEGINE_API FrameAllocator(foundation::Allocator& backing, u32 size);
+    NEGINE_API ~FrameAllocator();
+
+    NEGINE_API void* allocate(u32 size, u32 align = DEFAULT_ALIGN);
+    //! Memory is released by beginFrame()
+    void deallocate(void*) {}
+    u32 allocated_size(void*) { return SIZE_NOT_TRACKED; }
+    //! Returns bytes used in the current frame
+    u32 total_allocated() { return used(); }
+
+    //! Switches arenas and releases memory of the frame before the previous
+    NEGINE_API void beginFrame();
+
+    //! Bytes used in the current frame, including overflow
+    NEGINE_API u32 used() const;
+    //! Bytes used in the previous frame
+    u32 lastFrameUsed() const { return lastFrameUsed_; }
+    //! Maximal bytes used by one frame
+    u32 highWater() const { return highWater_; }
+    //! Count of allocations which did not fit into arena, since last frame
+    u32 overflows() const { return lastFrameOverflows_; }
+    //! Size of one arena
+    u32 capacity() const { return arenas_[current_].size; }
+
+private:
+    struct Arena
+    {
+        u8* data;
+        u32 size;
+        std::atomic<u32> offset;
+        //! Blocks taken from backing allocator when arena is full
+        std::vector<void*> overflow;
+        u32 overflowBytes;
+    };
+
+    void reset(Arena& arena, u32 size);
+    void* allocateOverflow(Arena& arena, u32 size, u32 align);
+
+private:
+    foundation::Allocator& backing_;
+    Arena arenas_[2];
+    u32 current_;
+    u32 lastFrameUsed_;
+    u32 lastFrameOverflows_;
+    u32 highWater_;
+    std::mutex overflowLock_;
+
+    DISALLOW_COPY_AND_ASSIGN(FrameAllocator);
+};
+
+} // namespace base
@@ -0,0 +1,379 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "base/io.h"
+#include "base/memorytags.h"
+#include "base/vfs.h"
+#include "base/debug.h"
+#include "base/log.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string.h>
+
+#ifdef OS_UNIX
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#else
+# include <stdio.h>
+# include <sys/stat.h>
+#endif
+
+namespace base {
+namespace io {
+
+namespace {
+
+struct Queued
+{
+    Request request;
+    u32 id;
+};
+
+struct Done
+{
+    Result result;
+    Callback callback;
+    std::string path;
+};
+
+struct Service
+{
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<Queued> requests;
+    bool stop;
+
+    std::mutex completedLock;
+    std::vector<Done> completed;
+
+    std::atomic<u32> nextId;
+    std::atomic<u32> pending;
+    bool running;
+
+    Service() : stop(false), nextId(1), pending(0), running(false) {}
+};
+
+Service service_;
+
+u8* allocate(u64 size)
+{
+    // data of zero sized file is not nullptr, so callbacks do not mix it up with failure
+    return static_cast<u8*>(memory::allocator(MemoryTag::Resources).allocate(
+        static_cast<u32>(size != 0 ? size : 1), 16));
+}
+
+#ifdef OS_UNIX
+
+Status statFile(const std::string& path, u64* size)
+{
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        return Status::NotFound;
+    *size = static_cast<u64>(st.st_size);
+    return Status::Ok;
+}
+
+Status readRange(const std::string& path, u64 offset, u64 size, u8** data, u64* read)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return Status::NotFound;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return Status::NotFound;
+    }
+    u64 fileSize = static_cast<u64>(st.st_size);
+    if (offset > fileSize || (size != 0 && size > fileSize - offset)) {
+        ::close(fd);
+        return Status::Failed;
+    }
+    if (size == 0)
+        size = fileSize - offset;
+    if (size > 0xffffffffULL) {
+        ::close(fd);
+        return Status::Failed;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_SEQUENTIAL);
+#endif
+    u8* buffer = allocate(size);
+    u64 done = 0;
+    while (done < size) {
+        ssize_t n = ::pread(fd, buffer + done, static_cast<size_t>(size - done), static_cast<off_t>(offset + done));
+        if (n <= 0)
+            break;
+        done += static_cast<u64>(n);
+    }
+    ::close(fd);
+    if (done != size) {
+        release(buffer);
+        return Status::Failed;
+    }
+    *data = buffer;
+    *read = size;
+    return Status::Ok;
+}
+
+#else
+
+Status statFile(const std::string& path, u64* size)
+{
+    struct _stat64 st;
+    if (_stat64(path.c_str(), &st) != 0 || (st.st_mode & _S_IFREG) == 0)
+        return Status::NotFound;
+    *size = static_cast<u64>(st.st_size);
+    return Status::Ok;
+}
+
+Status readRange(const std::string& path, u64 offset, u64 size, u8** data, u64* read)
+{
+    u64 fileSize = 0;
+    if (statFile(path, &fileSize) != Status::Ok)
+        return Status::NotFound;
+    if (offset > fileSize || (size != 0 && size > fileSize - offset))
+        return Status::Failed;
+    if (size == 0)
+        size = fileSize - offset;
+    if (size > 0xffffffffULL)
+        return Status::Failed;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return Status::NotFound;
+    if (_fseeki64(file, static_cast<__int64>(offset), SEEK_SET) != 0) {
+        fclose(file);
+        return Status::Failed;
+    }
+    u8* buffer = allocate(size);
+    u64 done = fread(buffer, 1, static_cast<size_t>(size), file);
+    fclose(file);
+    if (done != size) {
+        release(buffer);
+        return Status::Failed;
+    }
+    *data = buffer;
+    *read = size;
+    return Status::Ok;
+}
+
+#endif
+
+//! Packed entries are served from mapped pack, reader thread takes page
+//! faults and decompression instead of polling thread
+Status readPacked(const std::string& path, u64 offset, u64 size, u8** data, u64* read)
+{
+    vfs::File file(path);
+    if (!file.isOpen())
+        return Status::Failed;
+    u64 fileSize = file.size();
+    if (offset > fileSize || (size != 0 && size > fileSize - offset))
+        return Status::Failed;
+    if (size == 0)
+        size = fileSize - offset;
+    if (size > 0xffffffffULL)
+        return Status::Failed;
+    u8* buffer = allocate(size);
+    memcpy(buffer, file.data() + offset, static_cast<size_t>(size));
+    *data = buffer;
+    *read = size;
+    return Status::Ok;
+}
+
+void execute(const Queued& queued, Done& done)
+{
+    const Request& request = queued.request;
+    Result& result = done.result;
+    result.id = queued.id;
+    result.operation = request.operation;
+    result.data = nullptr;
+    result.size = 0;
+    result.user = request.user;
+    result.path = nullptr;
+    u64 packedSize = 0;
+    if (!vfs::packed(request.path, &packedSize)) {
+        if (request.operation == Operation::Stat)
+            result.status = statFile(request.path, &result.size);
+        else
+            result.status = readRange(request.path, request.offset, request.size, &result.data, &result.size);
+    } else if (request.operation == Operation::Stat) {
+        result.status = Status::Ok;
+        result.size = packedSize;
+    } else {
+        result.status = readPacked(request.path, request.offset, request.size, &result.data, &result.size);
+    }
+    done.callback = request.callback;
+    done.path = request.path;
+}
+
+void complete(Done& done)
+{
+    std::lock_guard<std::mutex> guard(service_.completedLock);
+    service_.completed.push_back(std::move(done));
+}
+
+void readerLoop()
+{
+    for (;;) {
+        Queued queued;
+        {
+            std::unique_lock<std::mutex> guard(service_.lock);
+            service_.wake.wait(guard, [] { return service_.stop || !service_.requests.empty(); });
+            if (service_.stop)
+                return;
+            queued = std::move(service_.requests.front());
+            service_.requests.pop_front();
+        }
+        Done done;
+        execute(queued, done);
+        complete(done);
+    }
+}
+
+} // namespace
+
+void init(u32 threads)
+{
+    ASSERT(!service_.running);
+    if (threads == 0)
+        threads = 1;
+    service_.stop = false;
+    for (u32 i = 0; i < threads; i++)
+        service_.threads.push_back(std::thread(readerLoop));
+    service_.running = true;
+}
+
+void shutdown()
+{
+    ASSERT(service_.running);
+    std::deque<Queued> cancelled;
+    {
+        std::lock_guard<std::mutex> guard(service_.lock);
+        service_.stop = true;
+        cancelled.swap(service_.requests);
+    }
+    service_.wake.notify_all();
+    for (std::thread& thread : service_.threads)
+        thread.join();
+    service_.threads.clear();
+    service_.running = false;
+
+    // owners of requests free their state in callbacks, finished reads are
+    // dropped too, loading them could touch already destroyed GL context
+    std::vector<Done> completed;
+    {
+        std::lock_guard<std::mutex> guard(service_.completedLock);
+        completed.swap(service_.completed);
+    }
+    for (Done& done : completed) {
+        release(done.result.data);
+        done.result.status = Status::Cancelled;
+        done.result.data = nullptr;
+        done.result.size = 0;
+        done.result.path = &done.path;
+        if (done.callback != nullptr)
+            done.callback(done.result);
+    }
+    service_.pending.fetch_sub(static_cast<u32>(completed.size()));
+    for (Queued& queued : cancelled) {
+        Result result;
+        result.id = queued.id;
+        result.status = Status::Cancelled;
+        result.operation = queued.request.operation;
+        result.data = nullptr;
+        result.size = 0;
+        result.user = queued.request.user;
+        result.path = &queued.request.path;
+        if (queued.request.callback != nullptr)
+            queued.request.callback(result);
+    }
+    service_.pending.fetch_sub(static_cast<u32>(cancelled.size()));
+}
+
+bool running()
+{
+    return service_.running;
+}
+
+u32 submit(const Request* requests, u32 count)
+{
+    u32 first = service_.nextId.fetch_add(count);
+    service_.pending.fetch_add(count);
+    if (!service_.running) {
+        for (u32 i = 0; i < count; i++) {
+            Queued queued = { requests[i], first + i };
+            Done done;
+            execute(queued, done);
+            complete(done);
+        }
+        return first;
+    }
+    {
+        std::lock_guard<std::mutex> guard(service_.lock);
+        for (u32 i = 0; i < count; i++) {
+            Queued queued = { requests[i], first + i };
+            service_.requests.push_back(std::move(queued));
+        }
+    }
+    if (count == 1)
+        service_.wake.notify_one();
+    else
+        service_.wake.notify_all();
+    return first;
+}
+
+u32 poll()
+{
+    std::vector<Done> completed;
+    {
+        std::lock_guard<std::mutex> guard(service_.completedLock);
+        if (service_.completed.empty())
+            return 0;
+        completed.swap(service_.completed);
+    }
+    for (Done& done : completed) {
+        done.result.path = &done.path;
+        if (done.callback != nullptr)
+            done.callback(done.result);
+        release(done.result.data);
+    }
+    u32 count = static_cast<u32>(completed.size());
+    service_.pending.fetch_sub(count);
+    return count;
+}
+
+void flush()
+{
+    while (service_.pending.load() != 0) {
+        if (poll() == 0)
+            std::this_thread::yield();
+    }
+}
+
+u32 pending()
+{
+    return service_.pending.load();
+}
+
+void release(u8* data)
+{
+    if (data != nullptr)
+        memory::allocator(MemoryTag::Resources).deallocate(data);
+}
+
+Status readFile(const std::string& path, u8** data, u64* size)
+{
+    *data = nullptr;
+    *size = 0;
+    return readRange(path, 0, 0, data, size);
+}
+
+} // namespace io
+} // namespace base
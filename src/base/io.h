@@ -0,0 +1,96 @@
+/**
+ * \file
+ * \brief       asynchronous file reading service
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+#include <string>
+
+namespace base {
+namespace io {
+
+enum class Operation : u8 {
+    Read,   //!< reads [offset, offset + size) into a buffer
+    Stat    //!< only checks file and gets its size
+};
+
+enum class Status : u8 {
+    Ok,
+    NotFound,
+    Failed,     //!< file is opened, but read is short or fails
+    Cancelled   //!< request was not delivered before shutdown
+};
+
+struct Result;
+typedef void (*Callback)(Result& result);
+
+//! Path is resolved through vfs first: packed entries are copied (and
+//! decompressed) from mounted packs on reader thread, other paths are
+//! read from disk
+struct Request
+{
+    std::string path;
+    u64 offset;
+    u64 size;           //!< 0 reads to the end of file
+    Operation operation;
+    Callback callback;  //!< called from poll() on the polling thread
+    void* user;
+
+    Request() : offset(0), size(0), operation(Operation::Read), callback(nullptr), user(nullptr) {}
+    Request(const std::string& p, Callback c, void* u = nullptr)
+        : path(p), offset(0), size(0), operation(Operation::Read), callback(c), user(u) {}
+};
+
+//! Completion of a request. Buffer is freed after the callback, callback
+//! keeps it by setting data to nullptr and frees it later with release()
+struct Result
+{
+    u32 id;
+    Status status;
+    Operation operation;
+    u8* data;           //!< nullptr for Stat and failed requests
+    u64 size;           //!< bytes read, file size for Stat
+    void* user;
+    const std::string* path;
+};
+
+//! Starts reader threads, reads are blocking syscalls, so a couple of
+//! threads is enough to keep the disk queue busy
+NEGINE_API void init(u32 threads = 2);
+//! Waits for reads in flight, then calls callbacks of finished and queued
+//! requests with Cancelled status and without data, so every request is
+//! delivered once. Render context may be gone at shutdown, callbacks only
+//! free their state
+NEGINE_API void shutdown();
+NEGINE_API bool running();
+
+//! Queues batch of requests under one lock, returns id of the first one,
+//! ids of the batch are consecutive. Requests are executed inline
+//! when service is not running, completions are still delivered by poll()
+NEGINE_API u32 submit(const Request* requests, u32 count);
+inline u32 submit(const Request& request) {
+    return submit(&request, 1);
+}
+
+//! Calls callbacks of finished requests on the calling thread, main loop
+//! calls it once per frame. Returns count of delivered completions
+NEGINE_API u32 poll();
+
+//! Polls until every submitted request is delivered
+NEGINE_API void flush();
+
+//! Returns count of submitted and not delivered requests
+NEGINE_API u32 pending();
+
+//! Frees buffer kept by a callback
+NEGINE_API void release(u8* data);
+
+//! Reads whole file from disk, packs are not checked, on the calling thread
+//! into a buffer freed by release()
+NEGINE_API Status readFile(const std::string& path, u8** data, u64* size);
+
+} // namespace io
+} // namespace base
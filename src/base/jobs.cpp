@@ -0,0 +1,305 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "base/jobs.h"
+#include "base/debug.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace base {
+namespace jobs {
+
+namespace {
+
+const u32 kInvalidWorker = u32(-1);
+
+//! Queued job, owner writes it only while it is free
+struct Slot
+{
+    Job job;
+    Counter* counter;
+    //! Cleared by owner when queued, set by executing thread once job is copied
+    std::atomic<bool> free;
+
+    Slot() : counter(nullptr), free(true) {}
+};
+
+//! Chase-Lev work-stealing deque of fixed capacity.
+//! Owner pushes and pops at the bottom, thieves steal from the top
+//! ("Correct and Efficient Work-Stealing for Weak Memory Models")
+class Deque
+{
+public:
+    static const u32 Capacity = 1 << 12;
+    static const u32 Mask = Capacity - 1;
+
+    Deque() : top_(0), bottom_(0) {
+        for (u32 i = 0; i < Capacity; i++)
+            buffer_[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    //! Owner only, returns false when deque is full
+    bool push(Slot* job) {
+        i64 b = bottom_.load(std::memory_order_relaxed);
+        i64 t = top_.load(std::memory_order_acquire);
+        if (b - t >= static_cast<i64>(Capacity))
+            return false;
+        buffer_[b & Mask].store(job, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! Owner only
+    Slot* pop() {
+        i64 b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Slot* job = buffer_[b & Mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // last element, race with thieves
+            if (!top_.compare_exchange_strong(t, t + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    //! Any thread
+    Slot* steal() {
+        i64 t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 b = bottom_.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+        Slot* job = buffer_[t & Mask].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+private:
+    std::atomic<i64> top_;
+    std::atomic<i64> bottom_;
+    std::atomic<Slot*> buffer_[Capacity];
+};
+
+//! Deque and storage of jobs queued by one worker.
+//! Slots are reused in a ring, job is run inline when its slot is still queued
+struct Worker
+{
+    Deque deque;
+    Slot slots[Deque::Capacity];
+    u32 nextJob;
+    u32 random;
+    std::thread thread;
+
+    Worker() : nextJob(0), random(0) {}
+};
+
+struct JobSystem
+{
+    std::vector<Worker*> workers;
+    std::atomic<u32> queued;
+    std::atomic<u32> sleeping;
+    std::atomic<bool> quit;
+    std::mutex lock;
+    std::condition_variable wakeup;
+
+    JobSystem() : queued(0), sleeping(0), quit(false) {}
+};
+
+JobSystem* system_ = nullptr;
+thread_local u32 workerIndex_ = kInvalidWorker;
+
+void finish(const Job& job, Counter* counter)
+{
+    job.function(job.data);
+    if (counter != nullptr)
+        counter->value.fetch_sub(1, std::memory_order_release);
+}
+
+void execute(Slot* slot)
+{
+    // owner reuses slot once it is free
+    Job job = slot->job;
+    Counter* counter = slot->counter;
+    slot->free.store(true, std::memory_order_release);
+    system_->queued.fetch_sub(1, std::memory_order_relaxed);
+    finish(job, counter);
+}
+
+Slot* findJob(u32 index)
+{
+    Worker* self = system_->workers[index];
+    Slot* job = self->deque.pop();
+    if (job != nullptr)
+        return job;
+    u32 count = static_cast<u32>(system_->workers.size());
+    if (count < 2)
+        return nullptr;
+    // xorshift, start stealing from a random victim
+    u32 r = self->random;
+    r ^= r << 13;
+    r ^= r >> 17;
+    r ^= r << 5;
+    self->random = r;
+    for (u32 i = 0; i < count; i++) {
+        u32 victim = (r + i) % count;
+        if (victim == index)
+            continue;
+        job = system_->workers[victim]->deque.steal();
+        if (job != nullptr)
+            return job;
+    }
+    return nullptr;
+}
+
+void workerLoop(u32 index)
+{
+    workerIndex_ = index;
+    u32 idle = 0;
+    for (;;) {
+        Slot* job = findJob(index);
+        if (job != nullptr) {
+            execute(job);
+            idle = 0;
+            continue;
+        }
+        if (system_->quit.load(std::memory_order_acquire))
+            break;
+        if (++idle < 64) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(system_->lock);
+        system_->sleeping.fetch_add(1, std::memory_order_seq_cst);
+        system_->wakeup.wait(guard, [] {
+            return system_->queued.load(std::memory_order_seq_cst) != 0
+                || system_->quit.load(std::memory_order_acquire);
+        });
+        system_->sleeping.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+    workerIndex_ = kInvalidWorker;
+}
+
+void runInline(const Job* jobs, u32 count)
+{
+    for (u32 i = 0; i < count; i++)
+        jobs[i].function(jobs[i].data);
+}
+
+} // namespace
+
+void init(u32 workers)
+{
+    ASSERT(system_ == nullptr);
+    if (workers == 0)
+        workers = std::thread::hardware_concurrency();
+    if (workers == 0)
+        workers = 1;
+    system_ = new JobSystem();
+    for (u32 i = 0; i < workers; i++) {
+        Worker* worker = new Worker();
+        worker->random = 2463534242u + i * 7919u;
+        system_->workers.push_back(worker);
+    }
+    workerIndex_ = 0;
+    for (u32 i = 1; i < workers; i++)
+        system_->workers[i]->thread = std::thread(workerLoop, i);
+}
+
+void shutdown()
+{
+    ASSERT(system_ != nullptr);
+    // finish jobs queued by main thread
+    while (Slot* job = findJob(0))
+        execute(job);
+    {
+        std::lock_guard<std::mutex> guard(system_->lock);
+        system_->quit.store(true, std::memory_order_release);
+    }
+    system_->wakeup.notify_all();
+    for (u32 i = 1; i < system_->workers.size(); i++)
+        system_->workers[i]->thread.join();
+    for (Worker* worker : system_->workers)
+        delete worker;
+    delete system_;
+    system_ = nullptr;
+    workerIndex_ = kInvalidWorker;
+}
+
+bool running()
+{
+    return system_ != nullptr;
+}
+
+u32 workerCount()
+{
+    return system_ != nullptr ? static_cast<u32>(system_->workers.size()) : 1;
+}
+
+u32 workerIndex()
+{
+    return workerIndex_ != kInvalidWorker ? workerIndex_ : 0;
+}
+
+void run(const Job* jobs, u32 count, Counter* counter)
+{
+    if (system_ == nullptr || workerIndex_ == kInvalidWorker) {
+        runInline(jobs, count);
+        return;
+    }
+    if (counter != nullptr)
+        counter->value.fetch_add(count, std::memory_order_relaxed);
+    Worker* self = system_->workers[workerIndex_];
+    for (u32 i = 0; i < count; i++) {
+        Slot* slot = &self->slots[self->nextJob++ & Deque::Mask];
+        // ring wrapped around a job which is still queued
+        if (!slot->free.load(std::memory_order_acquire)) {
+            finish(jobs[i], counter);
+            continue;
+        }
+        slot->free.store(false, std::memory_order_relaxed);
+        slot->job = jobs[i];
+        slot->counter = counter;
+        system_->queued.fetch_add(1, std::memory_order_seq_cst);
+        if (!self->deque.push(slot))
+            execute(slot);
+    }
+    if (system_->sleeping.load(std::memory_order_seq_cst) != 0) {
+        std::lock_guard<std::mutex> guard(system_->lock);
+        system_->wakeup.notify_all();
+    }
+}
+
+void wait(Counter* counter)
+{
+    if (system_ == nullptr || workerIndex_ == kInvalidWorker) {
+        while (counter->value.load(std::memory_order_acquire) != 0)
+            std::this_thread::yield();
+        return;
+    }
+    u32 index = workerIndex_;
+    while (counter->value.load(std::memory_order_acquire) != 0) {
+        Slot* job = findJob(index);
+        if (job != nullptr)
+            execute(job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+} // namespace jobs
+} // namespace base
@@ -0,0 +1,114 @@
+/**
+ * \file
+ * \brief       work-stealing job system
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "foundation/collection_types.h"
+#include "foundation/array.h"
+#include <atomic>
+
+namespace base {
+namespace jobs {
+
+typedef void (*JobFunction)(void* data);
+
+//! Count of unfinished jobs, wait() returns when it drops to zero.
+//! Counter must outlive its jobs
+struct Counter
+{
+    std::atomic<u32> value;
+    Counter() : value(0) {}
+};
+
+//! Job is a function with opaque data, data must outlive the job
+struct Job
+{
+    JobFunction function;
+    void* data;
+};
+
+//! Starts workers, 0 means one per core: the calling (main) thread
+//! is worker 0, so hardware_concurrency() - 1 threads are spawned
+NEGINE_API void init(u32 workers = 0);
+//! Waits for queued jobs and joins workers
+NEGINE_API void shutdown();
+NEGINE_API bool running();
+//! Returns count of workers including the main thread
+NEGINE_API u32 workerCount();
+//! Returns index of current worker, 0 for main thread and for threads
+//! not owned by job system
+NEGINE_API u32 workerIndex();
+
+//! Queues jobs to the deque of current worker, adds count to counter.
+//! Jobs are executed inline when job system is not running
+//! or the caller is not a worker
+NEGINE_API void run(const Job* jobs, u32 count, Counter* counter);
+inline void run(const Job& job, Counter* counter) {
+    run(&job, 1, counter);
+}
+
+//! Executes other jobs until counter drops to zero
+NEGINE_API void wait(Counter* counter);
+
+namespace detail {
+
+template<typename T, typename F>
+struct ParallelFor
+{
+    T* data;
+    u32 size;
+    u32 grain;
+    std::atomic<u32> next;
+    F* function;
+
+    //! Every job takes chunks until the range is exhausted
+    static void execute(void* p) {
+        ParallelFor* self = static_cast<ParallelFor*>(p);
+        for (;;) {
+            u32 begin = self->next.fetch_add(self->grain, std::memory_order_relaxed);
+            if (begin >= self->size)
+                break;
+            u32 end = begin + self->grain < self->size ? begin + self->grain : self->size;
+            (*self->function)(self->data + begin, self->data + end);
+        }
+    }
+};
+
+} // namespace detail
+
+//! Calls function(T* begin, T* end) for chunks of grain elements
+//! on all workers, returns when the whole array is processed
+template<typename T, typename F>
+void parallel_for(foundation::Array<T>& a, u32 grain, F function)
+{
+    u32 size = foundation::array::size(a);
+    if (size == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+    detail::ParallelFor<T, F> state;
+    state.data = foundation::array::begin(a);
+    state.size = size;
+    state.grain = grain;
+    state.next.store(0, std::memory_order_relaxed);
+    state.function = &function;
+
+    u32 chunks = (size + grain - 1) / grain;
+    u32 count = workerCount();
+    if (count > chunks)
+        count = chunks;
+    // the caller processes chunks too, then helps with other jobs
+    Job job = { &detail::ParallelFor<T, F>::execute, &state };
+    Counter counter;
+    for (u32 i = 1; i < count; i++)
+        run(job, &counter);
+    detail::ParallelFor<T, F>::execute(&state);
+    wait(&counter);
+}
+
+} // namespace jobs
+} // namespace base
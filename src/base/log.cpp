@@ -2,7 +2,14 @@
 #include "base/env.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <ctype.h>
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
 
 #ifdef OS_WIN
 #include <windows.h>
@@ -12,46 +19,354 @@
 namespace base {
 
 #define LOG_BUFFER_SIZE 1024
-char logBuffer_[LOG_BUFFER_SIZE];
+
+Log::Level logLevel_ = Log::LEVEL_INFO;
+std::atomic<bool> logAsync_(false);
+
+//! Single producer (owner thread), single consumer (log thread) ring.
+//! Rings live until process exit, ring of finished thread is taken by next new thread
+struct LogRing
+{
+    static const u32 Capacity = 256;
+    static const u32 Mask = Capacity - 1;
+
+    LogRecord records[Capacity];
+    std::atomic<u32> head;
+    std::atomic<u32> tail;
+    bool owned;
+
+    LogRing() : head(0), tail(0), owned(true) {}
+};
 
 struct LogWrapper
 {
     std::vector<Log*> loggers_;
-    Log::Level level_;
+    std::mutex loggersLock_;
+
+    std::vector<LogRing*> rings_;
+    std::mutex ringsLock_;
+    std::vector<LogRing*> drainRings_;
+    std::mutex drainLock_;
+    std::thread thread_;
+    std::mutex wakeLock_;
+    std::condition_variable wake_;
+    std::atomic<bool> running_;
+
     LogWrapper()
+        : running_(false)
     {
-        level_ = Log::LEVEL_INFO;
         openLog(new ConsoleLog());
     }
     ~LogWrapper()
     {
+        stopAsyncLog();
         size_t len = loggers_.size();
         for (size_t i=0; i<len; i++)
             delete loggers_[i];
     }
+
+    void write(Log::Level level, const char* message)
+    {
+        std::lock_guard<std::mutex> guard(loggersLock_);
+        size_t len = loggers_.size();
+        for (size_t i=0; i<len; i++)
+             loggers_[i]->write(level, message);
+    }
+
+    //! Writes pending records of all threads, returns count of them.
+    //! Sinks are called without ringsLock_, threads logging first time do not wait for them
+    u32 drain()
+    {
+        char buffer[LOG_BUFFER_SIZE];
+        u32 count = 0;
+        std::lock_guard<std::mutex> consumer(drainLock_);
+        {
+            std::lock_guard<std::mutex> guard(ringsLock_);
+            drainRings_.assign(rings_.begin(), rings_.end());
+        }
+        for (LogRing* ring : drainRings_) {
+            u32 tail = ring->tail.load(std::memory_order_relaxed);
+            u32 head = ring->head.load();
+            for (; tail != head; ++tail, ++count) {
+                const LogRecord& record = ring->records[tail & LogRing::Mask];
+                formatLogRecord(record, buffer, LOG_BUFFER_SIZE);
+                write(static_cast<Log::Level>(record.level), buffer);
+                ring->tail.store(tail + 1, std::memory_order_release);
+            }
+        }
+        return count;
+    }
+
+    void run()
+    {
+        while (running_.load(std::memory_order_acquire)) {
+            if (drain() == 0) {
+                std::unique_lock<std::mutex> lock(wakeLock_);
+                wake_.wait_for(lock, std::chrono::milliseconds(2));
+            }
+        }
+        drain();
+    }
 } logWrapper;
 
+//! Releases ring of thread on its exit
+struct LogRingOwner
+{
+    LogRing* ring;
+
+    LogRingOwner() : ring(nullptr) {}
+    ~LogRingOwner()
+    {
+        if (ring == nullptr)
+            return;
+        std::lock_guard<std::mutex> guard(logWrapper.ringsLock_);
+        ring->owned = false;
+    }
+};
+
+static thread_local LogRingOwner ringOwner_;
+
 void openLog(Log* logger)
 {
+    std::lock_guard<std::mutex> guard(logWrapper.loggersLock_);
     logWrapper.loggers_.push_back(logger);
 }
 
+void closeLog(Log* logger)
+{
+    std::lock_guard<std::mutex> guard(logWrapper.loggersLock_);
+    auto& loggers = logWrapper.loggers_;
+    auto it = std::find(loggers.begin(), loggers.end(), logger);
+    if (it != loggers.end()) {
+        loggers.erase(it);
+        delete logger;
+    }
+}
+
 void writeLog(Log::Level level, const char* fmt, ...)
 {
+    if (level < logLevel_)
+        return;
+    char buffer[LOG_BUFFER_SIZE];
     va_list args;
     va_start(args, fmt);
-    if (level < logWrapper.level_)
-        return;
-    vsnprintf(logBuffer_, LOG_BUFFER_SIZE, fmt, args);
-    size_t len = logWrapper.loggers_.size();
-    for (size_t i=0; i<len; i++)
-         logWrapper.loggers_[i]->write(level, logBuffer_);
+    vsnprintf(buffer, LOG_BUFFER_SIZE, fmt, args);
     va_end(args);
+    // records this thread captured before log thread was stopped go first
+    LogRing* ring = ringOwner_.ring;
+    if (ring != nullptr && ring->tail.load(std::memory_order_acquire) != ring->head.load(std::memory_order_relaxed))
+        logWrapper.drain();
+    logWrapper.write(level, buffer);
 }
 
 void setLogLevel(Log::Level level)
 {
-    logWrapper.level_ = level;
+    logLevel_ = level;
+}
+
+void startAsyncLog()
+{
+    if (logWrapper.running_.load())
+        return;
+    logWrapper.running_ = true;
+    logWrapper.thread_ = std::thread([]() { logWrapper.run(); });
+    logAsync_ = true;
+}
+
+void stopAsyncLog()
+{
+    if (!logWrapper.running_.load())
+        return;
+    logAsync_ = false;
+    logWrapper.running_ = false;
+    logWrapper.wake_.notify_one();
+    logWrapper.thread_.join();
+    // rings are kept: other threads may still be writing records they began before
+    // logAsync_ was cleared, commitLogRecord writes such records itself
+}
+
+void flushLog()
+{
+    if (!logWrapper.running_.load())
+        return;
+    std::vector<std::pair<LogRing*, u32>> targets;
+    {
+        std::lock_guard<std::mutex> guard(logWrapper.ringsLock_);
+        for (LogRing* ring : logWrapper.rings_)
+            targets.push_back(std::make_pair(ring, ring->head.load(std::memory_order_acquire)));
+    }
+    logWrapper.wake_.notify_one();
+    for (auto& target : targets) {
+        while ((i32)(target.first->tail.load(std::memory_order_acquire) - target.second) < 0)
+            std::this_thread::yield();
+    }
+}
+
+static LogRing* threadRing()
+{
+    if (ringOwner_.ring != nullptr)
+        return ringOwner_.ring;
+    std::lock_guard<std::mutex> guard(logWrapper.ringsLock_);
+    for (LogRing* ring : logWrapper.rings_) {
+        if (!ring->owned) {
+            // records left by previous owner are still drained in order
+            ring->owned = true;
+            ringOwner_.ring = ring;
+            return ring;
+        }
+    }
+    ringOwner_.ring = new LogRing;
+    logWrapper.rings_.push_back(ringOwner_.ring);
+    return ringOwner_.ring;
+}
+
+LogRecord* beginLogRecord(Log::Level level, const char* fmt)
+{
+    LogRing* ring = threadRing();
+    u32 head = ring->head.load(std::memory_order_relaxed);
+    // do not lose messages: wait for the log thread when ring is full
+    while (head - ring->tail.load(std::memory_order_acquire) >= LogRing::Capacity) {
+        if (!logWrapper.running_.load(std::memory_order_acquire)) {
+            logWrapper.drain();
+            continue;
+        }
+        logWrapper.wake_.notify_one();
+        std::this_thread::yield();
+    }
+    LogRecord* record = &ring->records[head & LogRing::Mask];
+    record->fmt = fmt;
+    record->level = static_cast<u8>(level);
+    record->count = 0;
+    record->textUsed = 0;
+    record->text[LogRecord::TextSize - 1] = '\0';
+    return record;
+}
+
+void commitLogRecord(LogRecord* record)
+{
+    LogRing* ring = threadRing();
+    // sequentially consistent with stopAsyncLog: either final drain of log thread
+    // sees the record or this thread sees that log thread was stopped
+    ring->head.store(ring->head.load(std::memory_order_relaxed) + 1);
+    if (!logWrapper.running_.load())
+        logWrapper.drain();
+    // errors usually precede a crash, do not keep them in the ring
+    else if (record->level == Log::LEVEL_ERROR)
+        flushLog();
+}
+
+static i64 argInt(const LogRecord& r, u32 idx)
+{
+    if (idx >= r.count)
+        return 0;
+    const LogRecord::Arg& arg = r.args[idx];
+    switch (r.types[idx]) {
+        case LogRecord::ARG_INT: return arg.i;
+        case LogRecord::ARG_UINT: return static_cast<i64>(arg.u);
+        case LogRecord::ARG_FLOAT: return static_cast<i64>(arg.f);
+        case LogRecord::ARG_POINTER: return static_cast<i64>(reinterpret_cast<uptr>(arg.p));
+        default: return 0;
+    }
+}
+
+static f64 argFloat(const LogRecord& r, u32 idx)
+{
+    if (idx < r.count && r.types[idx] == LogRecord::ARG_FLOAT)
+        return r.args[idx].f;
+    return static_cast<f64>(argInt(r, idx));
+}
+
+static const char* argString(const LogRecord& r, u32 idx)
+{
+    if (idx < r.count && r.types[idx] == LogRecord::ARG_STRING)
+        return r.text + r.args[idx].text;
+    return "(?)";
+}
+
+void formatLogRecord(const LogRecord& r, char* buffer, u32 size)
+{
+    char* out = buffer;
+    char* end = buffer + size - 1;
+    const char* f = r.fmt;
+    u32 idx = 0;
+    while (*f != '\0' && out < end) {
+        if (*f != '%') {
+            *out++ = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            *out++ = '%';
+            f += 2;
+            continue;
+        }
+        // rebuild conversion spec, length modifier comes from captured type
+        char spec[48];
+        u32 n = 0;
+        spec[n++] = *f++;
+        while (*f != '\0' && strchr("-+ #0", *f) != nullptr) {
+            if (n < 8)
+                spec[n++] = *f;
+            f++;
+        }
+        for (u32 part = 0; part < 2; part++) {
+            if (part == 1) {
+                if (*f != '.')
+                    break;
+                spec[n++] = *f++;
+            }
+            if (*f == '*') {
+                n += snprintf(spec + n, 12, "%d", static_cast<i32>(argInt(r, idx++)));
+                f++;
+            } else {
+                while (isdigit(*f)) {
+                    if (n < 30)
+                        spec[n++] = *f;
+                    f++;
+                }
+            }
+        }
+        while (*f != '\0' && strchr("hljztLq", *f) != nullptr)
+            f++;
+        char conv = *f;
+        if (conv == '\0')
+            break;
+        f++;
+
+        int written = 0;
+        size_t left = end - out + 1;
+        switch (conv) {
+        case 'd': case 'i':
+            spec[n++] = 'l'; spec[n++] = 'l'; spec[n++] = conv; spec[n] = '\0';
+            written = snprintf(out, left, spec, static_cast<long long>(argInt(r, idx++)));
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            spec[n++] = 'l'; spec[n++] = 'l'; spec[n++] = conv; spec[n] = '\0';
+            written = snprintf(out, left, spec, static_cast<unsigned long long>(argInt(r, idx++)));
+            break;
+        case 'c':
+            spec[n++] = conv; spec[n] = '\0';
+            written = snprintf(out, left, spec, static_cast<int>(argInt(r, idx++)));
+            break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            spec[n++] = conv; spec[n] = '\0';
+            written = snprintf(out, left, spec, argFloat(r, idx++));
+            break;
+        case 's':
+            spec[n++] = conv; spec[n] = '\0';
+            written = snprintf(out, left, spec, argString(r, idx++));
+            break;
+        case 'p':
+            spec[n++] = conv; spec[n] = '\0';
+            written = snprintf(out, left, spec, reinterpret_cast<void*>(static_cast<uptr>(argInt(r, idx++))));
+            break;
+        default:
+            *out++ = conv;
+            break;
+        }
+        if (written > 0)
+            out += std::min(static_cast<size_t>(written), static_cast<size_t>(end - out));
+    }
+    *out = '\0';
 }
 
 ConsoleLog::ConsoleLog()
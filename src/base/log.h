@@ -1,6 +1,9 @@
 #pragma once
 
 #include "base/types.h"
+#include <string.h>
+#include <type_traits>
+#include <atomic>
 
 namespace base
 {
@@ -15,11 +18,132 @@ public:
     virtual void write(Level l, const char* message) = 0;
 };
 
+//! Adds log sink, takes ownership
 NEGINE_API void openLog(Log* log);
+//! Removes log sink and deletes it
+NEGINE_API void closeLog(Log* log);
+//! Formats message immediately and writes it to all sinks
 NEGINE_API void writeLog(Log::Level level, const char* fmt, ...);
 NEGINE_API void setLogLevel(Log::Level level);
 
-#define LOG_LEVEL(level, fmt, ...) ::base::writeLog(level, fmt, ##__VA_ARGS__)
+//! Starts background thread, LOG/WARN/ERR only capture arguments after that.
+//! Format must be a string literal, it is kept by pointer until formatted
+NEGINE_API void startAsyncLog();
+//! Writes pending messages and stops background thread
+NEGINE_API void stopAsyncLog();
+//! Blocks until all messages captured so far are written
+NEGINE_API void flushLog();
+
+NEGINE_API extern Log::Level logLevel_;
+NEGINE_API extern std::atomic<bool> logAsync_;
+
+//! Deferred log message: format pointer and a copy of arguments
+//! (strings are copied into text), formatted by the log thread
+struct LogRecord
+{
+    enum ArgType {
+        ARG_INT, ARG_UINT, ARG_FLOAT, ARG_STRING, ARG_POINTER
+    };
+    static const u32 MaxArgs = 16;
+    static const u32 TextSize = 320;
+
+    const char* fmt;
+    u8 level;
+    u8 count;
+    u16 textUsed;
+    u8 types[MaxArgs];
+    union Arg {
+        i64 i;
+        u64 u;
+        f64 f;
+        const void* p;
+        u32 text;
+    } args[MaxArgs];
+    char text[TextSize];
+
+    void add(ArgType type, Arg arg) {
+        if (count < MaxArgs) {
+            types[count] = static_cast<u8>(type);
+            args[count++] = arg;
+        }
+    }
+    //! Copies string into text, truncates it when text is full
+    void addString(const char* s) {
+        Arg arg;
+        if (s == nullptr)
+            s = "(null)";
+        // last byte is kept zero for strings which do not fit
+        u32 left = TextSize - 1 - textUsed;
+        if (left == 0) {
+            arg.text = TextSize - 1;
+        } else {
+            u32 len = static_cast<u32>(strlen(s));
+            if (len > left - 1)
+                len = left - 1;
+            arg.text = textUsed;
+            memcpy(text + textUsed, s, len);
+            text[textUsed + len] = '\0';
+            textUsed = static_cast<u16>(textUsed + len + 1);
+        }
+        add(ARG_STRING, arg);
+    }
+};
+
+inline void logArg(LogRecord* r, const char* s) { r->addString(s); }
+inline void logArg(LogRecord* r, const u8* s) { r->addString(reinterpret_cast<const char*>(s)); }
+inline void logArg(LogRecord* r, f64 v) {
+    LogRecord::Arg arg; arg.f = v;
+    r->add(LogRecord::ARG_FLOAT, arg);
+}
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+logArg(LogRecord* r, T v) {
+    LogRecord::Arg arg;
+    if (std::is_signed<T>::value) {
+        arg.i = static_cast<i64>(v);
+        r->add(LogRecord::ARG_INT, arg);
+    } else {
+        arg.u = static_cast<u64>(v);
+        r->add(LogRecord::ARG_UINT, arg);
+    }
+}
+template<typename T>
+inline void logArg(LogRecord* r, const T* p) {
+    LogRecord::Arg arg; arg.p = p;
+    r->add(LogRecord::ARG_POINTER, arg);
+}
+
+inline void logArgs(LogRecord*) {}
+template<typename T, typename... Args>
+inline void logArgs(LogRecord* r, const T& v, const Args&... args) {
+    logArg(r, v);
+    logArgs(r, args...);
+}
+
+//! Reserves record in ring of current thread (blocks while it is full)
+NEGINE_API LogRecord* beginLogRecord(Log::Level level, const char* fmt);
+//! Publishes record to the log thread
+NEGINE_API void commitLogRecord(LogRecord* record);
+//! Formats deferred record into buffer
+NEGINE_API void formatLogRecord(const LogRecord& record, char* buffer, u32 size);
+
+template<typename... Args>
+void writeLogDeferred(Log::Level level, const char* fmt, const Args&... args)
+{
+    if (logAsync_.load(std::memory_order_relaxed)) {
+        LogRecord* record = beginLogRecord(level, fmt);
+        logArgs(record, args...);
+        commitLogRecord(record);
+    } else {
+        writeLog(level, fmt, args...);
+    }
+}
+
+#define LOG_LEVEL(level, fmt, ...) \
+    do { \
+        if ((level) >= ::base::logLevel_) \
+            ::base::writeLogDeferred(level, fmt, ##__VA_ARGS__); \
+    } while (0)
 #define LOG(fmt, ...)     LOG_LEVEL(::base::Log::LEVEL_INFO, fmt, ##__VA_ARGS__)
 #define WARN(fmt, ...)    LOG_LEVEL(::base::Log::LEVEL_WARNING, fmt, ##__VA_ARGS__)
 #define ERR(fmt, ...)     LOG_LEVEL(::base::Log::LEVEL_ERROR, fmt, ##__VA_ARGS__)
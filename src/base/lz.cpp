@@ -0,0 +1,171 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "base/lz.h"
+#include <string.h>
+#include <vector>
+
+namespace base {
+namespace lz {
+
+namespace {
+
+const u32 kMinMatch = 4;
+const u32 kLastLiterals = 5;    //!< block always ends with literals
+const u32 kMatchSearchLimit = 12;
+const u32 kMaxOffset = 65535;
+const u32 kHashBits = 12;
+
+inline u32 read32(const u8* p) {
+    u32 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline u32 hash(u32 sequence) {
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+class Writer
+{
+public:
+    Writer(u8* dest, u32 capacity) : p_(dest), end_(dest + capacity), overflow_(false) {}
+
+    void byte(u8 value) {
+        if (p_ == end_) {
+            overflow_ = true;
+            return;
+        }
+        *p_++ = value;
+    }
+
+    //! Length above 15 continues in bytes of 255
+    void length(u32 value) {
+        for (; value >= 255; value -= 255)
+            byte(255);
+        byte(static_cast<u8>(value));
+    }
+
+    void bytes(const u8* source, u32 size) {
+        if (static_cast<u32>(end_ - p_) < size) {
+            overflow_ = true;
+            return;
+        }
+        memcpy(p_, source, size);
+        p_ += size;
+    }
+
+    void sequence(const u8* literals, u32 literalCount, u32 offset, u32 matchLength) {
+        u32 matchCode = matchLength != 0 ? matchLength - kMinMatch : 0;
+        u8 token = static_cast<u8>(((literalCount < 15 ? literalCount : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+        byte(token);
+        if (literalCount >= 15)
+            length(literalCount - 15);
+        bytes(literals, literalCount);
+        if (matchLength == 0)
+            return;
+        byte(static_cast<u8>(offset));
+        byte(static_cast<u8>(offset >> 8));
+        if (matchCode >= 15)
+            length(matchCode - 15);
+    }
+
+    bool overflow() const { return overflow_; }
+    u8* position() const { return p_; }
+
+private:
+    u8* p_;
+    u8* end_;
+    bool overflow_;
+};
+
+//! Reads length continuation bytes
+inline bool readLength(const u8*& p, const u8* end, u32& value) {
+    u8 b;
+    do {
+        if (p == end)
+            return false;
+        b = *p++;
+        value += b;
+    } while (b == 255);
+    return true;
+}
+
+} // namespace
+
+u32 compress(const u8* source, u32 size, u8* dest, u32 capacity)
+{
+    Writer out(dest, capacity);
+    u32 anchor = 0;
+    if (size > kMatchSearchLimit) {
+        std::vector<u32> table(1 << kHashBits, u32(-1));
+        u32 limit = size - kMatchSearchLimit;
+        u32 matchLimit = size - kLastLiterals;
+        u32 ip = 0;
+        while (ip < limit) {
+            u32 sequence = read32(source + ip);
+            u32 h = hash(sequence);
+            u32 ref = table[h];
+            table[h] = ip;
+            if (ref == u32(-1) || ip - ref > kMaxOffset || read32(source + ref) != sequence) {
+                ip++;
+                continue;
+            }
+            u32 length = kMinMatch;
+            while (ip + length < matchLimit && source[ref + length] == source[ip + length])
+                length++;
+            out.sequence(source + anchor, ip - anchor, ip - ref, length);
+            if (out.overflow())
+                return 0;
+            ip += length;
+            anchor = ip;
+        }
+    }
+    out.sequence(source + anchor, size - anchor, 0, 0);
+    if (out.overflow())
+        return 0;
+    return static_cast<u32>(out.position() - dest);
+}
+
+bool decompress(const u8* source, u32 size, u8* dest, u32 destSize)
+{
+    const u8* ip = source;
+    const u8* end = source + size;
+    u8* op = dest;
+    u8* opEnd = dest + destSize;
+    while (ip < end) {
+        u8 token = *ip++;
+        u32 literals = token >> 4;
+        if (literals == 15 && !readLength(ip, end, literals))
+            return false;
+        if (static_cast<u32>(end - ip) < literals || static_cast<u32>(opEnd - op) < literals)
+            return false;
+        memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == end)
+            break;
+
+        if (end - ip < 2)
+            return false;
+        u32 offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        u32 length = (token & 15);
+        if (length == 15 && !readLength(ip, end, length))
+            return false;
+        length += kMinMatch;
+        if (offset == 0 || offset > static_cast<u32>(op - dest) || static_cast<u32>(opEnd - op) < length)
+            return false;
+        // source and destination overlap for repeating patterns
+        const u8* match = op - offset;
+        for (u32 i = 0; i < length; i++)
+            op[i] = match[i];
+        op += length;
+    }
+    return op == opEnd;
+}
+
+} // namespace lz
+} // namespace base
@@ -0,0 +1,26 @@
+/**
+ * \file
+ * \brief       fast LZ77 block compression (LZ4 block layout)
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+
+namespace base {
+namespace lz {
+
+//! Returns maximal compressed size of size bytes
+inline u32 compressBound(u32 size) {
+    return size + size / 255 + 16;
+}
+
+//! Compresses block, returns compressed size or 0 when it does not fit into capacity
+NEGINE_API u32 compress(const u8* source, u32 size, u8* dest, u32 capacity);
+
+//! Decompresses block of known original size, returns false on corrupted input
+NEGINE_API bool decompress(const u8* source, u32 size, u8* dest, u32 destSize);
+
+} // namespace lz
+} // namespace base
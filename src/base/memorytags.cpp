@@ -0,0 +1,231 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "base/memorytags.h"
+#include "base/profiler.h"
+#include "base/debug.h"
+#include "base/log.h"
+#include <new>
+#include <stdlib.h>
+#include <string>
+
+namespace base {
+
+TaggedAllocator::TaggedAllocator(MemoryTag tag, foundation::Allocator& backing)
+    : tag_(tag)
+    , backing_(backing)
+    , live_(0)
+    , peak_(0)
+    , count_(0)
+    , frameAllocations_(0)
+    , frameBytes_(0)
+    , lastFrameAllocations_(0)
+    , lastFrameBytes_(0)
+{
+}
+
+TaggedAllocator::~TaggedAllocator()
+{
+}
+
+void* TaggedAllocator::allocate(u32 size, u32 align)
+{
+    void* p = backing_.allocate(size, align);
+    if (p == nullptr)
+        return nullptr;
+    u64 bytes = backing_.allocated_size(p);
+    u64 live = live_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    u64 peak = peak_.load(std::memory_order_relaxed);
+    while (live > peak && !peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    count_.fetch_add(1, std::memory_order_relaxed);
+    frameAllocations_.fetch_add(1, std::memory_order_relaxed);
+    frameBytes_.fetch_add(bytes, std::memory_order_relaxed);
+    return p;
+}
+
+void TaggedAllocator::deallocate(void* p)
+{
+    if (p == nullptr)
+        return;
+    live_.fetch_sub(backing_.allocated_size(p), std::memory_order_relaxed);
+    count_.fetch_sub(1, std::memory_order_relaxed);
+    backing_.deallocate(p);
+}
+
+MemoryStats TaggedAllocator::stats() const
+{
+    MemoryStats s;
+    s.live = live_.load(std::memory_order_relaxed);
+    s.peak = peak_.load(std::memory_order_relaxed);
+    s.count = count_.load(std::memory_order_relaxed);
+    s.frameAllocations = lastFrameAllocations_;
+    s.frameBytes = lastFrameBytes_;
+    return s;
+}
+
+void TaggedAllocator::endFrame()
+{
+    lastFrameAllocations_ = frameAllocations_.exchange(0, std::memory_order_relaxed);
+    lastFrameBytes_ = frameBytes_.exchange(0, std::memory_order_relaxed);
+}
+
+namespace memory {
+
+namespace {
+
+const u32 kTagCount = static_cast<u32>(MemoryTag::Count);
+
+const char* const kTagNames[kTagCount] = {
+    "render", "physics", "scene", "resources", "scripting", "scratch"
+};
+
+//! Tags whose allocations may be freed after shutdown
+bool outlivesShutdown(MemoryTag tag)
+{
+    return tag == MemoryTag::Physics || tag == MemoryTag::Scripting;
+}
+
+//! malloc with size header, unlike foundation MallocAllocator it does not
+//! require everything to be freed before shutdown: Bullet objects
+//! created by scripts and the interpreter itself could outlive the engine
+class HeapAllocator : public foundation::Allocator
+{
+    struct Header
+    {
+        u32 size;
+        u32 offset;
+    };
+public:
+    void* allocate(u32 size, u32 align) {
+        if (align < sizeof(Header))
+            align = sizeof(Header);
+        u8* raw = static_cast<u8*>(malloc(size + align + sizeof(Header)));
+        if (raw == nullptr)
+            return nullptr;
+        u8* p = static_cast<u8*>(foundation::memory::align_forward(raw + sizeof(Header), align));
+        Header* h = reinterpret_cast<Header*>(p) - 1;
+        h->size = size;
+        h->offset = static_cast<u32>(p - raw);
+        return p;
+    }
+    void deallocate(void* p) {
+        if (p == nullptr)
+            return;
+        Header* h = static_cast<Header*>(p) - 1;
+        free(static_cast<u8*>(p) - h->offset);
+    }
+    u32 allocated_size(void* p) {
+        return (static_cast<Header*>(p) - 1)->size;
+    }
+    u32 total_allocated() {
+        return SIZE_NOT_TRACKED;
+    }
+};
+
+struct MemoryTags
+{
+    static const u32 Size = sizeof(TaggedAllocator) * kTagCount;
+    //! allocators are placed into static buffer, like foundation globals,
+    //! heap, Physics and Scripting allocators are never destroyed
+    alignas(TaggedAllocator) char buffer[Size];
+    alignas(HeapAllocator) char heapBuffer[sizeof(HeapAllocator)];
+    TaggedAllocator* allocators[kTagCount];
+    HeapAllocator* heap;
+    u32 counters[kTagCount][3];
+};
+
+MemoryTags tags_;
+bool initialized_ = false;
+
+} // namespace
+
+void init(u32 scratchSize)
+{
+    ASSERT(!initialized_);
+    foundation::memory_globals::init(scratchSize);
+    if (tags_.heap == nullptr)
+        tags_.heap = new (tags_.heapBuffer) HeapAllocator();
+    for (u32 i = 0; i < kTagCount; i++) {
+        MemoryTag tag = static_cast<MemoryTag>(i);
+        foundation::Allocator& backing = outlivesShutdown(tag)
+            ? static_cast<foundation::Allocator&>(*tags_.heap)
+            : foundation::memory_globals::default_allocator();
+        void* p = tags_.buffer + i * sizeof(TaggedAllocator);
+        if (tags_.allocators[i] == nullptr)
+            tags_.allocators[i] = new (p) TaggedAllocator(tag, backing);
+        std::string name = std::string("mem.") + kTagNames[i];
+        tags_.counters[i][0] = Profiler::intern((name + ".live_kb").c_str());
+        tags_.counters[i][1] = Profiler::intern((name + ".peak_kb").c_str());
+        tags_.counters[i][2] = Profiler::intern((name + ".allocs").c_str());
+    }
+    initialized_ = true;
+}
+
+void shutdown()
+{
+    ASSERT(initialized_);
+    for (u32 i = 0; i < kTagCount; i++) {
+        if (outlivesShutdown(static_cast<MemoryTag>(i)))
+            continue;
+        MemoryStats s = tags_.allocators[i]->stats();
+        if (s.count != 0)
+            WARN("memory: %u allocations (%llu bytes) of '%s' are not freed",
+                s.count, static_cast<unsigned long long>(s.live), kTagNames[i]);
+        tags_.allocators[i]->~TaggedAllocator();
+        tags_.allocators[i] = nullptr;
+    }
+    foundation::memory_globals::shutdown();
+    initialized_ = false;
+}
+
+foundation::Allocator& allocator(MemoryTag tag)
+{
+    ASSERT(initialized_ || (outlivesShutdown(tag) && tags_.allocators[static_cast<u32>(tag)] != nullptr));
+    return *tags_.allocators[static_cast<u32>(tag)];
+}
+
+MemoryStats stats(MemoryTag tag)
+{
+    ASSERT(initialized_);
+    return tags_.allocators[static_cast<u32>(tag)]->stats();
+}
+
+const char* tagName(MemoryTag tag)
+{
+    u32 index = static_cast<u32>(tag);
+    return index < kTagCount ? kTagNames[index] : "unknown";
+}
+
+void endFrame()
+{
+    if (!initialized_)
+        return;
+    bool profile = Profiler::enabled();
+    for (u32 i = 0; i < kTagCount; i++) {
+        TaggedAllocator* a = tags_.allocators[i];
+        a->endFrame();
+        if (!profile)
+            continue;
+        MemoryStats s = a->stats();
+        Profiler::counter(tags_.counters[i][0]) = s.live / 1024.0f;
+        Profiler::counter(tags_.counters[i][1]) = s.peak / 1024.0f;
+        Profiler::counter(tags_.counters[i][2]) = static_cast<f32>(s.frameAllocations);
+    }
+}
+
+void report(std::ostream* out)
+{
+    *out << "tag,live,peak,count,frame_allocs,frame_bytes\n";
+    for (u32 i = 0; i < kTagCount; i++) {
+        MemoryStats s = stats(static_cast<MemoryTag>(i));
+        *out << kTagNames[i] << "," << s.live << "," << s.peak << "," << s.count
+             << "," << s.frameAllocations << "," << s.frameBytes << "\n";
+    }
+    out->flush();
+}
+
+} // namespace memory
+} // namespace base
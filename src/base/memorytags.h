@@ -0,0 +1,115 @@
+/**
+ * \file
+ * \brief       per-subsystem allocation tracking
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "foundation/memory.h"
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+
+namespace base {
+
+enum class MemoryTag : u8 {
+    Render,
+    Physics,    //!< Bullet allocations, backed by its own heap, lives until process exit
+    Scene,
+    Resources,
+    Scripting,  //!< Python interpreter and bindings, heap backed like Physics
+    Scratch,    //!< transient memory: frame arenas, temporary buffers
+    Count
+};
+
+struct MemoryStats
+{
+    u64 live;               //!< bytes allocated now
+    u64 peak;               //!< maximal live bytes
+    u32 count;              //!< allocations alive now
+    u32 frameAllocations;   //!< allocations made during the last frame
+    u64 frameBytes;         //!< bytes allocated during the last frame
+};
+
+//! Proxy allocator which counts allocations of one subsystem.
+//! Backing allocator has to track sizes (allocated_size)
+class TaggedAllocator : public foundation::Allocator
+{
+public:
+    NEGINE_API TaggedAllocator(MemoryTag tag, foundation::Allocator& backing);
+    NEGINE_API ~TaggedAllocator();
+
+    NEGINE_API void* allocate(u32 size, u32 align = DEFAULT_ALIGN);
+    NEGINE_API void deallocate(void* p);
+    u32 allocated_size(void* p) { return backing_.allocated_size(p); }
+    u32 total_allocated() { return static_cast<u32>(live_.load(std::memory_order_relaxed)); }
+
+    MemoryTag tag() const { return tag_; }
+    NEGINE_API MemoryStats stats() const;
+    //! Finishes per-frame counters
+    NEGINE_API void endFrame();
+
+private:
+    MemoryTag tag_;
+    foundation::Allocator& backing_;
+    std::atomic<u64> live_;
+    std::atomic<u64> peak_;
+    std::atomic<u32> count_;
+    std::atomic<u32> frameAllocations_;
+    std::atomic<u64> frameBytes_;
+    u32 lastFrameAllocations_;
+    u64 lastFrameBytes_;
+
+    DISALLOW_COPY_AND_ASSIGN(TaggedAllocator);
+};
+
+namespace memory {
+
+//! Initializes foundation memory globals and tagged allocators on top of them
+NEGINE_API void init(u32 scratchSize = 4 * 1024 * 1024);
+//! Destroys tagged allocators except Physics and Scripting: Bullet and Python
+//! objects may be freed after shutdown, so their allocators are kept and
+//! reused by next init
+NEGINE_API void shutdown();
+
+NEGINE_API foundation::Allocator& allocator(MemoryTag tag);
+NEGINE_API MemoryStats stats(MemoryTag tag);
+NEGINE_API const char* tagName(MemoryTag tag);
+
+//! Finishes per-frame counters of all tags and puts live kilobytes,
+//! peak kilobytes and allocations per frame into profiler counters
+//! ("mem.<tag>.live_kb", "mem.<tag>.peak_kb", "mem.<tag>.allocs")
+NEGINE_API void endFrame();
+
+//! Writes table of all tags
+NEGINE_API void report(std::ostream* out);
+
+} // namespace memory
+
+//! Standard container allocator for a tag
+template<typename T, MemoryTag Tag>
+struct TagAllocator
+{
+    typedef T value_type;
+    template<typename U> struct rebind { typedef TagAllocator<U, Tag> other; };
+
+    TagAllocator() {}
+    template<typename U>
+    TagAllocator(const TagAllocator<U, Tag>&) {}
+
+    T* allocate(size_t n) {
+        u32 align = alignof(T) < 4 ? 4 : static_cast<u32>(alignof(T));
+        return static_cast<T*>(memory::allocator(Tag).allocate(static_cast<u32>(n * sizeof(T)), align));
+    }
+    void deallocate(T* p, size_t) {
+        memory::allocator(Tag).deallocate(p);
+    }
+    template<typename U>
+    bool operator==(const TagAllocator<U, Tag>&) const { return true; }
+    template<typename U>
+    bool operator!=(const TagAllocator<U, Tag>&) const { return false; }
+};
+
+} // namespace base
@@ -0,0 +1,161 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "base/pack.h"
+#include "base/lz.h"
+#include "base/path.h"
+#include "base/stringid.h"
+#include "base/log.h"
+#include <algorithm>
+#include <stdio.h>
+
+namespace base {
+
+const u32 PackHeader::Magic;
+const u32 PackHeader::Version;
+
+PackFile::PackFile(const std::string& filename)
+    : file_(filename, MappedFile::Access::Random)
+    , header_(nullptr)
+    , toc_(nullptr)
+    , names_(nullptr)
+{
+    const PackHeader* header = reinterpret_cast<const PackHeader*>(file_.view(0, sizeof(PackHeader)));
+    if (header == nullptr)
+        return;
+    if (header->magic != PackHeader::Magic || header->version != PackHeader::Version) {
+        ERR("pack: %s is not a pack of version %u", filename.c_str(), PackHeader::Version);
+        return;
+    }
+    const u8* toc = file_.view(sizeof(PackHeader), static_cast<u64>(header->count) * sizeof(PackEntry));
+    const u8* names = file_.view(header->namesOffset, header->namesSize);
+    if (toc == nullptr || names == nullptr) {
+        ERR("pack: %s is truncated", filename.c_str());
+        return;
+    }
+    header_ = header;
+    toc_ = reinterpret_cast<const PackEntry*>(toc);
+    names_ = reinterpret_cast<const char*>(names);
+    // every lookup touches table of contents and names, prefetch them
+    file_.advise(MappedFile::Access::WillNeed, 0, header->namesOffset + header->namesSize);
+}
+
+std::string PackFile::normalize(const std::string& path)
+{
+    std::string ret = path::normpath(path);
+    size_t start = 0;
+    while (ret.compare(start, 2, "./") == 0)
+        start += 2;
+    return start != 0 ? ret.substr(start) : ret;
+}
+
+const PackEntry* PackFile::find(const std::string& path) const
+{
+    if (header_ == nullptr)
+        return nullptr;
+    u64 hash = hashString64(path.c_str());
+    const PackEntry* end = toc_ + header_->count;
+    const PackEntry* it = std::lower_bound(toc_, end, hash,
+        [](const PackEntry& e, u64 h) { return e.hash < h; });
+    if (it == end || it->hash != hash || path != names_ + it->name)
+        return nullptr;
+    return it;
+}
+
+PackWriter::PackWriter(u32 alignment)
+    : alignment_(alignment != 0 ? alignment : 1)
+{
+}
+
+bool PackWriter::add(const std::string& path, const u8* data, u64 size, bool compress)
+{
+    if (size > 0xffffffffULL) {
+        ERR("pack: %s is too large", path.c_str());
+        return false;
+    }
+    Item item;
+    item.path = PackFile::normalize(path);
+    PackEntry& entry = item.entry;
+    entry.hash = hashString64(item.path.c_str());
+    entry.offset = 0;
+    entry.size = size;
+    entry.name = 0;
+    entry.flags = 0;
+    if (compress && size > 0) {
+        u32 bound = lz::compressBound(static_cast<u32>(size));
+        item.payload.resize(bound);
+        u32 packed = lz::compress(data, static_cast<u32>(size), item.payload.data(), bound);
+        if (packed != 0 && packed <= size - size / 8) {
+            item.payload.resize(packed);
+            entry.flags |= PackEntry::Compressed;
+        }
+    }
+    if ((entry.flags & PackEntry::Compressed) == 0)
+        item.payload.assign(data, data + size);
+    entry.storedSize = item.payload.size();
+    entries_.push_back(std::move(item));
+    return true;
+}
+
+bool PackWriter::write(const std::string& filename)
+{
+    std::sort(entries_.begin(), entries_.end(),
+        [](const Item& a, const Item& b) { return a.entry.hash < b.entry.hash; });
+    for (size_t i = 1; i < entries_.size(); i++) {
+        if (entries_[i - 1].entry.hash == entries_[i].entry.hash) {
+            ERR("pack: %s and %s have the same hash", entries_[i - 1].path.c_str(), entries_[i].path.c_str());
+            return false;
+        }
+    }
+
+    PackHeader header;
+    header.magic = PackHeader::Magic;
+    header.version = PackHeader::Version;
+    header.count = static_cast<u32>(entries_.size());
+    header.alignment = alignment_;
+    header.namesOffset = sizeof(PackHeader) + entries_.size() * sizeof(PackEntry);
+
+    std::vector<char> names;
+    for (Item& item : entries_) {
+        item.entry.name = static_cast<u32>(names.size());
+        names.insert(names.end(), item.path.begin(), item.path.end());
+        names.push_back('\0');
+    }
+    header.namesSize = names.size();
+
+    u64 offset = header.namesOffset + header.namesSize;
+    for (Item& item : entries_) {
+        offset = (offset + alignment_ - 1) / alignment_ * alignment_;
+        item.entry.offset = offset;
+        offset += item.entry.storedSize;
+    }
+
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        ERR("pack: can't open %s", filename.c_str());
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const Item& item : entries_)
+        ok = ok && fwrite(&item.entry, sizeof(PackEntry), 1, file) == 1;
+    ok = ok && (names.empty() || fwrite(names.data(), names.size(), 1, file) == 1);
+    u64 position = header.namesOffset + header.namesSize;
+    const char zeros[64] = { 0 };
+    for (const Item& item : entries_) {
+        while (ok && position < item.entry.offset) {
+            u64 pad = std::min<u64>(item.entry.offset - position, sizeof(zeros));
+            ok = fwrite(zeros, static_cast<size_t>(pad), 1, file) == 1;
+            position += pad;
+        }
+        ok = ok && (item.payload.empty() || fwrite(item.payload.data(), item.payload.size(), 1, file) == 1);
+        position += item.payload.size();
+    }
+    ok = fclose(file) == 0 && ok;
+    if (!ok)
+        ERR("pack: failed to write %s", filename.c_str());
+    return ok;
+}
+
+} // namespace base
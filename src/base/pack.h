@@ -0,0 +1,105 @@
+/**
+ * \file
+ * \brief       read-only asset archive with hashed table of contents
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "base/stream.h"
+#include <string>
+#include <vector>
+
+namespace base {
+
+//! Layout of pack file:
+//!   PackHeader
+//!   PackEntry[count]     sorted by hash
+//!   names                zero terminated relative paths
+//!   payloads             every one aligned to header alignment
+//! Header and table of contents come first, so lookup touches a single
+//! page and payloads are read only when used
+struct PackHeader
+{
+    static const u32 Magic = 0x4b41504e;    //!< "NPAK"
+    static const u32 Version = 1;
+
+    u32 magic;
+    u32 version;
+    u32 count;
+    u32 alignment;
+    u64 namesOffset;
+    u64 namesSize;
+};
+
+struct PackEntry
+{
+    enum Flags : u32 {
+        Compressed = 1      //!< payload is lz block, size is decompressed size
+    };
+
+    u64 hash;           //!< hashString64 of normalized path
+    u64 offset;         //!< offset of payload from file start
+    u64 storedSize;
+    u64 size;
+    u32 name;           //!< offset in names block
+    u32 flags;
+};
+
+//! Memory mapped pack
+class PackFile
+{
+public:
+    NEGINE_API PackFile(const std::string& filename);
+
+    bool isOpen() const { return header_ != nullptr; }
+    u32 count() const { return header_ != nullptr ? header_->count : 0; }
+
+    //! Makes path key: path::normpath with leading "./" removed
+    NEGINE_API static std::string normalize(const std::string& path);
+
+    //! Returns entry of normalized path, nullptr if it is not packed
+    NEGINE_API const PackEntry* find(const std::string& path) const;
+    const PackEntry& entry(u32 index) const { return toc_[index]; }
+    const char* name(const PackEntry& entry) const { return names_ + entry.name; }
+
+    //! Returns stored payload, compressed or not
+    const u8* payload(const PackEntry& entry) const { return file_.view(entry.offset, entry.storedSize); }
+
+private:
+    MappedFile file_;
+    const PackHeader* header_;
+    const PackEntry* toc_;
+    const char* names_;
+
+    DISALLOW_COPY_AND_ASSIGN(PackFile);
+};
+
+//! Collects files and writes pack
+class PackWriter
+{
+public:
+    NEGINE_API explicit PackWriter(u32 alignment = 16);
+
+    //! Adds file under normalized path, data is compressed when it saves
+    //! at least an eighth of size
+    NEGINE_API bool add(const std::string& path, const u8* data, u64 size, bool compress);
+
+    //! Writes pack, returns false if file can't be written or paths collide
+    NEGINE_API bool write(const std::string& filename);
+
+    u32 count() const { return static_cast<u32>(entries_.size()); }
+
+private:
+    struct Item
+    {
+        std::string path;
+        PackEntry entry;
+        std::vector<u8> payload;
+    };
+    std::vector<Item> entries_;
+    u32 alignment_;
+};
+
+} // namespace base
@@ -1,5 +1,6 @@
 #include "base/parameter.h"
 #include <string.h>
+#include <algorithm>
 
 namespace base {
 
@@ -7,59 +8,10 @@ Variant::Variant(const math::Matrix4& m) : type(Type::Mat4) {
     memcpy(m4.m, reinterpret_cast<const f32*>(&m), 16 * sizeof(f32));
 }
 
-Variant::Variant(const char* v) : type(Type::String) {
-    s.s = new char[strlen(v)];
-    strcpy(s.s, v);
-}
-
-Variant::~Variant() {
-    if (type == Type::String)
-        delete[] s.s;
-}
-
-Variant::Variant(const Variant& v) : type(v.type) {
-    switch (type) {
-    case Type::String: {
-                            s.s = new char[strlen(v.s.s)];
-                            strcpy(s.s, v.s.s);
-                            break;
-    }
-    case Type::Mat4: {
-                            memcpy(m4.m, v.m4.m, 16 * sizeof(f32));
-                            break;
-    }
-    case Type::Bool: b = v.b; break;
-    case Type::Float: f = v.f; break;
-    case Type::Int: i = v.i; break;
-    case Type::Vec2: v2 = v.v2; break;
-    case Type::Vec3: v3 = v.v3; break;
-    case Type::Vec4: v4 = v.v4; break;
-    default: break;
-    }
-}
-
-Variant& Variant::operator=(const Variant& v) {
-    if (type == Type::String) delete[] s.s;
-    type = v.type;
-    switch (type) {
-    case Type::String: {
-                            s.s = new char[strlen(v.s.s)];
-                            strcpy(s.s, v.s.s);
-                            break;
-    }
-    case Type::Mat4: {
-                            memcpy(m4.m, v.m4.m, 16 * sizeof(f32));
-                            break;
-    }
-    case Type::Bool: b = v.b; break;
-    case Type::Float: f = v.f; break;
-    case Type::Int: i = v.i; break;
-    case Type::Vec2: v2 = v.v2; break;
-    case Type::Vec3: v3 = v.v3; break;
-    case Type::Vec4: v4 = v.v4; break;
-    default: break;
-    }
-    return *this;
+Variant::Variant(const char* v) : type(Type::String) {
+    StringId id(v);
+    s.s = id.c_str();
+    s.id = id.value();
 }
 
 math::Matrix4 Variant::asMat4() const {
@@ -80,7 +32,7 @@ bool Variant::operator==(const Variant& v) const {
     case Type::Vec3: return memcmp(&v3, &v.v3, 3 * sizeof(f32)) == 0;
     case Type::Vec4: return memcmp(&v4, &v.v4, 4 * sizeof(f32)) == 0;
     case Type::Mat4: return memcmp(&m4, &v.m4, 16 * sizeof(f32)) == 0;
-    case Type::String: return strcmp(s.s, v.s.s) == 0;
+    case Type::String: return s.id == v.s.id;
     default: return false;
     }
 }
@@ -95,10 +47,228 @@ bool Variant::operator!=(const Variant& v) const {
     case Type::Vec3: return memcmp(&v3, &v.v3, 3 * sizeof(f32)) != 0;
     case Type::Vec4: return memcmp(&v4, &v.v4, 4 * sizeof(f32)) != 0;
     case Type::Mat4: return memcmp(&m4, &v.m4, 16 * sizeof(f32)) != 0;
-    case Type::String: return strcmp(s.s, v.s.s) != 0;
+    case Type::String: return s.id != v.s.id;
     default: return false;
     }
     return true;
 }
     
+Params::Params() {
+}
+
+u32 Params::typeSize(ParamType type) {
+    switch (type) {
+    case ParamType::Bool:
+    case ParamType::Int:
+    case ParamType::Float: return 4;
+    case ParamType::Vec2: return 2 * sizeof(f32);
+    case ParamType::Vec3: return 3 * sizeof(f32);
+    case ParamType::Vec4: return 4 * sizeof(f32);
+    case ParamType::Mat4: return 16 * sizeof(f32);
+    case ParamType::String: return sizeof(u64);
+    default: return 0;
+    }
+}
+
+ParamType Params::pack(const Variant& v, u8* out) {
+    if (v.isBool()) {
+        i32 b = v.asBool() ? 1 : 0;
+        memcpy(out, &b, sizeof(b));
+        return ParamType::Bool;
+    }
+    if (v.isInt()) {
+        i32 i = v.asInt();
+        memcpy(out, &i, sizeof(i));
+        return ParamType::Int;
+    }
+    if (v.isFloat()) {
+        f32 f = v.asFloat();
+        memcpy(out, &f, sizeof(f));
+        return ParamType::Float;
+    }
+    if (v.isVec2()) {
+        math::vec2f x = v.asVec2();
+        f32 a[2] = { x.x, x.y };
+        memcpy(out, a, sizeof(a));
+        return ParamType::Vec2;
+    }
+    if (v.isVec3()) {
+        math::vec3f x = v.asVec3();
+        f32 a[3] = { x.x, x.y, x.z };
+        memcpy(out, a, sizeof(a));
+        return ParamType::Vec3;
+    }
+    if (v.isVec4()) {
+        math::vec4f x = v.asVec4();
+        f32 a[4] = { x.x, x.y, x.z, x.w };
+        memcpy(out, a, sizeof(a));
+        return ParamType::Vec4;
+    }
+    if (v.isMat4()) {
+        math::Matrix4 m = v.asMat4();
+        memcpy(out, reinterpret_cast<const f32*>(&m), 16 * sizeof(f32));
+        return ParamType::Mat4;
+    }
+    if (v.isString()) {
+        u64 id = v.asStringId().value();
+        memcpy(out, &id, sizeof(id));
+        return ParamType::String;
+    }
+    return ParamType::None;
+}
+
+i32 Params::find(StringId key) const {
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    if (it == keys_.end() || *it != key)
+        return -1;
+    return static_cast<i32>(it - keys_.begin());
+}
+
+void Params::set(StringId key, const Variant& value) {
+    u8 buffer[16 * sizeof(f32)];
+    ParamType type = pack(value, buffer);
+    set(key, type, buffer);
+}
+
+void Params::set(StringId key, ParamType type, const void* data) {
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    u32 index = static_cast<u32>(it - keys_.begin());
+    if (it != keys_.end() && *it == key) {
+        setAt(index, type, data);
+        return;
+    }
+    u32 size = typeSize(type);
+    // values are appended, order of data does not follow order of keys
+    keys_.insert(it, key);
+    types_.insert(types_.begin() + index, type);
+    offsets_.insert(offsets_.begin() + index, static_cast<u32>(data_.size()));
+    const u8* bytes = static_cast<const u8*>(data);
+    data_.insert(data_.end(), bytes, bytes + size);
+}
+
+void Params::setAt(u32 index, ParamType type, const void* data) {
+    ASSERT(index < size());
+    u32 size = typeSize(type);
+    const u32 oldSize = typeSize(types_[index]);
+    if (oldSize != size) {
+        // bytes of old type are dropped, so retyping does not grow packed data
+        const u32 offset = offsets_[index];
+        data_.erase(data_.begin() + offset, data_.begin() + offset + oldSize);
+        for (u32& other : offsets_) {
+            if (other > offset)
+                other -= oldSize;
+        }
+        offsets_[index] = static_cast<u32>(data_.size());
+        data_.resize(data_.size() + size);
+    }
+    types_[index] = type;
+    memcpy(data_.data() + offsets_[index], data, size);
+}
+
+Variant Params::value(u32 index) const {
+    const u8* d = data(index);
+    f32 a[16];
+    switch (types_[index]) {
+    case ParamType::Bool: {
+        i32 b;
+        memcpy(&b, d, sizeof(b));
+        return Variant(b != 0);
+    }
+    case ParamType::Int: {
+        i32 i;
+        memcpy(&i, d, sizeof(i));
+        return Variant(i);
+    }
+    case ParamType::Float:
+        memcpy(a, d, sizeof(f32));
+        return Variant(a[0]);
+    case ParamType::Vec2:
+        memcpy(a, d, 2 * sizeof(f32));
+        return Variant(math::vec2f(a[0], a[1]));
+    case ParamType::Vec3:
+        memcpy(a, d, 3 * sizeof(f32));
+        return Variant(math::vec3f(a[0], a[1], a[2]));
+    case ParamType::Vec4:
+        memcpy(a, d, 4 * sizeof(f32));
+        return Variant(math::vec4f(a[0], a[1], a[2], a[3]));
+    case ParamType::Mat4: {
+        math::Matrix4 m;
+        memcpy(reinterpret_cast<f32*>(&m), d, 16 * sizeof(f32));
+        return Variant(m);
+    }
+    case ParamType::String: {
+        u64 id;
+        memcpy(&id, d, sizeof(id));
+        return Variant(StringId::fromValue(id));
+    }
+    default:
+        return Variant();
+    }
+}
+
+Variant Params::get(StringId key) const {
+    i32 index = find(key);
+    if (index < 0)
+        return Variant();
+    return value(static_cast<u32>(index));
+}
+
+void Params::merge(const Params& other) {
+    if (other.empty())
+        return;
+    if (empty()) {
+        *this = other;
+        return;
+    }
+    Params result;
+    u32 n = size() + other.size();
+    result.keys_.reserve(n);
+    result.types_.reserve(n);
+    result.offsets_.reserve(n);
+    result.data_.reserve(data_.size() + other.data_.size());
+    auto append = [&result](const Params& p, u32 i) {
+        u32 size = typeSize(p.types_[i]);
+        const u8* d = p.data(i);
+        result.keys_.push_back(p.keys_[i]);
+        result.types_.push_back(p.types_[i]);
+        result.offsets_.push_back(static_cast<u32>(result.data_.size()));
+        result.data_.insert(result.data_.end(), d, d + size);
+    };
+    u32 i = 0, j = 0;
+    while (i < size() && j < other.size()) {
+        if (keys_[i] < other.keys_[j]) {
+            append(*this, i++);
+        } else if (other.keys_[j] < keys_[i]) {
+            append(other, j++);
+        } else {
+            append(other, j++);
+            i++;
+        }
+    }
+    for (; i < size(); i++)
+        append(*this, i);
+    for (; j < other.size(); j++)
+        append(other, j);
+    keys_.swap(result.keys_);
+    types_.swap(result.types_);
+    offsets_.swap(result.offsets_);
+    data_.swap(result.data_);
+}
+
+void Params::clear() {
+    keys_.clear();
+    types_.clear();
+    offsets_.clear();
+    data_.clear();
+}
+
+bool Params::operator==(const Params& other) const {
+    if (keys_ != other.keys_ || types_ != other.types_)
+        return false;
+    for (u32 i = 0; i < size(); i++)
+        if (memcmp(data(i), other.data(i), typeSize(types_[i])) != 0)
+            return false;
+    return true;
+}
+
 }
\ No newline at end of file
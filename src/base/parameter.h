@@ -6,7 +6,8 @@
 #include "math/matrix.h"
 #include "math/matrix-inl.h"
 #include "base/debug.h"
-#include "base/smallstring.h"
+#include "base/stringid.h"
+#include <vector>
 
 namespace base {
 
@@ -21,12 +22,16 @@ namespace base {
         inline Variant(const math::vec3f& v) : type(Type::Vec3), v3({ v.x, v.y, v.z }) {}
         inline Variant(const math::vec4f& v) : type(Type::Vec4), v4({ v.x, v.y, v.z, v.w }) {}
         
-        Variant(const math::Matrix4& m);
-        Variant(const char* v);
+        inline Variant(StringId v) : type(Type::String), s({ v.c_str(), v.value() }) {}
 
-        NEGINE_API Variant(const Variant& v);
-        NEGINE_API Variant& operator=(const Variant& v);
-        NEGINE_API ~Variant();
+        NEGINE_API Variant(const math::Matrix4& m);
+        //! Interns string, variant keeps pointer to interned storage
+        NEGINE_API Variant(const char* v);
+
+        Variant(const Variant& v) = default;
+        Variant(Variant&& v) = default;
+        Variant& operator=(const Variant& v) = default;
+        Variant& operator=(Variant&& v) = default;
 
         bool operator==(const Variant& v) const;
         bool operator!=(const Variant& v) const;
@@ -42,6 +47,7 @@ namespace base {
         inline bool isString() const { return type == Type::String; }
         
         inline const char*  asString() const { ASSERT(isString()); return s.s; }
+        inline StringId   asStringId() const { ASSERT(isString()); return StringId::fromValue(s.id); }
         inline bool           asBool() const { ASSERT(isBool());   return b; }
         inline f32           asFloat() const { ASSERT(isFloat());  return f; }
         inline i32             asInt() const { ASSERT(isInt());    return i; }
@@ -63,9 +69,64 @@ namespace base {
             struct Vec3 { f32 x, y, z; } v3;
             struct Vec4 { f32 x, y, z, w; } v4;
             struct Mat4 { f32 m[16]; } m4;
-            struct String { char* s; } s;
+            struct String { const char* s; u64 id; } s;
         };
     };
 
-    typedef FixedMap<SmallString, Variant> Params;
+    //! Type tag of packed parameter
+    enum class ParamType : u8 {
+        None, Bool, Int, Float, Vec2, Vec3, Vec4, Mat4, String
+    };
+
+    //! Packed parameter block
+    //! Keys are kept sorted in one array, values are packed into byte buffer
+    //! with type tags in another one. Lookup is a binary search over keys,
+    //! merge is a single linear pass over both blocks.
+    //! Strings are stored as interned StringId.
+    class Params
+    {
+    public:
+        NEGINE_API Params();
+
+        //! Sets value, replaces previous one
+        NEGINE_API void set(StringId key, const Variant& value);
+        NEGINE_API void set(StringId key, ParamType type, const void* data);
+        //! Overwrites value of existing entry
+        NEGINE_API void setAt(u32 index, ParamType type, const void* data);
+
+        //! Returns index of key or -1
+        NEGINE_API i32 find(StringId key) const;
+        bool contains(StringId key) const { return find(key) >= 0; }
+
+        u32 size() const { return static_cast<u32>(keys_.size()); }
+        bool empty() const { return keys_.empty(); }
+        StringId key(u32 index) const { return keys_[index]; }
+        ParamType type(u32 index) const { return types_[index]; }
+        const u8* data(u32 index) const { return data_.data() + offsets_[index]; }
+        //! Bytes of all packed values
+        u32 packedSize() const { return static_cast<u32>(data_.size()); }
+
+        //! Unpacks value at index
+        NEGINE_API Variant value(u32 index) const;
+        //! Returns value or None variant
+        NEGINE_API Variant get(StringId key) const;
+
+        //! Adds all values of other block, values of other win
+        NEGINE_API void merge(const Params& other);
+
+        NEGINE_API void clear();
+
+        NEGINE_API bool operator==(const Params& other) const;
+        bool operator!=(const Params& other) const { return !(*this == other); }
+
+        //! Size of packed value in bytes
+        NEGINE_API static u32 typeSize(ParamType type);
+        //! Packs variant into out (up to 64 bytes), returns its type
+        NEGINE_API static ParamType pack(const Variant& value, u8* out);
+    private:
+        std::vector<StringId> keys_;
+        std::vector<ParamType> types_;
+        std::vector<u32> offsets_;
+        std::vector<u8> data_;
+    };
 }
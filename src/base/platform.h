@@ -5,6 +5,7 @@
  *              unix:               OS_UNIX
  *              compiler:           COMPILER_GCC, COMPILER_MSVC, COMPILER_CLANG
  *              architecture:       OS_ARCH_32, OS_ARCH_64
+ *              cpu family:         OS_CPU_X86 (x86 and x86-64)
  * \author      Alexey Vasilyev <alexa.infra@gmail.com>
  * \copyright   MIT License
  **/
@@ -53,3 +54,7 @@
 #else
 #   define OS_ARCH_32
 #endif
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#   define OS_CPU_X86
+#endif
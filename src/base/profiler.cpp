@@ -1,51 +1,324 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
 #include "base/profiler.h"
+#include "base/timer.h"
 #include <algorithm>
-#include <iterator>
+#include <deque>
+#include <unordered_map>
 
 namespace base {
 
 Profiler* Profiler::instance_ = nullptr;
 
-f32& Profiler::_counter(const std::string& name)
+namespace {
+
+//! Interned scope names, lives longer than Profiler instance,
+//! because ids are cached in function statics
+struct NameTable
+{
+    std::mutex lock;
+    std::unordered_map<std::string, u32> ids;
+    std::deque<std::string> names;
+};
+
+NameTable& nameTable()
+{
+    static NameTable table;
+    return table;
+}
+
+std::atomic<u32> profilerGeneration(0);
+
+//! Events of other threads could be converted after the frame marker
+u64 elapsed(u64 start, u64 end)
+{
+    return end > start ? end - start : 0;
+}
+
+//! Frame markers are on the time line of events: cycles converted the same way
+u64 now()
+{
+    return Clock::cyclesToNanoseconds(Clock::cycles());
+}
+
+void writeJsonString(std::ostream* out, const std::string& str)
+{
+    *out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            *out << '\\';
+        *out << c;
+    }
+    *out << '"';
+}
+
+} // namespace
+
+struct Profiler::Event
+{
+    u64 time;
+    u32 id;
+    u32 begin;
+};
+
+//! Single producer (owner thread), single consumer (endFrame) ring
+struct Profiler::ThreadBuffer
+{
+    static const u32 Capacity = 1 << 14;
+    static const u32 Mask = Capacity - 1;
+
+    struct Open
+    {
+        u32 id;
+        u64 start;
+        i32 sample;
+    };
+
+    Event events[Capacity];
+    std::atomic<u32> head;
+    std::atomic<u32> tail;
+    u32 index;
+    //! scopes which are not closed yet, touched by consumer only
+    std::vector<Open> stack;
+
+    explicit ThreadBuffer(u32 idx) : head(0), tail(0), index(idx) {}
+};
+
+Profiler::Profiler()
+    : dropped_(0)
+{
+    generation_ = ++profilerGeneration;
+    Clock::calibrate();
+    startTime_ = now();
+    frameStart_ = startTime_;
+}
+
+Profiler::~Profiler()
+{
+    for (ThreadBuffer* buffer : threads_)
+        delete buffer;
+}
+
+u32 Profiler::intern(const char* name)
+{
+    NameTable& table = nameTable();
+    std::lock_guard<std::mutex> guard(table.lock);
+    auto it = table.ids.find(name);
+    if (it != table.ids.end())
+        return it->second;
+    u32 id = static_cast<u32>(table.names.size());
+    table.names.push_back(name);
+    table.ids[table.names.back()] = id;
+    return id;
+}
+
+const std::string& Profiler::name(u32 id)
+{
+    NameTable& table = nameTable();
+    std::lock_guard<std::mutex> guard(table.lock);
+    ASSERT(id < table.names.size());
+    return table.names[id];
+}
+
+Profiler::ThreadBuffer* Profiler::threadBuffer()
+{
+    static thread_local ThreadBuffer* localBuffer_ = nullptr;
+    static thread_local u32 localGeneration_ = 0;
+    if (localBuffer_ != nullptr && localGeneration_ == generation_)
+        return localBuffer_;
+    std::lock_guard<std::mutex> guard(threadsLock_);
+    ThreadBuffer* buffer = new ThreadBuffer(static_cast<u32>(threads_.size()));
+    threads_.push_back(buffer);
+    localBuffer_ = buffer;
+    localGeneration_ = generation_;
+    return buffer;
+}
+
+void Profiler::begin(u32 id)
+{
+    if (!hasInstance())
+        return;
+    Profiler& self = instance();
+    ThreadBuffer* buffer = self.threadBuffer();
+    u32 head = buffer->head.load(std::memory_order_relaxed);
+    if (head - buffer->tail.load(std::memory_order_acquire) >= ThreadBuffer::Capacity) {
+        self.dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Event& e = buffer->events[head & ThreadBuffer::Mask];
+    e.time = Clock::cycles();
+    e.id = id;
+    e.begin = 1;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::end(u32 id)
+{
+    if (!hasInstance())
+        return;
+    u64 time = Clock::cycles();
+    Profiler& self = instance();
+    ThreadBuffer* buffer = self.threadBuffer();
+    u32 head = buffer->head.load(std::memory_order_relaxed);
+    if (head - buffer->tail.load(std::memory_order_acquire) >= ThreadBuffer::Capacity) {
+        self.dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Event& e = buffer->events[head & ThreadBuffer::Mask];
+    e.time = time;
+    e.id = id;
+    e.begin = 0;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::_endFrame()
+{
+    frame_.clear();
+    std::lock_guard<std::mutex> guard(threadsLock_);
+    for (ThreadBuffer* buffer : threads_)
+        drain(buffer);
+    frameStart_ = now();
+}
+
+void Profiler::drain(ThreadBuffer* buffer)
+{
+    auto& stack = buffer->stack;
+    auto open = [&](u32 id, u64 start) {
+        ProfilerSample sample;
+        sample.id = id;
+        sample.thread = buffer->index;
+        sample.parent = stack.empty() ? -1 : stack.back().sample;
+        sample.depth = static_cast<u32>(stack.size());
+        sample.start = start;
+        sample.duration = 0;
+        frame_.push_back(sample);
+        return static_cast<i32>(frame_.size() - 1);
+    };
+
+    // scopes spanning several frames are continued from the frame start
+    std::vector<ThreadBuffer::Open> pending;
+    pending.swap(stack);
+    for (auto& o : pending) {
+        o.sample = open(o.id, std::max(o.start, frameStart_));
+        stack.push_back(o);
+    }
+
+    u32 tail = buffer->tail.load(std::memory_order_relaxed);
+    u32 head = buffer->head.load(std::memory_order_acquire);
+    for (; tail != head; ++tail) {
+        const Event& e = buffer->events[tail & ThreadBuffer::Mask];
+        u64 time = Clock::cyclesToNanoseconds(e.time);
+        if (e.begin) {
+            ThreadBuffer::Open o;
+            o.id = e.id;
+            o.start = time;
+            o.sample = open(e.id, time);
+            stack.push_back(o);
+            continue;
+        }
+        // begin could be lost on overflow, unwind to the matching scope
+        auto it = std::find_if(stack.rbegin(), stack.rend(),
+            [&e](const ThreadBuffer::Open& o) { return o.id == e.id; });
+        if (it == stack.rend())
+            continue;
+        for (auto lost = it.base(); lost != stack.end(); ++lost)
+            frame_[lost->sample].duration = elapsed(frame_[lost->sample].start, time);
+        stack.erase(it.base(), stack.end());
+        const ThreadBuffer::Open& o = stack.back();
+        ProfilerSample& sample = frame_[o.sample];
+        sample.duration = elapsed(sample.start, time);
+        _counter(o.id) += static_cast<f32>(elapsed(o.start, time) / 1e6);
+        stack.pop_back();
+    }
+    buffer->tail.store(tail, std::memory_order_release);
+
+    u64 frameEnd = now();
+    for (auto& o : stack) {
+        ProfilerSample& sample = frame_[o.sample];
+        sample.duration = elapsed(sample.start, frameEnd);
+    }
+}
+
+f32& Profiler::_counter(u32 id)
 {
-    return counters_[name];
+    if (id >= counters_.size()) {
+        counters_.resize(id + 1, 0.0f);
+        used_.resize(id + 1, false);
+    }
+    used_[id] = true;
+    return counters_[id];
 }
 
 void Profiler::_clear()
 {
     counters_.clear();
+    used_.clear();
 }
 
 void Profiler::_reset()
 {
-    std::for_each(counters_.begin(), counters_.end(), 
-        [](Map::value_type& p) { p.second = 0.0f; });
+    std::fill(counters_.begin(), counters_.end(), 0.0f);
+}
+
+static std::vector<std::pair<std::string, u32>> sortedCounters(const std::vector<bool>& used)
+{
+    std::vector<std::pair<std::string, u32>> ids;
+    for (u32 i = 0; i < used.size(); i++)
+        if (used[i])
+            ids.push_back(std::make_pair(Profiler::name(i), i));
+    std::sort(ids.begin(), ids.end());
+    return ids;
 }
 
 void Profiler::_reportHeader(std::ostream* out)
 {
-    auto mapFirst = [](const Map::value_type& p){ return p.first; };
-    std::transform(counters_.begin(), std::prev(counters_.end()),
-        std::ostream_iterator<std::string>(*out, ","),
-        mapFirst);
-    if (!counters_.empty())
-        *out << mapFirst(*std::prev(counters_.end())) << std::endl;
+    auto ids = sortedCounters(used_);
+    for (size_t i = 0; i < ids.size(); i++)
+        *out << ids[i].first << (i + 1 < ids.size() ? "," : "\n");
+    out->flush();
 }
 
 void Profiler::_report(std::ostream* out)
 {
-    auto mapSecond = [](const Map::value_type& p){ return p.second; };
-    std::transform(counters_.begin(), std::prev(counters_.end()),
-        std::ostream_iterator<f32>(*out, ","),
-        mapSecond);
-    if (!counters_.empty())
-        *out << mapSecond(*std::prev(counters_.end())) << std::endl;
+    auto ids = sortedCounters(used_);
+    for (size_t i = 0; i < ids.size(); i++)
+        *out << counters_[ids[i].second] << (i + 1 < ids.size() ? "," : "\n");
+    out->flush();
+}
+
+void Profiler::_writeChromeTrace(std::ostream* out)
+{
+    *out << "{\"traceEvents\":[";
+    for (size_t i = 0; i < frame_.size(); i++) {
+        const ProfilerSample& s = frame_[i];
+        if (i != 0)
+            *out << ",";
+        *out << "\n{\"name\":";
+        writeJsonString(out, name(s.id));
+        *out << ",\"cat\":\"negine\",\"ph\":\"X\",\"pid\":0"
+             << ",\"tid\":" << s.thread
+             << ",\"ts\":" << static_cast<i64>(s.start - startTime_) / 1000.0
+             << ",\"dur\":" << s.duration / 1000.0
+             << ",\"args\":{\"depth\":" << s.depth << ",\"parent\":" << s.parent << "}}";
+    }
+    *out << "\n]}" << std::endl;
+}
+
+ProfilerScope::ProfilerScope(u32 id)
+    : running_(true)
+    , id_(id)
+{
+    Profiler::begin(id_);
 }
 
 ProfilerScope::ProfilerScope(const std::string& name)
-: name_(name)
+    : running_(true)
+    , id_(Profiler::intern(name.c_str()))
 {
-    running_ = true;
+    Profiler::begin(id_);
 }
 
 ProfilerScope::~ProfilerScope()
@@ -56,7 +329,7 @@ ProfilerScope::~ProfilerScope()
 void ProfilerScope::stop()
 {
     if (running_) {
-        Profiler::counter(name_) += timer_.reset();
+        Profiler::end(id_);
         running_ = false;
     }
 }
@@ -64,7 +337,7 @@ void ProfilerScope::stop()
 void ProfilerScope::start()
 {
     if (!running_) {
-        timer_.reset();
+        Profiler::begin(id_);
         running_ = true;
     }
 }
@@ -77,5 +350,4 @@ void ProfilerScope::toggle()
         start();
 }
 
-
-} // namespace base
\ No newline at end of file
+} // namespace base
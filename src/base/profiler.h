@@ -1,56 +1,149 @@
+/**
+ * \file
+ * \brief       hierarchical, thread-aware scope profiler
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
 #pragma once
 
 #include "base/singleton.h"
-#include "base/timer.h"
-#include <map>
+#include <atomic>
+#include <mutex>
+#include <vector>
 #include <string>
 #include <ostream>
 
 namespace base {
 
+//! Completed scope of the last frame
+struct ProfilerSample
+{
+    u32 id;         //!< interned scope name
+    u32 thread;     //!< profiler thread index
+    i32 parent;     //!< index of enclosing sample in the frame, -1 for root
+    u32 depth;      //!< nesting level, 0 for root
+    u64 start;      //!< start time in nanoseconds (Clock::cycles converted by cyclesToNanoseconds)
+    u64 duration;   //!< duration in nanoseconds
+};
+
+//! Scope profiler
+//!
+//! Scope names are interned once per call site into dense u32 ids,
+//! every thread writes begin/end events (Clock::cycles) into its own lock-free ring,
+//! and endFrame() (main thread) drains the rings, rebuilds nesting
+//! and accumulates totals for the CSV report.
 class Profiler : public Singleton<Profiler>
 {
-private:
-    f32& _counter(const std::string& name);
-    void _clear();
-    void _reset();
-    void _report(std::ostream* out);
-    void _reportHeader(std::ostream* out);
 public:
+    Profiler();
+    ~Profiler();
+
+    //! Returns id of scope name, same name gives the same id.
+    //! Takes a lock, call it once per call site (PROFILER_SCOPE does it)
+    static u32 intern(const char* name);
+
+    //! Returns name of interned id
+    static const std::string& name(u32 id);
+
+    //! Records beginning of scope in current thread
+    static void begin(u32 id);
+
+    //! Records ending of scope in current thread
+    static void end(u32 id);
+
+    //! Collects events of all threads, call it once per frame
+    static void endFrame() {
+        if (hasInstance())
+            instance()._endFrame();
+    }
+
+    //! Returns accumulated time of scope in milliseconds
+    static f32& counter(u32 id) {
+        return instance()._counter(id);
+    }
     static f32& counter(const std::string& name) {
-        return instance()._counter(name);
+        return instance()._counter(intern(name.c_str()));
     }
     static void clear() {
         instance()._clear();
     }
     static void reset() {
-        instance().reset();
+        instance()._reset();
     }
     static void report(std::ostream* out) {
-        instance().report(out);
+        instance()._report(out);
     }
     static void reportHeader(std::ostream* out) {
-        instance().reportHeader(out);
+        instance()._reportHeader(out);
+    }
+
+    //! Writes samples of the last frame as Chrome trace JSON (chrome://tracing)
+    static void writeChromeTrace(std::ostream* out) {
+        instance()._writeChromeTrace(out);
+    }
+
+    //! Returns samples of the last frame
+    static const std::vector<ProfilerSample>& frame() {
+        return instance().frame_;
+    }
+
+    //! Returns count of events lost because of ring overflow
+    static u32 dropped() {
+        return instance().dropped_.load(std::memory_order_relaxed);
     }
+
+    static bool enabled() {
+        return hasInstance();
+    }
+
 private:
-    typedef std::map<std::string, f32> Map;
-    Map counters_;
+    struct Event;
+    struct ThreadBuffer;
+
+    ThreadBuffer* threadBuffer();
+    void _endFrame();
+    void drain(ThreadBuffer* buffer);
+    f32& _counter(u32 id);
+    void _clear();
+    void _reset();
+    void _report(std::ostream* out);
+    void _reportHeader(std::ostream* out);
+    void _writeChromeTrace(std::ostream* out);
+
+private:
+    std::mutex threadsLock_;
+    std::vector<ThreadBuffer*> threads_;
+    std::vector<f32> counters_;
+    std::vector<bool> used_;
+    std::vector<ProfilerSample> frame_;
+    std::atomic<u32> dropped_;
+    u32 generation_;
+    u64 startTime_;
+    u64 frameStart_;
+
+    DISALLOW_COPY_AND_ASSIGN(Profiler);
 };
 
 class ProfilerScope
 {
 public:
-    ProfilerScope(const std::string& name);
+    explicit ProfilerScope(u32 id);
+    //! Interns name on every call, prefer PROFILER_SCOPE
+    explicit ProfilerScope(const std::string& name);
     ~ProfilerScope();
     void stop();
     void start();
     void toggle();
 private:
     bool running_;
-    Timer timer_;
-    std::string name_;
+    u32 id_;
 };
 
-#define PROFILER_SCOPE(name) ProfilerScope scope ## __LINE__(name)
+#define PROFILER_CONCAT_IMPL(a, b) a ## b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+#define PROFILER_SCOPE(name) \
+    static const base::u32 PROFILER_CONCAT(profilerId_, __LINE__) = base::Profiler::intern(name); \
+    base::ProfilerScope PROFILER_CONCAT(profilerScope_, __LINE__)(PROFILER_CONCAT(profilerId_, __LINE__))
 
-} // namespace base
\ No newline at end of file
+} // namespace base
@@ -3,11 +3,109 @@
 #include <boost/python.hpp>
 #include "math/py_math.h"
 #include "render/py_render.h"
+#include "base/memorytags.h"
+#include "base/vfs.h"
+#include "base/debug.h"
+#include <string.h>
 
 using namespace boost::python;
+using namespace base;
+
+namespace {
+
+//! Never destroyed, Python frees memory after engine shutdown too
+foundation::Allocator* scripting_ = nullptr;
+
+//! Python expects alignment of largest scalar type
+const u32 kPythonAlign = 16;
+
+void* pyMalloc(void*, size_t size)
+{
+    if (size > 0x7fffffff)
+        return nullptr;
+    return scripting_->allocate(static_cast<u32>(size), kPythonAlign);
+}
+
+void* pyCalloc(void*, size_t count, size_t size)
+{
+    if (size != 0 && count > 0x7fffffff / size)
+        return nullptr;
+    void* p = pyMalloc(nullptr, count * size);
+    if (p != nullptr)
+        memset(p, 0, count * size);
+    return p;
+}
+
+void* pyRealloc(void*, void* p, size_t size)
+{
+    if (p == nullptr)
+        return pyMalloc(nullptr, size);
+    void* q = pyMalloc(nullptr, size);
+    if (q == nullptr)
+        return nullptr;
+    const size_t old = scripting_->allocated_size(p);
+    memcpy(q, p, old < size ? old : size);
+    scripting_->deallocate(p);
+    return q;
+}
+
+void pyFree(void*, void* p)
+{
+    scripting_->deallocate(p);
+}
+
+void* arenaAlloc(void*, size_t size)
+{
+    return pyMalloc(nullptr, size);
+}
+
+void arenaFree(void*, void* p, size_t)
+{
+    scripting_->deallocate(p);
+}
+
+} // namespace
+
+void base::initPythonMemory()
+{
+    ASSERT(scripting_ == nullptr);
+    scripting_ = &memory::allocator(MemoryTag::Scripting);
+    // object and mem domains keep small object allocator, it takes arenas
+    // from arena allocator and larger blocks from raw domain
+    PyMemAllocatorEx raw = { nullptr, pyMalloc, pyCalloc, pyRealloc, pyFree };
+    PyMem_SetAllocator(PYMEM_DOMAIN_RAW, &raw);
+    PyObjectArenaAllocator arena = { nullptr, arenaAlloc, arenaFree };
+    PyObject_SetArenaAllocator(&arena);
+}
+
+//! Returns {tag: {live, peak, count, frame_allocs, frame_bytes}}
+static dict memoryStats()
+{
+    dict result;
+    for (u32 i = 0; i < static_cast<u32>(MemoryTag::Count); i++) {
+        MemoryTag tag = static_cast<MemoryTag>(i);
+        MemoryStats s = memory::stats(tag);
+        dict d;
+        d["live"] = s.live;
+        d["peak"] = s.peak;
+        d["count"] = s.count;
+        d["frame_allocs"] = s.frameAllocations;
+        d["frame_bytes"] = s.frameBytes;
+        result[memory::tagName(tag)] = d;
+    }
+    return result;
+}
+
+//! Mounts pack at root
+static bool mountPack(const std::string& path)
+{
+    return vfs::mount(path);
+}
 
 BOOST_PYTHON_MODULE(negine_core)
 {
     init_py_math();
     init_py_render();
+    def("memory_stats", memoryStats);
+    def("mount", mountPack);
 }
\ No newline at end of file
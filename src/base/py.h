@@ -9,3 +9,13 @@ typedef _object PyObject;
 
 extern "C" NEGINE_API PyObject* PyInit_negine_core();
 
+namespace base {
+
+//! Routes memory of embedded interpreter to Scripting tag: raw allocations
+//! and arenas of small object allocator, which serves Python objects and
+//! instances of bound classes. Call after memory::init() and before any
+//! Python call, including PyImport_AppendInittab
+NEGINE_API void initPythonMemory();
+
+} // namespace base
+
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "base/types.h"
+#include "base/stringid.h"
 #include <string>
 
 namespace base {
@@ -26,8 +27,7 @@ public:
         hash_ = 0;
     }
     inline HashString(const char* s) {
-        std::hash<std::string> h;
-        hash_ = h(s);
+        hash_ = StringId::hash(s);
     }
     inline bool operator==(const HashString& s) const {
         return hash_ == s.hash_;
@@ -4,11 +4,24 @@
  * \copyright   MIT License
  **/
 #include "base/stream.h"
+#include <string.h>
+
+#ifdef OS_WIN
+# include <windows.h>
+#endif
+#ifdef OS_UNIX
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
 
 namespace base
 {
 
 FileBinary::FileBinary( const std::string& filename )
+    : filePosition_( 0 )
+    , writing_( false )
 {
     file_.open( filename.c_str(), std::ios::binary | std::ios::in | std::ios::out );
 }
@@ -20,22 +33,165 @@ FileBinary::~FileBinary()
     }
 }
 
-u32 FileBinary::size()
+u64 FileBinary::size()
 {
     file_.seekg( 0, std::ios::end );
-    return static_cast<u32>( file_.tellg() );
+    u64 ret = static_cast<u64>( file_.tellg() );
+    file_.seekg( filePosition_ );
+    return ret;
 }
 
-void FileBinary::readImpl( u8* dest, u32 size, u32 position )
+void FileBinary::readImpl( u8* dest, u64 size, u64 position )
 {
-    file_.seekg( position );
+    if ( position != filePosition_ || writing_ ) {
+        file_.seekg( position );
+    }
     file_.read( reinterpret_cast<char*>( dest ), size );
+    filePosition_ = position + file_.gcount();
+    writing_ = false;
 }
 
-void FileBinary::writeImpl( const u8* source, u32 size, u32 position )
+void FileBinary::writeImpl( const u8* source, u64 size, u64 position )
 {
-    file_.seekp( position );
+    // fstream shares one position for get and put, as with FILE
+    // a write after a read is undefined without a seek in between
+    if ( position != filePosition_ || !writing_ ) {
+        file_.seekp( position );
+    }
     file_.write( reinterpret_cast<const char*>( source ), size );
+    filePosition_ = position + size;
+    writing_ = true;
+}
+
+#ifdef OS_UNIX
+
+static int adviceFlag( MappedFile::Access access )
+{
+    switch ( access ) {
+    case MappedFile::Access::Sequential: return MADV_SEQUENTIAL;
+    case MappedFile::Access::Random: return MADV_RANDOM;
+    case MappedFile::Access::WillNeed: return MADV_WILLNEED;
+    case MappedFile::Access::Normal:
+    default: return MADV_NORMAL;
+    }
+}
+
+MappedFile::MappedFile( const std::string& filename, Access access )
+    : data_( nullptr )
+    , size_( 0 )
+    , opened_( false )
+{
+    int fd = open( filename.c_str(), O_RDONLY );
+    if ( fd < 0 ) {
+        return;
+    }
+    struct stat st;
+    if ( fstat( fd, &st ) == 0 ) {
+        size_ = static_cast<u64>( st.st_size );
+        opened_ = true;
+    }
+    if ( opened_ && size_ > 0 ) {
+        void* ptr = mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if ( ptr != MAP_FAILED ) {
+            data_ = static_cast<const u8*>( ptr );
+            advise( access );
+        } else {
+            opened_ = false;
+            size_ = 0;
+        }
+    }
+    // mapping keeps its own reference to the file
+    close( fd );
+}
+
+MappedFile::~MappedFile()
+{
+    if ( data_ != nullptr ) {
+        munmap( const_cast<u8*>( data_ ), size_ );
+    }
+}
+
+void MappedFile::advise( Access access, u64 offset, u64 size )
+{
+    if ( data_ == nullptr || offset >= size_ ) {
+        return;
+    }
+    if ( size == 0 || size > size_ - offset ) {
+        size = size_ - offset;
+    }
+    // madvise wants page aligned address
+    static const u64 pageSize = static_cast<u64>( sysconf( _SC_PAGESIZE ) );
+    u64 aligned = offset & ~( pageSize - 1 );
+    madvise( const_cast<u8*>( data_ ) + aligned, size + ( offset - aligned ), adviceFlag( access ) );
+}
+
+#elif defined(OS_WIN)
+
+MappedFile::MappedFile( const std::string& filename, Access access )
+    : data_( nullptr )
+    , size_( 0 )
+    , opened_( false )
+    , file_( INVALID_HANDLE_VALUE )
+    , mapping_( nullptr )
+{
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if ( access == Access::Sequential ) {
+        flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    } else if ( access == Access::Random ) {
+        flags |= FILE_FLAG_RANDOM_ACCESS;
+    }
+    file_ = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                         nullptr, OPEN_EXISTING, flags, nullptr );
+    if ( file_ == INVALID_HANDLE_VALUE ) {
+        return;
+    }
+    LARGE_INTEGER fileSize;
+    if ( GetFileSizeEx( file_, &fileSize ) == FALSE ) {
+        return;
+    }
+    size_ = static_cast<u64>( fileSize.QuadPart );
+    opened_ = true;
+    if ( size_ == 0 ) {
+        return;
+    }
+    mapping_ = CreateFileMappingA( file_, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if ( mapping_ != nullptr ) {
+        data_ = static_cast<const u8*>( MapViewOfFile( mapping_, FILE_MAP_READ, 0, 0, 0 ) );
+    }
+    if ( data_ == nullptr ) {
+        opened_ = false;
+        size_ = 0;
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if ( data_ != nullptr ) {
+        UnmapViewOfFile( data_ );
+    }
+    if ( mapping_ != nullptr ) {
+        CloseHandle( mapping_ );
+    }
+    if ( file_ != INVALID_HANDLE_VALUE ) {
+        CloseHandle( file_ );
+    }
+}
+
+void MappedFile::advise( Access access, u64 offset, u64 size )
+{
+    // access pattern is given to CreateFile, nothing to change later
+}
+
+#endif
+
+void MappedFile::readImpl( u8* dest, u64 size, u64 position )
+{
+    const u8* src = view( position, size );
+    if ( src != nullptr ) {
+        memcpy( dest, src, size );
+    } else {
+        memset( dest, 0, size );
+    }
 }
 
 FileText::FileText( const std::string& filename )
@@ -47,7 +203,7 @@ FileText::FileText( const std::string& filename )
 
     if ( file_.good() ) {
         file_.seekg( 0, std::ios::end );
-        size_ = static_cast<u32>( file_.tellg() );
+        size_ = static_cast<u64>( file_.tellg() );
         file_.seekg( 0, std::ios::beg );
         sb_ = file_.rdbuf();
     }
@@ -75,7 +231,7 @@ std::vector<std::string> FileText::readLines()
 
 std::string FileText::readAll()
 {
-    u32 s = size();
+    u64 s = size();
     std::string ret;
     ret.resize( s );
     char* buf = const_cast<char*>( ret.c_str() );
@@ -89,7 +245,7 @@ std::string FileText::readLine()
     file_.seekg( position_ );
     std::string ret;
     std::getline( file_, ret );
-    position_ = static_cast<u32>( file_.tellg() );
+    position_ = static_cast<u64>( file_.tellg() );
     return ret;
 }
 
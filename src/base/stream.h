@@ -24,7 +24,7 @@ public:
     virtual ~BinaryStreamBase() {}
 
     //! Read raw bytes from stream
-    void readRaw( u8* dest, u32 size ) {
+    void readRaw( u8* dest, u64 size ) {
         T* pthis = static_cast<T*>( this );
         pthis->readImpl( dest, size, position_ );
         position_ += size;
@@ -46,7 +46,7 @@ public:
     }
 
     //! Write raw bytes to stream
-    void writeRaw( const u8* source, u32 size ) {
+    void writeRaw( const u8* source, u64 size ) {
         T* pthis = static_cast<T*>( this );
         pthis->writeImpl( source, size, position_ );
         position_ += size;
@@ -59,15 +59,15 @@ public:
         writeRaw( ptr, sizeof( value ) );
     }
 
-    u32 position() const {
+    u64 position() const {
         return position_;
     }
 
-    void setPosition( u32 position ) {
+    void setPosition( u64 position ) {
         position_ = position;
     }
 protected:
-    u32 position_;
+    u64 position_;
 };
 
 //! Binary file wrapper for input/output
@@ -78,14 +78,79 @@ class FileBinary : public BinaryStreamBase<FileBinary>
 public:
     FileBinary( const std::string& filename );
     virtual ~FileBinary();
-    u32 size();
+    u64 size();
 
 protected:
-    void readImpl( u8* dest, u32 size, u32 position );
-    void writeImpl( const u8* source, u32 size, u32 position );
+    void readImpl( u8* dest, u64 size, u64 position );
+    void writeImpl( const u8* source, u64 size, u64 position );
 
 protected:
     std::fstream file_;
+    //! Position of underlying stream, seek only when it differs
+    u64 filePosition_;
+    //! Last operation was write, switching between read and write always seeks
+    bool writing_;
+};
+
+//! Read-only memory mapped file
+//! Gives pointers into mapped pages, so parsers read without copies
+class MappedFile : public BinaryStreamBase<MappedFile>
+{
+    friend class BinaryStreamBase<MappedFile>;
+
+public:
+    //! Access pattern hint (madvise)
+    enum class Access {
+        Normal, Sequential, Random, WillNeed
+    };
+
+    MappedFile( const std::string& filename, Access access = Access::Sequential );
+    virtual ~MappedFile();
+
+    bool isOpen() const {
+        return opened_;
+    }
+
+    u64 size() const {
+        return size_;
+    }
+
+    //! Returns start of mapping, nullptr for empty or not opened file
+    const u8* data() const {
+        return data_;
+    }
+
+    //! Returns pointer to [offset, offset + size) range or nullptr if it is out of file
+    const u8* view( u64 offset, u64 size ) const {
+        if ( offset > size_ || size > size_ - offset )
+            return nullptr;
+        return data_ + offset;
+    }
+
+    //! Returns pointer at current position and advances it, no copy
+    const u8* readView( u64 size ) {
+        const u8* ret = view( position_, size );
+        if ( ret != nullptr )
+            position_ += size;
+        return ret;
+    }
+
+    //! Changes access hint for range, whole file if size is 0
+    void advise( Access access, u64 offset = 0, u64 size = 0 );
+
+protected:
+    void readImpl( u8* dest, u64 size, u64 position );
+
+private:
+    const u8* data_;
+    u64 size_;
+    bool opened_;
+#ifdef OS_WIN
+    void* file_;
+    void* mapping_;
+#endif
+
+    DISALLOW_COPY_AND_ASSIGN( MappedFile );
 };
 
 //! Text file wrapper for not-formatted reading 
@@ -110,19 +175,19 @@ public:
     //! Gets the character at the current position, and advances current position 
     char bumpChar();
 
-    u32 position() const {
+    u64 position() const {
         return position_;
     }
 
-    u32 size() const {
+    u64 size() const {
         return size_;
     }
 
 protected:
     std::fstream file_;
     std::streambuf* sb_;
-    u32 size_;
-    u32 position_;
+    u64 size_;
+    u64 position_;
 };
 
 } // namespace base
@@ -0,0 +1,88 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "base/stringid.h"
+#include "base/log.h"
+#include "base/debug.h"
+#include <mutex>
+#include <unordered_map>
+#include <stdio.h>
+
+namespace base {
+
+namespace {
+
+struct StringTable
+{
+    std::mutex lock;
+    std::unordered_map<u64, std::string> strings;
+    std::unordered_map<u64, std::string> hashes;    //!< printed ids which have no string
+};
+
+StringTable& stringTable()
+{
+    static StringTable table;
+    return table;
+}
+
+} // namespace
+
+StringId::StringId(const char* s)
+{
+    id_ = hash(s);
+    intern(id_, s);
+}
+
+StringId::StringId(const std::string& s)
+{
+    id_ = hash(s.c_str());
+    intern(id_, s.c_str());
+}
+
+u64 StringId::hash(const char* s, u64 seed)
+{
+    u64 h = seed;
+    for (; *s != '\0'; ++s)
+        h = (h ^ static_cast<u8>(*s)) * 1099511628211ULL;
+    return h;
+}
+
+void StringId::intern(u64 id, const char* s)
+{
+    StringTable& table = stringTable();
+    std::lock_guard<std::mutex> guard(table.lock);
+    auto it = table.strings.find(id);
+    if (it == table.strings.end()) {
+        table.strings.insert(std::make_pair(id, std::string(s)));
+        return;
+    }
+#ifdef _DEBUG
+    if (it->second != s) {
+        ERR("string id collision: '%s' and '%s'", it->second.c_str(), s);
+        ASSERT(false);
+    }
+#endif
+}
+
+const char* StringId::c_str() const
+{
+    StringTable& table = stringTable();
+    std::lock_guard<std::mutex> guard(table.lock);
+    auto it = table.strings.find(id_);
+    if (it != table.strings.end())
+        return it->second.c_str();
+    if (id_ == 0)
+        return "";
+    // release STRING_ID does not register literals, messages still tell which id it is
+    auto printed = table.hashes.find(id_);
+    if (printed == table.hashes.end()) {
+        char buffer[20];
+        snprintf(buffer, sizeof(buffer), "#%016llx", static_cast<unsigned long long>(id_));
+        printed = table.hashes.insert(std::make_pair(id_, std::string(buffer))).first;
+    }
+    return printed->second.c_str();
+}
+
+} // namespace base
@@ -0,0 +1,98 @@
+/**
+ * \file
+ * \brief       interned strings with stable hashed identifiers
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+#include <string>
+#include <type_traits>
+
+namespace base {
+
+//! 64-bit FNV-1a, usable in constant expressions
+//! hashString64(b, hashString64(a)) == hashString64(a + b)
+constexpr u64 hashString64(const char* s, u64 h = 14695981039346656037ULL) {
+    return *s == '\0' ? h : hashString64(s + 1, (h ^ static_cast<u8>(*s)) * 1099511628211ULL);
+}
+
+//! 32-bit FNV-1a, usable in constant expressions
+constexpr u32 hashString32(const char* s, u32 h = 2166136261u) {
+    return *s == '\0' ? h : hashString32(s + 1, (h ^ static_cast<u8>(*s)) * 16777619u);
+}
+
+//! Identifier of interned string
+//!
+//! Strings given at runtime are hashed and stored in global table,
+//! so c_str() works for them. STRING_ID hashes literals at compile time
+//! and only registers them in debug builds, where hash collisions
+//! between different strings are reported. Each STRING_ID registers
+//! its literal once, on first use, so it is cheap in per-draw code too.
+class StringId
+{
+public:
+    StringId() : id_(0) {}
+    NEGINE_API StringId(const char* s);
+    NEGINE_API StringId(const std::string& s);
+
+    //! Id of literal hashed at compile time, see STRING_ID
+    StringId(u64 id, const char* s) : id_(id) {
+#ifdef _DEBUG
+        intern(id, s);
+#endif
+    }
+
+    //! Restores id from value, string is not known
+    static StringId fromValue(u64 id) {
+        StringId ret;
+        ret.id_ = id;
+        return ret;
+    }
+
+    u64 value() const { return id_; }
+
+    //! Folded 32-bit id, stable between runs as well
+    u32 value32() const { return static_cast<u32>(id_ ^ (id_ >> 32)); }
+
+    bool isEmpty() const { return id_ == 0; }
+
+    //! Returns interned string, hash as "#" and 16 hex digits if id was not
+    //! interned, "" for empty id
+    NEGINE_API const char* c_str() const;
+
+    bool operator==(const StringId& s) const { return id_ == s.id_; }
+    bool operator!=(const StringId& s) const { return id_ != s.id_; }
+    bool operator<(const StringId& s) const { return id_ < s.id_; }
+
+    //! Hashes string at runtime (same value as hashString64)
+    NEGINE_API static u64 hash(const char* s, u64 seed = 14695981039346656037ULL);
+
+private:
+    NEGINE_API static void intern(u64 id, const char* s);
+
+    u64 id_;
+};
+
+#ifdef _DEBUG
+#define STRING_ID(str) \
+    ([]() -> ::base::StringId { \
+        static const ::base::StringId id(std::integral_constant< ::base::u64, ::base::hashString64(str)>::value, str); \
+        return id; \
+    }())
+#else
+#define STRING_ID(str) \
+    ::base::StringId(std::integral_constant< ::base::u64, ::base::hashString64(str)>::value, str)
+#endif
+
+} // namespace base
+
+namespace std {
+template<>
+struct hash<base::StringId> {
+    size_t operator()(const base::StringId& s) const {
+        return static_cast<size_t>(s.value());
+    }
+};
+}
@@ -5,74 +5,192 @@
  **/
 #include "base/timer.h"
 #include "base/log.h"
+#include <mutex>
 
 #ifdef OS_WIN
 # include <windows.h>
 #endif
 #ifdef OS_UNIX
-# include <sys/time.h>
+# include <time.h>
+#endif
+#if defined(OS_CPU_X86) && !defined(COMPILER_MSVC)
+# include <cpuid.h>
 #endif
 
 namespace base
 {
 
-Timer::Timer()
+namespace {
+
+//! TSC is usable when it ticks with constant rate in all power states
+bool detectInvariantTsc()
 {
-    startTime_ = getClock();
+#if defined(OS_CPU_X86)
+    u32 regs[4] = { 0, 0, 0, 0 };
+# if defined(COMPILER_MSVC)
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if (static_cast<u32>(info[0]) < 0x80000007)
+        return false;
+    __cpuid(info, 0x80000007);
+    regs[3] = static_cast<u32>(info[3]);
+# else
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007)
+        return false;
+    __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+# endif
+    return (regs[3] & (1 << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+struct Calibration
+{
+    std::once_flag once;
+    u64 cycles;
+    u64 nanoseconds;
+    f64 cyclesPerNanosecond;
+};
+
+Calibration calibration_;
+
+void measureRate()
+{
+    const u64 period = 10 * 1000 * 1000;
+    u64 n0 = Clock::nanoseconds();
+    u64 c0 = Clock::cycles();
+    u64 n1, c1;
+    do {
+        n1 = Clock::nanoseconds();
+        c1 = Clock::cycles();
+    } while (n1 - n0 < period);
+    calibration_.cycles = c0;
+    calibration_.nanoseconds = n0;
+    calibration_.cyclesPerNanosecond = static_cast<f64>(c1 - c0) / static_cast<f64>(n1 - n0);
+}
+
+} // namespace
+
+bool Clock::tsc_ = detectInvariantTsc();
+
 #ifdef OS_WIN
-    LARGE_INTEGER freq;
-    if ( QueryPerformanceFrequency( &freq ) == FALSE )
-    {
+
+u64 Clock::nanoseconds()
+{
+    static LARGE_INTEGER frequency = { 0 };
+    if (frequency.QuadPart == 0 && QueryPerformanceFrequency(&frequency) == FALSE) {
         ERR("QueryPerformanceFrequency fails");
         abort();
     }
-    frequency_ = freq.QuadPart;
-#else
-    frequency_ = 0;
+    LARGE_INTEGER time;
+    QueryPerformanceCounter(&time);
+    // split to avoid overflow of time * 1e9
+    u64 f = frequency.QuadPart;
+    u64 t = time.QuadPart;
+    return (t / f) * 1000000000ULL + (t % f) * 1000000000ULL / f;
+}
+
+#elif defined(OS_UNIX)
+
+u64 Clock::nanoseconds()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<u64>(time.tv_sec) * 1000000000ULL + time.tv_nsec;
+}
+
 #endif
+
+void Clock::calibrate()
+{
+    if (!tsc_)
+        return;
+    std::call_once(calibration_.once, measureRate);
 }
 
-f32 Timer::reset()
+u64 Clock::cyclesToNanoseconds(u64 cycles)
 {
-    u64 new_time = getClock();
-    f32 elapsed = static_cast<f32>( convertToMillis( new_time - startTime_ ) );
-    startTime_ = new_time;
-    return elapsed;
+    if (!tsc_)
+        return cycles;
+    calibrate();
+    f64 delta = static_cast<f64>(static_cast<i64>(cycles - calibration_.cycles));
+    return calibration_.nanoseconds + static_cast<i64>(delta / calibration_.cyclesPerNanosecond);
 }
 
-f32 Timer::elapsed() const
+u64 Clock::cyclesToDuration(u64 cycles)
 {
-    return static_cast<f32>( convertToMillis( getClock() - startTime_ ) );
+    if (!tsc_)
+        return cycles;
+    calibrate();
+    return static_cast<u64>(cycles / calibration_.cyclesPerNanosecond);
 }
 
-#ifdef OS_WIN
+ClockSelfTest Clock::selfTest(u32 milliseconds)
+{
+    const u32 calls = 100000;
+    ClockSelfTest result;
+    calibrate();
+    result.tsc = tsc_;
+    result.cyclesPerNanosecond = tsc_ ? calibration_.cyclesPerNanosecond : 1.0;
+
+    volatile u64 sink = 0;
+    u64 start = nanoseconds();
+    for (u32 i = 0; i < calls; i++)
+        sink = sink + nanoseconds();
+    result.nanosecondsOverhead = static_cast<f64>(nanoseconds() - start) / calls;
+
+    start = nanoseconds();
+    for (u32 i = 0; i < calls; i++)
+        sink = sink + cycles();
+    result.cyclesOverhead = static_cast<f64>(nanoseconds() - start) / calls;
+
+    // both clocks measure the same interval
+    u64 n0 = nanoseconds();
+    u64 c0 = cycles();
+    u64 period = static_cast<u64>(milliseconds) * 1000000ULL;
+    u64 n1, c1;
+    do {
+        n1 = nanoseconds();
+        c1 = cycles();
+    } while (n1 - n0 < period);
+    f64 byCycles = static_cast<f64>(cyclesToDuration(c1 - c0));
+    f64 byClock = static_cast<f64>(n1 - n0);
+    result.driftPpm = (byCycles - byClock) / byClock * 1e6;
+    return result;
+}
 
-u64 Timer::getClock() const
+Timer::Timer()
 {
-    LARGE_INTEGER time;
-    QueryPerformanceCounter(&time);
-    return time.QuadPart;
+    startTime_ = Clock::nanoseconds();
 }
 
-f64 Timer::convertToMillis( u64 range ) const
+f32 Timer::reset()
 {
-    return range / ( frequency_ / 1000.0 );
+    return static_cast<f32>( resetNanoseconds() / 1e6 );
 }
 
-#elif defined(OS_UNIX)
+f32 Timer::elapsed() const
+{
+    return static_cast<f32>( elapsedNanoseconds() / 1e6 );
+}
 
-u64 Timer::getClock() const
+u64 Timer::resetNanoseconds()
 {
-    timeval time;
-    gettimeofday( &time, nullptr );
-    return time.tv_sec * 1000000 + time.tv_usec;
+    u64 now = Clock::nanoseconds();
+    u64 elapsed = now - startTime_;
+    startTime_ = now;
+    return elapsed;
 }
 
-f64 Timer::convertToMillis( u64 range ) const
+u64 Timer::elapsedNanoseconds() const
 {
-    return range / 1000.0;
+    return Clock::nanoseconds() - startTime_;
 }
 
-#endif
+f64 Timer::elapsedSeconds() const
+{
+    return elapsedNanoseconds() / 1e9;
+}
 
 } // namespace base
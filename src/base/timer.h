@@ -8,32 +8,88 @@
 
 #include "base/types.h"
 
+#if defined(OS_CPU_X86)
+# if defined(COMPILER_MSVC)
+#  include <intrin.h>
+# else
+#  include <x86intrin.h>
+# endif
+#endif
+
 namespace base
 {
 
-//! Timer class, count time in seconds (with decimal part)
-//! TODO: add f64 time return
+//! Result of Clock::selfTest
+struct ClockSelfTest
+{
+    f64 nanosecondsOverhead;    //!< cost of Clock::nanoseconds() call, ns
+    f64 cyclesOverhead;         //!< cost of Clock::cycles() call, ns
+    f64 cyclesPerNanosecond;    //!< calibrated cycle counter rate
+    f64 driftPpm;               //!< difference of cycle based and monotonic time, ppm
+    bool tsc;                   //!< cycle counter is TSC
+};
+
+//! Monotonic clock
+//!
+//! nanoseconds() is the system monotonic clock, cycles() reads the CPU
+//! cycle counter (invariant TSC on x86) and costs a few nanoseconds,
+//! cyclesToNanoseconds() converts it to the same time line.
+//! When TSC is not available or not invariant, cycles are nanoseconds
+class Clock
+{
+public:
+    //! Returns monotonic time in nanoseconds
+    NEGINE_API static u64 nanoseconds();
+
+    //! Returns raw cycle counter, use for very short scopes
+    static u64 cycles() {
+#if defined(OS_CPU_X86)
+        if (tsc_)
+            return __rdtsc();
+#endif
+        return nanoseconds();
+    }
+
+    //! Converts cycles() value to nanoseconds() time
+    NEGINE_API static u64 cyclesToNanoseconds(u64 cycles);
+
+    //! Converts difference of cycles() values to nanoseconds
+    NEGINE_API static u64 cyclesToDuration(u64 cycles);
+
+    //! Measures cycle counter rate against monotonic clock,
+    //! it is done once, before the first conversion
+    NEGINE_API static void calibrate();
+
+    //! Measures call overhead and drift of cycle counter over given time
+    NEGINE_API static ClockSelfTest selfTest(u32 milliseconds = 100);
+
+private:
+    NEGINE_API static bool tsc_;
+};
+
+//! Timer class, counts time from construction or last reset
 class NEGINE_API Timer
 {
 public:
     Timer();
 
-    //! Reset timer to zero, returns current elapsed time in seconds
+    //! Reset timer to zero, returns elapsed time in milliseconds
     f32 reset();
 
     //! Returns current elapsed time in milliseconds
     f32 elapsed() const;
 
-private:
-    //! Gets current timer value
-    u64 getClock() const;
-    
-    //! Convert internal representation to milliseconds
-    f64 convertToMillis( u64 range ) const;
+    //! Reset timer to zero, returns elapsed time in nanoseconds
+    u64 resetNanoseconds();
+
+    //! Returns current elapsed time in nanoseconds
+    u64 elapsedNanoseconds() const;
+
+    //! Returns current elapsed time in seconds
+    f64 elapsedSeconds() const;
 
 private:
-    u64 startTime_;
-    u64 frequency_;
+    u64 startTime_;     //!< nanoseconds
 };
 
-} // namespace base
\ No newline at end of file
+} // namespace base
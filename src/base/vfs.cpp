@@ -0,0 +1,128 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "base/vfs.h"
+#include "base/pack.h"
+#include "base/lz.h"
+#include "base/env.h"
+#include "base/log.h"
+
+namespace base {
+namespace vfs {
+
+namespace {
+
+struct Mount
+{
+    std::unique_ptr<PackFile> pack;
+    std::string prefix;     //!< normalized mount point with trailing '/'
+};
+
+std::vector<Mount> mounts_;
+
+//! Finds entry in the last mounted pack which has it
+const PackEntry* resolve(const std::string& path, const PackFile** pack)
+{
+    if (mounts_.empty())
+        return nullptr;
+    std::string key = PackFile::normalize(path);
+    for (auto it = mounts_.rbegin(); it != mounts_.rend(); ++it) {
+        const std::string& prefix = it->prefix;
+        if (key.compare(0, prefix.size(), prefix) != 0)
+            continue;
+        const PackEntry* entry = it->pack->find(prefix.empty() ? key : key.substr(prefix.size()));
+        if (entry != nullptr) {
+            *pack = it->pack.get();
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool mount(const std::string& packFile, const std::string& mountPoint)
+{
+    Mount m;
+    m.pack.reset(new PackFile(packFile));
+    if (!m.pack->isOpen()) {
+        ERR("vfs: can't mount %s", packFile.c_str());
+        return false;
+    }
+    m.prefix = PackFile::normalize(mountPoint);
+    if (!m.prefix.empty() && m.prefix.back() != '/')
+        m.prefix.push_back('/');
+    LOG("vfs: mounted %s (%u files)", packFile.c_str(), m.pack->count());
+    mounts_.push_back(std::move(m));
+    return true;
+}
+
+void unmountAll()
+{
+    mounts_.clear();
+}
+
+u32 mountCount()
+{
+    return static_cast<u32>(mounts_.size());
+}
+
+bool exists(const std::string& path)
+{
+    const PackFile* pack = nullptr;
+    return resolve(path, &pack) != nullptr || env::fileExists(path);
+}
+
+bool packed(const std::string& path, u64* size)
+{
+    const PackFile* pack = nullptr;
+    const PackEntry* entry = resolve(path, &pack);
+    if (entry != nullptr && size != nullptr)
+        *size = entry->size;
+    return entry != nullptr;
+}
+
+File::File(const std::string& path)
+    : data_(nullptr)
+    , size_(0)
+    , opened_(false)
+{
+    const PackFile* pack = nullptr;
+    const PackEntry* entry = resolve(path, &pack);
+    if (entry == nullptr) {
+        loose_.reset(new MappedFile(path, MappedFile::Access::Sequential));
+        opened_ = loose_->isOpen();
+        data_ = loose_->data();
+        size_ = loose_->size();
+        return;
+    }
+    const u8* payload = pack->payload(*entry);
+    if (payload == nullptr) {
+        ERR("vfs: %s is out of pack", path.c_str());
+        return;
+    }
+    if ((entry->flags & PackEntry::Compressed) == 0) {
+        data_ = payload;
+        size_ = entry->size;
+        opened_ = true;
+        return;
+    }
+    buffer_.resize(static_cast<size_t>(entry->size));
+    if (!lz::decompress(payload, static_cast<u32>(entry->storedSize), buffer_.data(), static_cast<u32>(entry->size))) {
+        ERR("vfs: %s is corrupted", path.c_str());
+        buffer_.clear();
+        return;
+    }
+    data_ = buffer_.data();
+    size_ = entry->size;
+    opened_ = true;
+}
+
+File::~File()
+{
+}
+
+} // namespace vfs
+} // namespace base
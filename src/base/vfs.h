@@ -0,0 +1,57 @@
+/**
+ * \file
+ * \brief       virtual file system over mounted packs and loose files
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "base/stream.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace base {
+namespace vfs {
+
+//! Maps pack, its files are visible under mountPoint ("" for root).
+//! Packs mounted later shadow earlier ones. Mounting is not synchronized
+//! with lookups, it is done at startup
+NEGINE_API bool mount(const std::string& packFile, const std::string& mountPoint = "");
+//! Unmaps all packs
+NEGINE_API void unmountAll();
+NEGINE_API u32 mountCount();
+
+//! Checks packs, then disk
+NEGINE_API bool exists(const std::string& path);
+//! Checks only mounted packs, gives unpacked size of found entry
+NEGINE_API bool packed(const std::string& path, u64* size = nullptr);
+
+//! Read-only view of file contents: points into mapped pack for stored
+//! entries, owns decompressed copy for compressed ones, and maps loose
+//! file when path is not packed
+class File
+{
+public:
+    NEGINE_API explicit File(const std::string& path);
+    NEGINE_API ~File();
+
+    bool isOpen() const { return opened_; }
+    const u8* data() const { return data_; }
+    u64 size() const { return size_; }
+    //! File is found in a pack
+    bool packed() const { return loose_ == nullptr; }
+
+private:
+    const u8* data_;
+    u64 size_;
+    bool opened_;
+    std::vector<u8> buffer_;
+    std::unique_ptr<MappedFile> loose_;
+
+    DISALLOW_COPY_AND_ASSIGN(File);
+};
+
+} // namespace vfs
+} // namespace base
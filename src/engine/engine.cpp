@@ -7,6 +7,15 @@
 #include "foundation/memory.h"
 #include "physics/physics.h"
 #include "game/scene.h"
+#include "base/profiler.h"
+#include "base/log.h"
+#include "base/jobs.h"
+#include "base/frameallocator.h"
+#include "base/memorytags.h"
+#include "base/io.h"
+#include "base/vfs.h"
+#include "base/env.h"
+#include "base/cpu.h"
 
 namespace base {
 
@@ -26,8 +35,27 @@ game::Scene& Engine::scene() {
     return *(instance().scene_);
 }
 
+FrameAllocator& Engine::frameAllocator() {
+    return *(instance().frameAllocator_);
+}
+
+void Engine::beginFrame() {
+    memory::endFrame();
+    instance().frameAllocator_->beginFrame();
+    io::poll();
+}
+
 Engine::Engine() {
-    foundation::memory_globals::init();
+    memory::init();
+    frameAllocator_ = new FrameAllocator(memory::allocator(MemoryTag::Scratch), 1024 * 1024);
+    Profiler::init();
+    startAsyncLog();
+    LOG("cpu kernels: %s", cpu::tierName(cpu::tier()));
+    jobs::init();
+    io::init();
+    std::string pack = env::variable("NEGINE_PACK", "data.pack");
+    if (env::fileExists(pack))
+        vfs::mount(pack);
     ResourceManager::addFactory(Model::Type(), [](const std::string& p) { 
         Model* model = loadModel(p);
         return dynamic_cast<Resource*>(model);
@@ -39,7 +67,7 @@ Engine::Engine() {
     //    Texture* texture = loadTexture(Engine::context(), defaultSettings, p);
     //    return dynamic_cast<Resource*>(texture);
     //});
-    renderer_ = new Renderer();
+    renderer_ = new Renderer(*frameAllocator_);
     physics_ = new phys::Physics();
     scene_ = new game::Scene();
 }
@@ -48,8 +76,14 @@ Engine::~Engine() {
     delete physics_;
     delete renderer_;
     delete scene_;
+    io::shutdown();
+    vfs::unmountAll();
+    jobs::shutdown();
     ResourceManager::shutdown();
-    foundation::memory_globals::shutdown();
+    Profiler::shutdown();
+    stopAsyncLog();
+    delete frameAllocator_;
+    memory::shutdown();
 }
 
 } // namespace base
\ No newline at end of file
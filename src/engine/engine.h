@@ -8,6 +8,7 @@ namespace base {
 namespace opengl { struct Renderer; }
 namespace phys { class Physics; }
 namespace game { class Scene; }
+class FrameAllocator;
 
 class Engine : public Singleton<Engine> {
 public:
@@ -17,10 +18,16 @@ public:
     NEGINE_API static opengl::Renderer& renderer();
     NEGINE_API static phys::Physics& physics();
     NEGINE_API static game::Scene& scene();
+    //! Transient memory, valid until the end of the next frame
+    NEGINE_API static FrameAllocator& frameAllocator();
+
+    //! Resets per-frame state, call it at the start of every frame
+    NEGINE_API static void beginFrame();
 private:
     opengl::Renderer* renderer_;
     phys::Physics* physics_;
     game::Scene* scene_;
+    FrameAllocator* frameAllocator_;
 };
 
 } // namespace base
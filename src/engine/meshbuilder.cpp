@@ -2,6 +2,7 @@
 #include "base/log.h"
 #include "base/debug.h"
 #include "render/mesh.h"
+#include "base/memorytags.h"
 
 namespace base {
 namespace imp {
@@ -11,14 +12,14 @@ using namespace foundation;
 
 MeshBuilder::MeshBuilder()
     : mask(0)
-    , posData(memory_globals::default_allocator())
-    , normalData(memory_globals::default_allocator())
-    , uvData(memory_globals::default_allocator())
-    , colorData(memory_globals::default_allocator())
-    , surfaces(memory_globals::default_allocator())
-    , vertexList(memory_globals::default_allocator())
-    , polygonList(memory_globals::default_allocator())
-    , lineList(memory_globals::default_allocator())
+    , posData(base::memory::allocator(MemoryTag::Resources))
+    , normalData(base::memory::allocator(MemoryTag::Resources))
+    , uvData(base::memory::allocator(MemoryTag::Resources))
+    , colorData(base::memory::allocator(MemoryTag::Resources))
+    , surfaces(base::memory::allocator(MemoryTag::Resources))
+    , vertexList(base::memory::allocator(MemoryTag::Resources))
+    , polygonList(base::memory::allocator(MemoryTag::Resources))
+    , lineList(base::memory::allocator(MemoryTag::Resources))
 {
 }
 
@@ -1,12 +1,16 @@
 #include "model_loader.h"
 #include "base/log.h"
 #include "engine/resourceref.h"
+#include "base/vfs.h"
+#include "base/path.h"
+#include "render/vertexformat.h"
 
 #include <assimp/cimport.h>
 #include <assimp/Logger.hpp>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <string.h>
 
 class AiLog : public Assimp::Logger
 {
@@ -40,9 +44,23 @@ using namespace Assimp;
 
 class Importer {
 public:
-    Importer(const std::string& filename) {
+    Importer(const std::string& filename) : scene_(nullptr) {
         DefaultLogger::set(new AiLog);
-        scene_ = aiImportFile(filename.c_str(), 0);
+        if (vfs::packed(filename)) {
+            vfs::File file(filename);
+            if (!file.isOpen()) {
+                ERR("model: can't read %s from pack", filename.c_str());
+                return;
+            }
+            // extension is the only format hint for memory import
+            std::string ext = std::get<1>(path::splitext(filename));
+            if (!ext.empty() && ext[0] == '.')
+                ext = ext.substr(1);
+            scene_ = aiImportFileFromMemory(reinterpret_cast<const char*>(file.data()),
+                static_cast<unsigned int>(file.size()), 0, ext.c_str());
+        } else {
+            scene_ = aiImportFile(filename.c_str(), 0);
+        }
     }
     bool importOk() const {
         return scene_ != nullptr && scene_->mRootNode != nullptr;
@@ -84,7 +102,7 @@ Model* loadModel(const std::string& filename)
         Model::Surface& surface = model->beginSurface();
         Mesh& m = surface.mesh;
 
-        m.material_ = ResourceRef("default_material");
+        m.material_ = ResourceRef(STRING_ID("default_material"));
 
         if (subMesh->HasPositions())
             m.addAttribute(VertexAttrs::tagPosition);
@@ -92,21 +110,20 @@ Model* loadModel(const std::string& filename)
             m.addAttribute(VertexAttrs::tagNormal);
         m.vertexCount(subMesh->mNumVertices);
         m.indexCount(subMesh->mNumFaces * 3, IndexTypes::UInt32);
+        // half of float size on GPU, indices are narrowed on upload when they fit.
+        // Positions stay float when half would move vertices of mesh visibly
+        VertexLayout layout = VertexLayout::compact();
+        if (subMesh->HasPositions())
+            layout.formats[VertexAttrs::tagPosition] = VertexFormats::PositionFormat(reinterpret_cast<const f32*>(subMesh->mVertices), subMesh->mNumVertices);
+        m.vertexLayout(layout);
         m.complete();
-        if (subMesh->HasPositions()) {
-            math::vec3f* posData = m.findAttribute<math::vec3f>(VertexAttrs::tagPosition);
-            for(u32 j=0; j<subMesh->mNumVertices; j++) {
-                const aiVector3D& p = subMesh->mVertices[j];
-                posData[j] = math::vec3f(p.x, p.y, p.z);
-            }
-        }
-        if (subMesh->HasNormals()) {
-            math::vec3f* normData = m.findAttribute<math::vec3f>(VertexAttrs::tagNormal);
-            for(u32 j=0; j<subMesh->mNumVertices; j++) {
-                const aiVector3D& p = subMesh->mNormals[j];
-                normData[j] = math::vec3f(p.x, p.y, p.z);
-            }
-        }
+        // aiVector3D arrays have the same layout as vec3f streams
+        static_assert(sizeof(aiVector3D) == sizeof(math::vec3f), "aiVector3D is not three floats");
+        const size_t streamSize = subMesh->mNumVertices * sizeof(math::vec3f);
+        if (subMesh->HasPositions())
+            memcpy(m.findAttribute<math::vec3f>(VertexAttrs::tagPosition), subMesh->mVertices, streamSize);
+        if (subMesh->HasNormals())
+            memcpy(m.findAttribute<math::vec3f>(VertexAttrs::tagNormal), subMesh->mNormals, streamSize);
         u32* indices = reinterpret_cast<u32*>(m.indices());
         for(u32 f=0; f<subMesh->mNumFaces; f++)
         {
@@ -118,6 +135,7 @@ Model* loadModel(const std::string& filename)
 
         model->endSurface();
     }
+    model->done();
 
     return model;
 }
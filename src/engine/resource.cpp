@@ -15,15 +15,15 @@ ResourceManager::ResourceManager() {
     typeCounter_ = 0;
 }
 
-Resource* ResourceManager::get(std::size_t uri) {
+Resource* ResourceManager::get(u64 uri) {
     return instance().selfGet(uri);
 }
 
-void ResourceManager::set(std::size_t uri, Resource* res) {
+void ResourceManager::set(u64 uri, Resource* res) {
     instance().selfSet(uri, res);
 }
 
-void ResourceManager::destroy(std::size_t uri) {
+void ResourceManager::destroy(u64 uri) {
     instance().selfDestroy(uri);
 }
 
@@ -45,7 +45,7 @@ void ResourceManager::addFactory(u32 type, ResourceFactoryFunc factory) {
     factories[type] = factory;
 }
 
-Resource* ResourceManager::loadDefault(u32 type, std::size_t uri, const std::string& path) {
+Resource* ResourceManager::loadDefault(u32 type, u64 uri, const std::string& path) {
     ResourceManager& manager = instance();
     FactoryMap& factories = manager.factories_;
     FactoryMap::const_iterator it = factories.find(type);
@@ -56,18 +56,18 @@ Resource* ResourceManager::loadDefault(u32 type, std::size_t uri, const std::str
     return resource;
 }
 
-Resource* ResourceManager::selfGet(std::size_t uri) {
+Resource* ResourceManager::selfGet(u64 uri) {
     ResourceMap::const_iterator it = resources_.find(uri);
     ASSERT(it != resources_.end());
     return it->second;
 }
 
-void ResourceManager::selfSet(std::size_t uri, Resource* res) {
+void ResourceManager::selfSet(u64 uri, Resource* res) {
     ASSERT(resources_.find(uri) == resources_.end());
     resources_[uri] = res;
 }
 
-void ResourceManager::selfDestroy(std::size_t uri) {
+void ResourceManager::selfDestroy(u64 uri) {
     ResourceMap::iterator it = resources_.find(uri);
     ASSERT(it != resources_.end());
     delete it->second;
@@ -30,25 +30,25 @@ typedef std::function<Resource*(const std::string& name)> ResourceFactory;
 
 class ResourceManager {
 public:
-    static Resource* get(std::size_t uri);
-    static void set(std::size_t uri, Resource* res);
-    static void destroy(std::size_t uri);
+    static Resource* get(u64 uri);
+    static void set(u64 uri, Resource* res);
+    static void destroy(u64 uri);
 
     static void init();
     static void shutdown();
     NEGINE_API static u32 registerResource();
     NEGINE_API static void addFactory(u32 type, ResourceFactoryFunc factory);
 
-    NEGINE_API static Resource* loadDefault(u32 type, std::size_t uri, const std::string& path);
+    NEGINE_API static Resource* loadDefault(u32 type, u64 uri, const std::string& path);
 private:
     static ResourceManager& instance();
     ResourceManager();
 
-    Resource* selfGet(std::size_t uri);
-    void selfSet(std::size_t uri, Resource* res);
-    void selfDestroy(std::size_t uri);
+    Resource* selfGet(u64 uri);
+    void selfSet(u64 uri, Resource* res);
+    void selfDestroy(u64 uri);
 
-    typedef std::map<std::size_t, Resource*> ResourceMap;
+    typedef std::map<u64, Resource*> ResourceMap;
     ResourceMap resources_;
 
     typedef std::map<u32, ResourceFactory> FactoryMap;
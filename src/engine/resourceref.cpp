@@ -3,35 +3,40 @@
 namespace base {
 
 ResourceRef::ResourceRef() {
-    hash_ = 0;
 }
 
-ResourceRef::ResourceRef(const std::string& uri) {
-    std::hash<std::string> h;
-    hash_ = h(uri);
+ResourceRef::ResourceRef(const char* uri)
+    : id_(uri) {
 }
 
-ResourceRef::ResourceRef(const std::string& uri, Resource* res) {
-    std::hash<std::string> h;
-    hash_ = h(uri);
+ResourceRef::ResourceRef(const std::string& uri)
+    : id_(uri) {
+}
+
+ResourceRef::ResourceRef(StringId uri)
+    : id_(uri) {
+}
+
+ResourceRef::ResourceRef(StringId uri, Resource* res)
+    : id_(uri) {
     setResource(res);
 }
 
 ResourceRef& ResourceRef::operator=(const ResourceRef& r) {
-    hash_ = r.hash_;
+    id_ = r.id_;
     return *this;
 }
 
 Resource* ResourceRef::resource() {
-    return ResourceManager::get(hash_);
+    return ResourceManager::get(id_.value());
 }
 
 void ResourceRef::setResource(Resource* res) {
-    ResourceManager::set(hash_, res);
+    ResourceManager::set(id_.value(), res);
 }
 
 void ResourceRef::destroy() {
-    ResourceManager::destroy(hash_);
+    ResourceManager::destroy(id_.value());
 }
 
 } // namespace base
\ No newline at end of file
@@ -2,20 +2,25 @@
 
 #include "base/types.h"
 #include "engine/resource.h"
+#include "base/stringid.h"
 
 namespace base {
 
 class ResourceRef {
 public:
     NEGINE_API ResourceRef();
+    NEGINE_API explicit ResourceRef(const char* uri);
     NEGINE_API explicit ResourceRef(const std::string& uri);
-    NEGINE_API ResourceRef(const std::string& uri, Resource* res);
+    NEGINE_API explicit ResourceRef(StringId uri);
+    NEGINE_API ResourceRef(StringId uri, Resource* res);
     NEGINE_API ResourceRef& operator=(const ResourceRef& r);
 
     NEGINE_API Resource* resource();
     NEGINE_API void setResource(Resource* res);
     NEGINE_API void destroy();
 
+    StringId id() const { return id_; }
+
     template<class T>
     T* resourceAs() {
         return dynamic_cast<T*>(resource());
@@ -23,10 +28,10 @@ public:
 
     template<class T>
     void loadDefault(const std::string& path) {
-        ResourceManager::loadDefault(T::Type(), hash_, path);
+        ResourceManager::loadDefault(T::Type(), id_.value(), path);
     }
 private:
-    std::size_t hash_;
+    StringId id_;
 };
 
 } // namespace base
\ No newline at end of file
@@ -7,6 +7,9 @@
 #include "base/path.h"
 #include "base/log.h"
 #include "base/debug.h"
+#include "base/stream.h"
+#include "base/io.h"
+#include "base/vfs.h"
 
 namespace base {
 
@@ -14,19 +17,30 @@ using namespace opengl;
 
 struct StbiImage {
     StbiImage(const std::string& path, TextureInfo& info) : buffer(NULL) {
-        buffer = stbi_load( path.c_str(), &info.Width, &info.Height, &info.ComponentCount, 0 );
+        // decode straight from mapped pages of pack or loose file
+        vfs::File file(path);
+        if (file.data() == nullptr) {
+            e("can't fopen", "Unable to open file");
+            return;
+        }
+        decode(file.data(), file.size(), info);
+    }
+    StbiImage(const u8* data, u64 size, TextureInfo& info) : buffer(NULL) {
+        decode(data, size, info);
     }
     ~StbiImage() {
         if (buffer != NULL)
             stbi_image_free(buffer);
     }
+    void decode(const u8* data, u64 size, TextureInfo& info) {
+        buffer = stbi_load_from_memory(data, static_cast<int>(size),
+            &info.Width, &info.Height, &info.ComponentCount, 0);
+    }
     u8* buffer;
     bool isOk() const { return buffer != NULL; }
 };
 
-Texture* loadTexture(opengl::DeviceContext& GL, const TextureInfo& defaultInfo, const std::string& path) {
-    TextureInfo info = defaultInfo;
-    StbiImage image(path, info);
+Texture* createTexture(opengl::DeviceContext& GL, TextureInfo& info, const StbiImage& image) {
     if (!image.isOk()) {
         ERR("Failed load image: %s", stbi_failure_reason());
         return nullptr;
@@ -46,4 +60,44 @@ Texture* loadTexture(opengl::DeviceContext& GL, const TextureInfo& defaultInfo,
     return texture;
 }
 
+struct AsyncTexture {
+    opengl::DeviceContext* GL;
+    TextureInfo info;
+    TextureCallback callback;
+    void* user;
+};
+
+void textureRead(io::Result& result) {
+    AsyncTexture* request = static_cast<AsyncTexture*>(result.user);
+    Texture* texture = nullptr;
+    if (result.status == io::Status::Ok)
+        texture = loadTexture(*request->GL, request->info, result.data, result.size);
+    else if (result.status != io::Status::Cancelled)
+        ERR("Failed read image: %s", result.path->c_str());
+    request->callback(texture, request->user);
+    delete request;
+}
+
+Texture* loadTexture(opengl::DeviceContext& GL, const TextureInfo& defaultInfo, const std::string& path) {
+    TextureInfo info = defaultInfo;
+    StbiImage image(path, info);
+    return createTexture(GL, info, image);
+}
+
+Texture* loadTexture(opengl::DeviceContext& GL, const TextureInfo& defaultInfo, const u8* data, u64 size) {
+    TextureInfo info = defaultInfo;
+    StbiImage image(data, size, info);
+    return createTexture(GL, info, image);
+}
+
+void loadTextureAsync(opengl::DeviceContext& GL, const TextureInfo& info, const std::string& path,
+    TextureCallback callback, void* user) {
+    AsyncTexture* request = new AsyncTexture;
+    request->GL = &GL;
+    request->info = info;
+    request->callback = callback;
+    request->user = user;
+    io::submit(io::Request(path, textureRead, request));
+}
+
 } // namespace base
\ No newline at end of file
@@ -7,4 +7,15 @@ namespace base {
 
 NEGINE_API opengl::Texture* loadTexture(opengl::DeviceContext& GL, const opengl::TextureInfo& info, const std::string& path);
 
+//! Decodes image file already read into memory
+NEGINE_API opengl::Texture* loadTexture(opengl::DeviceContext& GL, const opengl::TextureInfo& info, const u8* data, u64 size);
+
+//! Called with nullptr when file can't be read or decoded, or io is shut down first
+typedef void (*TextureCallback)(opengl::Texture* texture, void* user);
+
+//! Reads file by io service (packed or loose), decodes and creates texture when
+//! completion is delivered by io::poll() on the render thread
+NEGINE_API void loadTextureAsync(opengl::DeviceContext& GL, const opengl::TextureInfo& info, const std::string& path,
+    TextureCallback callback, void* user);
+
 } // namespace base
\ No newline at end of file
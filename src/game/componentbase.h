@@ -1,6 +1,7 @@
 #pragma once
 
 #include "base/types.h"
+#include "base/stringid.h"
 #include <string>
 
 namespace base {
@@ -17,7 +18,9 @@ public:
 
     inline std::string name() const { return name_; }
 
-    inline void setName(const std::string& name) { name_ = name; }
+    inline StringId id() const { return id_; }
+
+    inline void setName(const std::string& name) { name_ = name; id_ = StringId(name); }
 
     inline void setScene(Scene* scene) { scene_ = scene; }
 
@@ -26,6 +29,7 @@ public:
 protected:
     Scene* scene_;
     std::string name_;
+    StringId id_;
 };
 
 } // namespace game
@@ -7,7 +7,7 @@ namespace game {
 
 using namespace math;
 
-Camera::Camera() : parentTransfrom_(nullptr) {
+Camera::Camera() : parentTransfrom_(nullptr), parentConnection_(0) {
 }
 
 Camera::~Camera() {
@@ -39,15 +39,16 @@ void Camera::setZFar( f32 v ) {
 
 void Camera::setParent(Transform* transform) {
     if (parentTransfrom_ != nullptr)
-        parentTransfrom_->signal_.disconnect(name_ + Transform::extension());
+        parentTransfrom_->signal_.disconnect(parentConnection_);
     parentTransfrom_ = transform;
+    parentConnection_ = 0;
     if (parentTransfrom_ != nullptr)
-        parentTransfrom_->signal_.connect(name_ + Transform::extension(), std::bind(&Camera::update, this));
+        parentConnection_ = parentTransfrom_->signal_.connect<Camera, &Camera::update>(this);
 }
 
 void Camera::update() {
     if (parentTransfrom_ == nullptr) {
-        Transform* transform = scene_->getTyped<Transform>(name_);
+        Transform* transform = scene_->getTyped<Transform>(id_);
         if (transform == nullptr)
             return;
         setParent(transform);
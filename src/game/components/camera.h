@@ -3,6 +3,7 @@
 #include "game/componentbase.h"
 #include "math/matrix.h"
 #include "math/plane.h"
+#include "game/signal.h"
 
 namespace base {
 namespace game {
@@ -37,6 +38,7 @@ public:
     NEGINE_API void setParent(Transform* transform);
 private:
     Transform* parentTransfrom_;
+    Connection parentConnection_;
     math::Plane planes_[6];
     math::Matrix4 projection_;
     math::Matrix4 modelview_;
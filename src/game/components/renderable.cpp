@@ -11,7 +11,7 @@ opengl::Model* Renderable::model() {
 }
 
 math::Matrix4 Renderable::world() const {
-    Transform* tr = scene_->getTyped<Transform>(name_);
+    Transform* tr = scene_->getTyped<Transform>(id_);
     if (tr == nullptr)
         return math::Matrix4::Identity();
     return tr->world();
@@ -15,6 +15,7 @@ Transform::Transform() {
     up_ = math::vec3f(0, 1, 0);
     position_ = math::vec3f(0, 0, 0);
     parentTransform_ = nullptr;
+    parentConnection_ = 0;
 }
 
 Transform::~Transform() {
@@ -83,10 +84,11 @@ void Transform::setHead( f32 v ) {
 
 void Transform::setParent(Transform* parent) {
     if (parentTransform_ != nullptr)
-        parentTransform_->signal_.disconnect(name_ + Transform::extension());
+        parentTransform_->signal_.disconnect(parentConnection_);
     parentTransform_ = parent;
+    parentConnection_ = 0;
     if (parentTransform_ != nullptr)
-        parent->signal_.connect(name_ + Transform::extension(), std::bind(&Transform::update, this));
+        parentConnection_ = parent->signal_.connect<Transform, &Transform::update>(this);
 }
 
 } // namespace game
@@ -46,6 +46,7 @@ private:
     math::vec3f forward_, right_, up_;
     math::vec3f position_;
     Transform* parentTransform_;
+    Connection parentConnection_;
 };
 
 } // namespace game
@@ -4,6 +4,8 @@
 #include "foundation/collection_types.h"
 #include "foundation/hash.h"
 #include "game/componentbase.h"
+#include "base/stringid.h"
+#include "game/signal.h"
 #include <string>
 #include <functional>
 #include <map>
@@ -15,36 +17,6 @@ class Transform;
 class Camera;
 class Renderable;
 
-class HashStr {
-public:
-    HashStr(u64 seed) : seed_(seed) {}
-    NEGINE_API u64 operator()(const std::string& s) const;
-private:
-    u64 seed_;
-};
-
-class Signal {
-public:
-    typedef std::function<void()> Slot;
-
-    Signal() {}
-
-    void connect(const std::string& name, Slot slot) {
-        slots_[name] = slot;
-    }
-    void emit() {
-        for (auto it: slots_) {
-            Slot slot = it.second;
-            slot();
-        }
-    }
-    void disconnect(const std::string& name) {
-        slots_.erase(slots_.find(name));
-    }
-private:
-    std::map<std::string, Slot> slots_;
-};
-
 class Scene {
 public:
     NEGINE_API Scene();
@@ -52,46 +24,38 @@ public:
 
     template<class T>
     T* attach(const std::string& name, T* aspect) {
-        attachNamed(name, name + T::extension(), aspect);
-        attachTyped<T>(name, aspect);
+        aspect->setName(name);
+        StringId id = aspect->id();
+        attachNamed(id, componentId<T>(id), aspect);
+        attachTyped<T>(id, aspect);
         return aspect;
     }
 
     template<class T>
     void detach(const std::string& name, T* aspect) {
-        detachNamed(name, name + T::extension(), aspect);
-        detachTyped<T>(name, aspect);
+        StringId id(name);
+        detachNamed(id, componentId<T>(id), aspect);
+        detachTyped<T>(id, aspect);
     }
 
-    NEGINE_API void attachNamed(const std::string& name, const std::string& fullname, ComponentBase* aspect);
+    NEGINE_API void attachNamed(StringId name, u64 fullname, ComponentBase* aspect);
 
-    NEGINE_API void detachNamed(const std::string& name, const std::string& fullname, ComponentBase* aspect);
+    NEGINE_API void detachNamed(StringId name, u64 fullname, ComponentBase* aspect);
 
     template<class T>
-    T* getTyped(const std::string& name);
+    T* getTyped(StringId name);
 
-    template<>
-    Transform* getTyped<Transform>(const std::string& name) {
-        return foundation::hash::get(transforms_, hash_(name), (Transform*)nullptr);
+    //! Id of "name" + T::extension(), without building the string
+    template<class T>
+    static u64 componentId(StringId name) {
+        return StringId::hash(T::extension(), name.value());
     }
 private:
     template<class T>
-    void attachTyped(const std::string& name, T* aspect);
+    void attachTyped(StringId name, T* aspect);
 
-    template<>
-    void attachTyped<Transform>(const std::string& name, Transform* aspect) {
-        foundation::hash::set(transforms_, hash_(name), aspect);
-    }
-
-    template<>
-    void attachTyped<Camera>(const std::string& name, Camera* aspect) {
-        foundation::hash::set(cameras_, hash_(name), aspect);
-    }
-
-    template<>
-    void attachTyped<Renderable>(const std::string& name, Renderable* aspect) {
-        foundation::hash::set(renderables_, hash_(name), aspect);
-    }
+    template<class T>
+    void detachTyped(StringId name, T* aspect);
 public:
     foundation::Hash<ComponentBase*> componentByName_;
     foundation::Hash<ComponentBase*> componentByObject_;
@@ -99,9 +63,42 @@ public:
     foundation::Hash<Transform*> transforms_;
     foundation::Hash<Camera*> cameras_;
     foundation::Hash<Renderable*> renderables_;
-
-    HashStr hash_;
 };
 
+template<>
+inline Transform* Scene::getTyped<Transform>(StringId name) {
+    return foundation::hash::get(transforms_, name.value(), (Transform*)nullptr);
+}
+
+template<>
+inline void Scene::attachTyped<Transform>(StringId name, Transform* aspect) {
+    foundation::hash::set(transforms_, name.value(), aspect);
+}
+
+template<>
+inline void Scene::attachTyped<Camera>(StringId name, Camera* aspect) {
+    foundation::hash::set(cameras_, name.value(), aspect);
+}
+
+template<>
+inline void Scene::attachTyped<Renderable>(StringId name, Renderable* aspect) {
+    foundation::hash::set(renderables_, name.value(), aspect);
+}
+
+template<>
+inline void Scene::detachTyped<Transform>(StringId name, Transform* aspect) {
+    foundation::hash::remove(transforms_, name.value());
+}
+
+template<>
+inline void Scene::detachTyped<Camera>(StringId name, Camera* aspect) {
+    foundation::hash::remove(cameras_, name.value());
+}
+
+template<>
+inline void Scene::detachTyped<Renderable>(StringId name, Renderable* aspect) {
+    foundation::hash::remove(renderables_, name.value());
+}
+
 } // namespace game
 } // namespace base
\ No newline at end of file
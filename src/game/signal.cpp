@@ -0,0 +1,79 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "game/signal.h"
+
+namespace base {
+namespace game {
+
+namespace {
+
+inline u32 handleIndex(Connection connection) {
+    return (connection & 0xffff) - 1;
+}
+
+inline u16 handleGeneration(Connection connection) {
+    return static_cast<u16>(connection >> 16);
+}
+
+} // namespace
+
+Signal::Signal()
+    : freeHandle_(kNoHandle)
+#ifdef _DEBUG
+    , emitting_(false)
+#endif
+{
+}
+
+Connection Signal::connect(Function function, void* object)
+{
+    ASSERT(!emitting_);
+    u16 index;
+    if (freeHandle_ != kNoHandle) {
+        index = freeHandle_;
+        freeHandle_ = handles_[index].slot;
+    } else {
+        // last index is reserved, index + 1 has to fit in 16 bits
+        ASSERT(handles_.size() < kNoHandle - 1);
+        index = static_cast<u16>(handles_.size());
+        Handle handle = { 0, 1 };
+        handles_.push_back(handle);
+    }
+    Handle& handle = handles_[index];
+    handle.slot = static_cast<u16>(slots_.size());
+    Slot slot = { function, object, index };
+    slots_.push_back(slot);
+    return (static_cast<u32>(handle.generation) << 16) | (index + 1u);
+}
+
+bool Signal::connected(Connection connection) const
+{
+    u32 index = handleIndex(connection);
+    return connection != 0 && index < handles_.size()
+        && handles_[index].generation == handleGeneration(connection);
+}
+
+bool Signal::disconnect(Connection connection)
+{
+    ASSERT(!emitting_);
+    if (!connected(connection))
+        return false;
+    u32 index = handleIndex(connection);
+    Handle& handle = handles_[index];
+    // move the last slot into the hole
+    u16 hole = handle.slot;
+    slots_[hole] = slots_.back();
+    handles_[slots_[hole].handle].slot = hole;
+    slots_.pop_back();
+    // stale handles stop matching
+    handle.generation++;
+    handle.slot = freeHandle_;
+    freeHandle_ = static_cast<u16>(index);
+    return true;
+}
+
+} // namespace game
+} // namespace base
@@ -0,0 +1,85 @@
+/**
+ * \file
+ * \brief       delegate list with integer connection handles
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "base/debug.h"
+#include <vector>
+
+namespace base {
+namespace game {
+
+//! Handle of connection: slot index in low 16 bits, generation in high 16 bits.
+//! 0 is never returned, so it is used for "not connected"
+typedef u32 Connection;
+
+//! Signal keeps slots as contiguous array of function pointer and object
+//! pairs, so emit() only walks the array and does not allocate.
+//! Connections must not be changed from slots during emit()
+class Signal
+{
+public:
+    typedef void (*Function)(void* object);
+
+    NEGINE_API Signal();
+
+    NEGINE_API Connection connect(Function function, void* object);
+
+    //! Connects member function: signal.connect<Transform, &Transform::update>(this)
+    template<class T, void (T::*Method)()>
+    Connection connect(T* object) {
+        return connect(&invoke<T, Method>, object);
+    }
+
+    //! Returns false for stale or empty handle
+    NEGINE_API bool disconnect(Connection connection);
+    NEGINE_API bool connected(Connection connection) const;
+
+    void emit() const {
+#ifdef _DEBUG
+        emitting_ = true;
+#endif
+        for (const Slot& slot : slots_)
+            slot.function(slot.object);
+#ifdef _DEBUG
+        emitting_ = false;
+#endif
+    }
+
+    u32 size() const { return static_cast<u32>(slots_.size()); }
+
+private:
+    template<class T, void (T::*Method)()>
+    static void invoke(void* object) {
+        (static_cast<T*>(object)->*Method)();
+    }
+
+    struct Slot
+    {
+        Function function;
+        void* object;
+        u16 handle;         //!< index in handles_, to fix it after swap
+    };
+
+    struct Handle
+    {
+        u16 slot;           //!< index in slots_ or next free handle
+        u16 generation;
+    };
+
+    static const u16 kNoHandle = 0xffff;
+
+    std::vector<Slot> slots_;
+    std::vector<Handle> handles_;
+    u16 freeHandle_;
+#ifdef _DEBUG
+    mutable bool emitting_;
+#endif
+};
+
+} // namespace game
+} // namespace base
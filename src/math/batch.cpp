@@ -0,0 +1,537 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "math/batch.h"
+#include "math/matrix-inl.h"
+#include "math/simd.h"
+#include "base/debug.h"
+#include "base/cpu.h"
+#include <math.h>
+
+namespace base
+{
+namespace math
+{
+namespace batch
+{
+
+namespace
+{
+
+//! Keeps zero length normals at zero instead of NaN
+const f32 kMinLengthSq = 1e-30f;
+
+void transformPointsScalar( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 from, u32 count )
+{
+    const vec4f& c0 = m.Column( 0 );
+    const vec4f& c1 = m.Column( 1 );
+    const vec4f& c2 = m.Column( 2 );
+    const vec4f& c3 = m.Column( 3 );
+    for ( u32 i = from; i < count; i++ ) {
+        f32 x = in.x[i], y = in.y[i], z = in.z[i];
+        out.x[i] = c0.x * x + c1.x * y + c2.x * z + c3.x;
+        out.y[i] = c0.y * x + c1.y * y + c2.y * z + c3.y;
+        out.z[i] = c0.z * x + c1.z * y + c2.z * z + c3.z;
+    }
+}
+
+void transformNormalsScalar( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 from, u32 count )
+{
+    const vec4f& c0 = m.Column( 0 );
+    const vec4f& c1 = m.Column( 1 );
+    const vec4f& c2 = m.Column( 2 );
+    for ( u32 i = from; i < count; i++ ) {
+        f32 x = in.x[i], y = in.y[i], z = in.z[i];
+        f32 nx = c0.x * x + c1.x * y + c2.x * z;
+        f32 ny = c0.y * x + c1.y * y + c2.y * z;
+        f32 nz = c0.z * x + c1.z * y + c2.z * z;
+        f32 lengthSq = nx * nx + ny * ny + nz * nz;
+        f32 inv = 1.0f / sqrtf( lengthSq > kMinLengthSq ? lengthSq : kMinLengthSq );
+        out.x[i] = nx * inv;
+        out.y[i] = ny * inv;
+        out.z[i] = nz * inv;
+    }
+}
+
+void boundsScalar( const Vec3SoA& points, u32 from, u32 count, vec3f& min, vec3f& max )
+{
+    for ( u32 i = from; i < count; i++ ) {
+        min.x = points.x[i] < min.x ? points.x[i] : min.x;
+        min.y = points.y[i] < min.y ? points.y[i] : min.y;
+        min.z = points.z[i] < min.z ? points.z[i] : min.z;
+        max.x = points.x[i] > max.x ? points.x[i] : max.x;
+        max.y = points.y[i] > max.y ? points.y[i] : max.y;
+        max.z = points.z[i] > max.z ? points.z[i] : max.z;
+    }
+}
+
+u32 cullBoxesScalar( const Plane* planes, u32 planeCount, const BoxSoA& boxes, u32 from, u32 count, u8* visible )
+{
+    u32 visibleCount = 0;
+    for ( u32 i = from; i < count; i++ ) {
+        bool inside = true;
+        for ( u32 p = 0; p < planeCount && inside; p++ ) {
+            // corner farthest along the normal
+            const Plane& plane = planes[p];
+            f32 x = plane.A() >= 0.0f ? boxes.max.x[i] : boxes.min.x[i];
+            f32 y = plane.B() >= 0.0f ? boxes.max.y[i] : boxes.min.y[i];
+            f32 z = plane.C() >= 0.0f ? boxes.max.z[i] : boxes.min.z[i];
+            inside = plane.A() * x + plane.B() * y + plane.C() * z + plane.D() >= 0.0f;
+        }
+        visible[i] = inside ? 1 : 0;
+        visibleCount += visible[i];
+    }
+    return visibleCount;
+}
+
+void deinterleaveScalar( const vec3f* in, const Vec3SoA& out, u32 from, u32 count )
+{
+    for ( u32 i = from; i < count; i++ ) {
+        out.x[i] = in[i].x;
+        out.y[i] = in[i].y;
+        out.z[i] = in[i].z;
+    }
+}
+
+void interleaveScalar( const Vec3SoA& in, vec3f* out, u32 from, u32 count )
+{
+    for ( u32 i = from; i < count; i++ )
+        out[i] = vec3f( in.x[i], in.y[i], in.z[i] );
+}
+
+} // namespace
+
+#ifdef MATH_SSE
+
+namespace
+{
+
+void transformPointsSse( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 from, u32 count )
+{
+    const __m128 m00 = simd::splat( m.Elem( 0, 0 ) ), m10 = simd::splat( m.Elem( 1, 0 ) );
+    const __m128 m20 = simd::splat( m.Elem( 2, 0 ) ), m30 = simd::splat( m.Elem( 3, 0 ) );
+    const __m128 m01 = simd::splat( m.Elem( 0, 1 ) ), m11 = simd::splat( m.Elem( 1, 1 ) );
+    const __m128 m21 = simd::splat( m.Elem( 2, 1 ) ), m31 = simd::splat( m.Elem( 3, 1 ) );
+    const __m128 m02 = simd::splat( m.Elem( 0, 2 ) ), m12 = simd::splat( m.Elem( 1, 2 ) );
+    const __m128 m22 = simd::splat( m.Elem( 2, 2 ) ), m32 = simd::splat( m.Elem( 3, 2 ) );
+    u32 i = from;
+    for ( ; i + 4 <= count; i += 4 ) {
+        __m128 x = simd::load( in.x + i );
+        __m128 y = simd::load( in.y + i );
+        __m128 z = simd::load( in.z + i );
+        __m128 rx = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m00, x ), _mm_mul_ps( m10, y ) ),
+                                _mm_add_ps( _mm_mul_ps( m20, z ), m30 ) );
+        __m128 ry = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m01, x ), _mm_mul_ps( m11, y ) ),
+                                _mm_add_ps( _mm_mul_ps( m21, z ), m31 ) );
+        __m128 rz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m02, x ), _mm_mul_ps( m12, y ) ),
+                                _mm_add_ps( _mm_mul_ps( m22, z ), m32 ) );
+        simd::store( out.x + i, rx );
+        simd::store( out.y + i, ry );
+        simd::store( out.z + i, rz );
+    }
+    transformPointsScalar( m, in, out, i, count );
+}
+
+void transformNormalsSse( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 from, u32 count )
+{
+    const __m128 m00 = simd::splat( m.Elem( 0, 0 ) ), m10 = simd::splat( m.Elem( 1, 0 ) );
+    const __m128 m20 = simd::splat( m.Elem( 2, 0 ) ), m01 = simd::splat( m.Elem( 0, 1 ) );
+    const __m128 m11 = simd::splat( m.Elem( 1, 1 ) ), m21 = simd::splat( m.Elem( 2, 1 ) );
+    const __m128 m02 = simd::splat( m.Elem( 0, 2 ) ), m12 = simd::splat( m.Elem( 1, 2 ) );
+    const __m128 m22 = simd::splat( m.Elem( 2, 2 ) );
+    const __m128 minLengthSq = simd::splat( kMinLengthSq );
+    const __m128 one = simd::splat( 1.0f );
+    u32 i = from;
+    for ( ; i + 4 <= count; i += 4 ) {
+        __m128 x = simd::load( in.x + i );
+        __m128 y = simd::load( in.y + i );
+        __m128 z = simd::load( in.z + i );
+        __m128 nx = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m00, x ), _mm_mul_ps( m10, y ) ), _mm_mul_ps( m20, z ) );
+        __m128 ny = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m01, x ), _mm_mul_ps( m11, y ) ), _mm_mul_ps( m21, z ) );
+        __m128 nz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m02, x ), _mm_mul_ps( m12, y ) ), _mm_mul_ps( m22, z ) );
+        __m128 lengthSq = _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, nx ), _mm_mul_ps( ny, ny ) ), _mm_mul_ps( nz, nz ) );
+        // full precision, rsqrt estimate is only 12 bits
+        __m128 inv = _mm_div_ps( one, _mm_sqrt_ps( _mm_max_ps( lengthSq, minLengthSq ) ) );
+        simd::store( out.x + i, _mm_mul_ps( nx, inv ) );
+        simd::store( out.y + i, _mm_mul_ps( ny, inv ) );
+        simd::store( out.z + i, _mm_mul_ps( nz, inv ) );
+    }
+    transformNormalsScalar( m, in, out, i, count );
+}
+
+//! Extends min and max by points
+void boundsSse( const Vec3SoA& points, u32 from, u32 count, vec3f& min, vec3f& max )
+{
+    u32 i = from;
+    if ( i + 4 <= count ) {
+        __m128 minX = simd::splat( min.x ), maxX = simd::splat( max.x );
+        __m128 minY = simd::splat( min.y ), maxY = simd::splat( max.y );
+        __m128 minZ = simd::splat( min.z ), maxZ = simd::splat( max.z );
+        for ( ; i + 4 <= count; i += 4 ) {
+            __m128 x = simd::load( points.x + i );
+            __m128 y = simd::load( points.y + i );
+            __m128 z = simd::load( points.z + i );
+            minX = _mm_min_ps( minX, x );
+            minY = _mm_min_ps( minY, y );
+            minZ = _mm_min_ps( minZ, z );
+            maxX = _mm_max_ps( maxX, x );
+            maxY = _mm_max_ps( maxY, y );
+            maxZ = _mm_max_ps( maxZ, z );
+        }
+        f32 lanes[6][4];
+        simd::store( lanes[0], minX );
+        simd::store( lanes[1], minY );
+        simd::store( lanes[2], minZ );
+        simd::store( lanes[3], maxX );
+        simd::store( lanes[4], maxY );
+        simd::store( lanes[5], maxZ );
+        Vec3SoA lanePoints = { lanes[0], lanes[1], lanes[2] };
+        boundsScalar( lanePoints, 0, 4, min, max );
+        lanePoints.x = lanes[3];
+        lanePoints.y = lanes[4];
+        lanePoints.z = lanes[5];
+        boundsScalar( lanePoints, 0, 4, min, max );
+    }
+    boundsScalar( points, i, count, min, max );
+}
+
+u32 cullBoxesSse( const Plane* planes, u32 planeCount, const BoxSoA& boxes, u32 from, u32 count, u8* visible )
+{
+    const __m128 zero = _mm_setzero_ps();
+    u32 visibleCount = 0;
+    u32 i = from;
+    for ( ; i + 4 <= count; i += 4 ) {
+        __m128 outside = zero;
+        for ( u32 p = 0; p < planeCount; p++ ) {
+            // the sign of normal is the same for all lanes, so corner farthest
+            // along the normal is picked per plane, not per lane
+            const Plane& plane = planes[p];
+            __m128 x = simd::load( ( plane.A() >= 0.0f ? boxes.max.x : boxes.min.x ) + i );
+            __m128 y = simd::load( ( plane.B() >= 0.0f ? boxes.max.y : boxes.min.y ) + i );
+            __m128 z = simd::load( ( plane.C() >= 0.0f ? boxes.max.z : boxes.min.z ) + i );
+            __m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( simd::splat( plane.A() ), x ),
+                                               _mm_mul_ps( simd::splat( plane.B() ), y ) ),
+                                   _mm_add_ps( _mm_mul_ps( simd::splat( plane.C() ), z ),
+                                               simd::splat( plane.D() ) ) );
+            outside = _mm_or_ps( outside, _mm_cmplt_ps( d, zero ) );
+        }
+        int mask = _mm_movemask_ps( outside );
+        for ( u32 k = 0; k < 4; k++ ) {
+            visible[i + k] = ( mask >> k ) & 1 ? 0 : 1;
+            visibleCount += visible[i + k];
+        }
+    }
+    return visibleCount + cullBoxesScalar( planes, planeCount, boxes, i, count, visible );
+}
+
+} // namespace
+
+#endif // MATH_SSE
+
+#ifdef MATH_AVX2
+
+namespace
+{
+
+// eight elements per iteration with fused multiply-add, the rest goes to SSE kernels
+
+MATH_TARGET_AVX2 void transformPointsAvx2( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 count )
+{
+    const __m256 m00 = _mm256_set1_ps( m.Elem( 0, 0 ) ), m10 = _mm256_set1_ps( m.Elem( 1, 0 ) );
+    const __m256 m20 = _mm256_set1_ps( m.Elem( 2, 0 ) ), m30 = _mm256_set1_ps( m.Elem( 3, 0 ) );
+    const __m256 m01 = _mm256_set1_ps( m.Elem( 0, 1 ) ), m11 = _mm256_set1_ps( m.Elem( 1, 1 ) );
+    const __m256 m21 = _mm256_set1_ps( m.Elem( 2, 1 ) ), m31 = _mm256_set1_ps( m.Elem( 3, 1 ) );
+    const __m256 m02 = _mm256_set1_ps( m.Elem( 0, 2 ) ), m12 = _mm256_set1_ps( m.Elem( 1, 2 ) );
+    const __m256 m22 = _mm256_set1_ps( m.Elem( 2, 2 ) ), m32 = _mm256_set1_ps( m.Elem( 3, 2 ) );
+    u32 i = 0;
+    for ( ; i + 8 <= count; i += 8 ) {
+        __m256 x = _mm256_loadu_ps( in.x + i );
+        __m256 y = _mm256_loadu_ps( in.y + i );
+        __m256 z = _mm256_loadu_ps( in.z + i );
+        __m256 rx = _mm256_fmadd_ps( m00, x, _mm256_fmadd_ps( m10, y, _mm256_fmadd_ps( m20, z, m30 ) ) );
+        __m256 ry = _mm256_fmadd_ps( m01, x, _mm256_fmadd_ps( m11, y, _mm256_fmadd_ps( m21, z, m31 ) ) );
+        __m256 rz = _mm256_fmadd_ps( m02, x, _mm256_fmadd_ps( m12, y, _mm256_fmadd_ps( m22, z, m32 ) ) );
+        _mm256_storeu_ps( out.x + i, rx );
+        _mm256_storeu_ps( out.y + i, ry );
+        _mm256_storeu_ps( out.z + i, rz );
+    }
+    transformPointsSse( m, in, out, i, count );
+}
+
+MATH_TARGET_AVX2 void transformNormalsAvx2( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 count )
+{
+    const __m256 m00 = _mm256_set1_ps( m.Elem( 0, 0 ) ), m10 = _mm256_set1_ps( m.Elem( 1, 0 ) );
+    const __m256 m20 = _mm256_set1_ps( m.Elem( 2, 0 ) ), m01 = _mm256_set1_ps( m.Elem( 0, 1 ) );
+    const __m256 m11 = _mm256_set1_ps( m.Elem( 1, 1 ) ), m21 = _mm256_set1_ps( m.Elem( 2, 1 ) );
+    const __m256 m02 = _mm256_set1_ps( m.Elem( 0, 2 ) ), m12 = _mm256_set1_ps( m.Elem( 1, 2 ) );
+    const __m256 m22 = _mm256_set1_ps( m.Elem( 2, 2 ) );
+    const __m256 minLengthSq = _mm256_set1_ps( kMinLengthSq );
+    const __m256 one = _mm256_set1_ps( 1.0f );
+    u32 i = 0;
+    for ( ; i + 8 <= count; i += 8 ) {
+        __m256 x = _mm256_loadu_ps( in.x + i );
+        __m256 y = _mm256_loadu_ps( in.y + i );
+        __m256 z = _mm256_loadu_ps( in.z + i );
+        __m256 nx = _mm256_fmadd_ps( m00, x, _mm256_fmadd_ps( m10, y, _mm256_mul_ps( m20, z ) ) );
+        __m256 ny = _mm256_fmadd_ps( m01, x, _mm256_fmadd_ps( m11, y, _mm256_mul_ps( m21, z ) ) );
+        __m256 nz = _mm256_fmadd_ps( m02, x, _mm256_fmadd_ps( m12, y, _mm256_mul_ps( m22, z ) ) );
+        __m256 lengthSq = _mm256_fmadd_ps( nx, nx, _mm256_fmadd_ps( ny, ny, _mm256_mul_ps( nz, nz ) ) );
+        __m256 inv = _mm256_div_ps( one, _mm256_sqrt_ps( _mm256_max_ps( lengthSq, minLengthSq ) ) );
+        _mm256_storeu_ps( out.x + i, _mm256_mul_ps( nx, inv ) );
+        _mm256_storeu_ps( out.y + i, _mm256_mul_ps( ny, inv ) );
+        _mm256_storeu_ps( out.z + i, _mm256_mul_ps( nz, inv ) );
+    }
+    transformNormalsSse( m, in, out, i, count );
+}
+
+MATH_TARGET_AVX2 void boundsAvx2( const Vec3SoA& points, u32 count, vec3f& min, vec3f& max )
+{
+    u32 i = 0;
+    if ( count >= 8 ) {
+        __m256 minX = _mm256_loadu_ps( points.x ), maxX = minX;
+        __m256 minY = _mm256_loadu_ps( points.y ), maxY = minY;
+        __m256 minZ = _mm256_loadu_ps( points.z ), maxZ = minZ;
+        for ( i = 8; i + 8 <= count; i += 8 ) {
+            __m256 x = _mm256_loadu_ps( points.x + i );
+            __m256 y = _mm256_loadu_ps( points.y + i );
+            __m256 z = _mm256_loadu_ps( points.z + i );
+            minX = _mm256_min_ps( minX, x );
+            minY = _mm256_min_ps( minY, y );
+            minZ = _mm256_min_ps( minZ, z );
+            maxX = _mm256_max_ps( maxX, x );
+            maxY = _mm256_max_ps( maxY, y );
+            maxZ = _mm256_max_ps( maxZ, z );
+        }
+        f32 lanes[6][8];
+        _mm256_storeu_ps( lanes[0], minX );
+        _mm256_storeu_ps( lanes[1], minY );
+        _mm256_storeu_ps( lanes[2], minZ );
+        _mm256_storeu_ps( lanes[3], maxX );
+        _mm256_storeu_ps( lanes[4], maxY );
+        _mm256_storeu_ps( lanes[5], maxZ );
+        Vec3SoA lanePoints = { lanes[0], lanes[1], lanes[2] };
+        boundsScalar( lanePoints, 0, 8, min, max );
+        lanePoints.x = lanes[3];
+        lanePoints.y = lanes[4];
+        lanePoints.z = lanes[5];
+        boundsScalar( lanePoints, 0, 8, min, max );
+    }
+    boundsSse( points, i, count, min, max );
+}
+
+MATH_TARGET_AVX2 u32 cullBoxesAvx2( const Plane* planes, u32 planeCount, const BoxSoA& boxes, u32 count, u8* visible )
+{
+    const __m256 zero = _mm256_setzero_ps();
+    u32 visibleCount = 0;
+    u32 i = 0;
+    for ( ; i + 8 <= count; i += 8 ) {
+        __m256 outside = zero;
+        for ( u32 p = 0; p < planeCount; p++ ) {
+            const Plane& plane = planes[p];
+            __m256 x = _mm256_loadu_ps( ( plane.A() >= 0.0f ? boxes.max.x : boxes.min.x ) + i );
+            __m256 y = _mm256_loadu_ps( ( plane.B() >= 0.0f ? boxes.max.y : boxes.min.y ) + i );
+            __m256 z = _mm256_loadu_ps( ( plane.C() >= 0.0f ? boxes.max.z : boxes.min.z ) + i );
+            __m256 d = _mm256_fmadd_ps( _mm256_set1_ps( plane.A() ), x,
+                       _mm256_fmadd_ps( _mm256_set1_ps( plane.B() ), y,
+                       _mm256_fmadd_ps( _mm256_set1_ps( plane.C() ), z, _mm256_set1_ps( plane.D() ) ) ) );
+            outside = _mm256_or_ps( outside, _mm256_cmp_ps( d, zero, _CMP_LT_OQ ) );
+        }
+        int mask = _mm256_movemask_ps( outside );
+        for ( u32 k = 0; k < 8; k++ ) {
+            visible[i + k] = ( mask >> k ) & 1 ? 0 : 1;
+            visibleCount += visible[i + k];
+        }
+    }
+    return visibleCount + cullBoxesSse( planes, planeCount, boxes, i, count, visible );
+}
+
+} // namespace
+
+#endif // MATH_AVX2
+
+#ifdef MATH_SSE
+
+void multiply( const Matrix4& m, const Matrix4* in, Matrix4* out, u32 count )
+{
+    const __m128 c0 = simd::load( &m.Column( 0 ).x );
+    const __m128 c1 = simd::load( &m.Column( 1 ).x );
+    const __m128 c2 = simd::load( &m.Column( 2 ).x );
+    const __m128 c3 = simd::load( &m.Column( 3 ).x );
+    for ( u32 i = 0; i < count; i++ ) {
+        // every column is read before it is written, so in may be out
+        for ( u32 k = 0; k < 4; k++ ) {
+            __m128 v = simd::load( &in[i].Column( k ).x );
+            simd::store( &out[i].Column( k ).x, simd::combine( v, c0, c1, c2, c3 ) );
+        }
+    }
+}
+
+void transformBounds( const Matrix4* matrices, const BoxSoA& in, const BoxSoA& out, u32 count )
+{
+    const __m128 half = simd::splat( 0.5f );
+    const __m128 signMask = simd::splat( -0.0f );
+    for ( u32 i = 0; i < count; i++ ) {
+        const Matrix4& m = matrices[i];
+        __m128 min = _mm_set_ps( 1.0f, in.min.z[i], in.min.y[i], in.min.x[i] );
+        __m128 max = _mm_set_ps( 1.0f, in.max.z[i], in.max.y[i], in.max.x[i] );
+        // center keeps w = 1 to pick up translation, extent has w = 0
+        __m128 center = _mm_mul_ps( _mm_add_ps( min, max ), half );
+        __m128 extent = _mm_mul_ps( _mm_sub_ps( max, min ), half );
+        __m128 c0 = simd::load( &m.Column( 0 ).x );
+        __m128 c1 = simd::load( &m.Column( 1 ).x );
+        __m128 c2 = simd::load( &m.Column( 2 ).x );
+        __m128 c3 = simd::load( &m.Column( 3 ).x );
+        center = simd::combine( center, c0, c1, c2, c3 );
+        extent = simd::combine( extent, _mm_andnot_ps( signMask, c0 ), _mm_andnot_ps( signMask, c1 ),
+                                _mm_andnot_ps( signMask, c2 ), _mm_andnot_ps( signMask, c3 ) );
+        f32 lo[4], hi[4];
+        simd::store( lo, _mm_sub_ps( center, extent ) );
+        simd::store( hi, _mm_add_ps( center, extent ) );
+        out.min.x[i] = lo[0];
+        out.min.y[i] = lo[1];
+        out.min.z[i] = lo[2];
+        out.max.x[i] = hi[0];
+        out.max.y[i] = hi[1];
+        out.max.z[i] = hi[2];
+    }
+}
+
+void deinterleave( const vec3f* in, const Vec3SoA& out, u32 count )
+{
+    u32 i = 0;
+    for ( ; i + 4 <= count; i += 4 ) {
+        // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+        const f32* p = &in[i].x;
+        __m128 a = simd::load( p );
+        __m128 b = simd::load( p + 4 );
+        __m128 c = simd::load( p + 8 );
+        __m128 x2y2z2x3 = MATH_SHUFFLE( b, c, 2, 3, 0, 1 );
+        __m128 y0z0y1z1 = MATH_SHUFFLE( a, b, 1, 2, 0, 1 );
+        __m128 y2z2y3z3 = MATH_SHUFFLE( x2y2z2x3, c, 1, 2, 2, 3 );
+        simd::store( out.x + i, MATH_SHUFFLE( a, x2y2z2x3, 0, 3, 0, 3 ) );
+        simd::store( out.y + i, MATH_SHUFFLE( y0z0y1z1, y2z2y3z3, 0, 2, 0, 2 ) );
+        simd::store( out.z + i, MATH_SHUFFLE( y0z0y1z1, y2z2y3z3, 1, 3, 1, 3 ) );
+    }
+    deinterleaveScalar( in, out, i, count );
+}
+
+void interleave( const Vec3SoA& in, vec3f* out, u32 count )
+{
+    u32 i = 0;
+    for ( ; i + 4 <= count; i += 4 ) {
+        __m128 x = simd::load( in.x + i );
+        __m128 y = simd::load( in.y + i );
+        __m128 z = simd::load( in.z + i );
+        __m128 x0y0x1y1 = _mm_unpacklo_ps( x, y );
+        __m128 x2y2x3y3 = _mm_unpackhi_ps( x, y );
+        __m128 a = MATH_SHUFFLE( x0y0x1y1, MATH_SHUFFLE( z, x, 0, 0, 1, 1 ), 0, 1, 0, 2 );
+        __m128 b = MATH_SHUFFLE( MATH_SHUFFLE( y, z, 1, 1, 1, 1 ), x2y2x3y3, 0, 2, 0, 1 );
+        __m128 c = MATH_SHUFFLE( MATH_SHUFFLE( z, x, 2, 2, 3, 3 ), MATH_SHUFFLE( y, z, 3, 3, 3, 3 ), 0, 2, 0, 2 );
+        f32* p = &out[i].x;
+        simd::store( p, a );
+        simd::store( p + 4, b );
+        simd::store( p + 8, c );
+    }
+    interleaveScalar( in, out, i, count );
+}
+
+#else
+
+void multiply( const Matrix4& m, const Matrix4* in, Matrix4* out, u32 count )
+{
+    for ( u32 i = 0; i < count; i++ )
+        out[i] = m * in[i];
+}
+
+void transformBounds( const Matrix4* matrices, const BoxSoA& in, const BoxSoA& out, u32 count )
+{
+    for ( u32 i = 0; i < count; i++ ) {
+        const Matrix4& m = matrices[i];
+        vec3f min( in.min.x[i], in.min.y[i], in.min.z[i] );
+        vec3f max( in.max.x[i], in.max.y[i], in.max.z[i] );
+        vec3f center = ( m * vec4f( ( min + max ) * 0.5f, 1.0f ) ).xyz();
+        vec3f extent = ( max - min ) * 0.5f;
+        vec3f e;
+        for ( u32 j = 0; j < 3; j++ )
+            e[j] = fabsf( m.Elem( 0, j ) ) * extent.x + fabsf( m.Elem( 1, j ) ) * extent.y
+                   + fabsf( m.Elem( 2, j ) ) * extent.z;
+        out.min.x[i] = center.x - e.x;
+        out.min.y[i] = center.y - e.y;
+        out.min.z[i] = center.z - e.z;
+        out.max.x[i] = center.x + e.x;
+        out.max.y[i] = center.y + e.y;
+        out.max.z[i] = center.z + e.z;
+    }
+}
+
+void deinterleave( const vec3f* in, const Vec3SoA& out, u32 count )
+{
+    deinterleaveScalar( in, out, 0, count );
+}
+
+void interleave( const Vec3SoA& in, vec3f* out, u32 count )
+{
+    interleaveScalar( in, out, 0, count );
+}
+
+#endif // MATH_SSE
+
+void transformPoints( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 count )
+{
+#if defined(MATH_AVX2)
+    if ( cpu::tier() >= cpu::Tier::AVX2 )
+        return transformPointsAvx2( m, in, out, count );
+#endif
+#if defined(MATH_SSE)
+    transformPointsSse( m, in, out, 0, count );
+#else
+    transformPointsScalar( m, in, out, 0, count );
+#endif
+}
+
+void transformNormals( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 count )
+{
+#if defined(MATH_AVX2)
+    if ( cpu::tier() >= cpu::Tier::AVX2 )
+        return transformNormalsAvx2( m, in, out, count );
+#endif
+#if defined(MATH_SSE)
+    transformNormalsSse( m, in, out, 0, count );
+#else
+    transformNormalsScalar( m, in, out, 0, count );
+#endif
+}
+
+void bounds( const Vec3SoA& points, u32 count, vec3f& min, vec3f& max )
+{
+    ASSERT( count > 0 );
+    min = max = vec3f( points.x[0], points.y[0], points.z[0] );
+#if defined(MATH_AVX2)
+    if ( cpu::tier() >= cpu::Tier::AVX2 )
+        return boundsAvx2( points, count, min, max );
+#endif
+#if defined(MATH_SSE)
+    boundsSse( points, 1, count, min, max );
+#else
+    boundsScalar( points, 1, count, min, max );
+#endif
+}
+
+u32 cullBoxes( const Plane* planes, u32 planeCount, const BoxSoA& boxes, u32 count, u8* visible )
+{
+#if defined(MATH_AVX2)
+    if ( cpu::tier() >= cpu::Tier::AVX2 )
+        return cullBoxesAvx2( planes, planeCount, boxes, count, visible );
+#endif
+#if defined(MATH_SSE)
+    return cullBoxesSse( planes, planeCount, boxes, 0, count, visible );
+#else
+    return cullBoxesScalar( planes, planeCount, boxes, 0, count, visible );
+#endif
+}
+
+} // namespace batch
+} // namespace math
+} // namespace base
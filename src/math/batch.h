@@ -0,0 +1,64 @@
+/**
+ * \file
+ * \brief       batched transforms over structure of arrays streams
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ *
+ * Kernels process four elements per iteration with SSE, the tail is scalar.
+ * Input and output streams may be the same arrays, but must not partially overlap
+ **/
+#pragma once
+
+#include "math/matrix.h"
+#include "math/plane.h"
+
+namespace base
+{
+namespace math
+{
+namespace batch
+{
+
+//! Stream of vec3f stored as three separate arrays
+struct Vec3SoA
+{
+    f32* x;
+    f32* y;
+    f32* z;
+};
+
+//! Stream of axis aligned boxes
+struct BoxSoA
+{
+    Vec3SoA min;
+    Vec3SoA max;
+};
+
+//! out[i] = m * (in[i], 1), perspective divide is not done
+NEGINE_API void transformPoints( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 count );
+
+//! out[i] = normalize(m * (in[i], 0)), m is normal matrix (inverse transpose of world)
+NEGINE_API void transformNormals( const Matrix4& m, const Vec3SoA& in, const Vec3SoA& out, u32 count );
+
+//! out[i] = m * in[i]
+NEGINE_API void multiply( const Matrix4& m, const Matrix4* in, Matrix4* out, u32 count );
+
+//! Box enclosing all points, count has to be greater than 0
+NEGINE_API void bounds( const Vec3SoA& points, u32 count, vec3f& min, vec3f& max );
+
+//! out[i] is box enclosing in[i] transformed by matrices[i]
+NEGINE_API void transformBounds( const Matrix4* matrices, const BoxSoA& in, const BoxSoA& out, u32 count );
+
+//! Tests boxes against convex volume of inward facing planes (camera frustum).
+//! visible[i] is 1 when box is inside or intersects the volume, returns count of visible boxes
+NEGINE_API u32 cullBoxes( const Plane* planes, u32 planeCount, const BoxSoA& boxes, u32 count, u8* visible );
+
+//! Splits array of vec3f into streams
+NEGINE_API void deinterleave( const vec3f* in, const Vec3SoA& out, u32 count );
+
+//! Joins streams into array of vec3f
+NEGINE_API void interleave( const Vec3SoA& in, vec3f* out, u32 count );
+
+} // namespace batch
+} // namespace math
+} // namespace base
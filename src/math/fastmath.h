@@ -0,0 +1,241 @@
+/**
+ * \file
+ * \brief       fast approximations of trigonometric functions and reciprocal square root
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ *
+ * Every function has scalar form and SSE form working on four lanes,
+ * both give bit-identical results. Error bounds are measured against
+ * double precision libm by tests/test_fastmath.cpp
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "math/simd.h"
+#include <math.h>
+
+namespace base
+{
+namespace math
+{
+namespace fast
+{
+
+namespace detail
+{
+
+// pi/2 split in three parts for Cody-Waite reduction, first two have
+// few mantissa bits, so k * part is exact for |k| < 2^12
+const f32 kPiOver2Hi = 1.5703125f;
+const f32 kPiOver2Mid = 4.837512969970703125e-4f;
+const f32 kPiOver2Lo = 7.54978995489188216e-8f;
+const f32 kTwoOverPi = 0.636619772367581343f;
+
+// minimax polynomials on [-pi/4, pi/4]
+const f32 kSin1 = -1.6666654611e-1f;
+const f32 kSin2 = 8.3321608736e-3f;
+const f32 kSin3 = -1.9515295891e-4f;
+const f32 kCos1 = 4.166664568298827e-2f;
+const f32 kCos2 = -1.388731625493765e-3f;
+const f32 kCos3 = 2.443315711809948e-5f;
+
+// minimax polynomial of atan on [-tan(pi/8), tan(pi/8)]
+const f32 kAtan1 = -3.33329491539e-1f;
+const f32 kAtan2 = 1.99777106478e-1f;
+const f32 kAtan3 = -1.38776856032e-1f;
+const f32 kAtan4 = 8.05374449538e-2f;
+const f32 kTanPiOver8 = 0.414213562373095f;
+const f32 kPi = 3.14159265358979f;
+const f32 kPiOver2 = 1.57079632679490f;
+const f32 kPiOver4 = 0.785398163397448f;
+
+inline f32 sinPoly( f32 r, f32 r2 )
+{
+    return r + r * r2 * ( kSin1 + r2 * ( kSin2 + r2 * kSin3 ) );
+}
+
+inline f32 cosPoly( f32 r2 )
+{
+    return 1.0f - 0.5f * r2 + r2 * r2 * ( kCos1 + r2 * ( kCos2 + r2 * kCos3 ) );
+}
+
+//! Returns x - k * pi/2, k is nearest integer to x * 2/pi
+inline f32 reduce( f32 x, i32& k )
+{
+    f32 fk = x * kTwoOverPi;
+    k = static_cast<i32>( fk >= 0.0f ? fk + 0.5f : fk - 0.5f );
+    fk = static_cast<f32>( k );
+    return ( ( x - fk * kPiOver2Hi ) - fk * kPiOver2Mid ) - fk * kPiOver2Lo;
+}
+
+} // namespace detail
+
+//! Sine and cosine, max absolute error 1e-7 for |x| <= 1000 (libm sinf: 6e-8),
+//! reduction loses precision beyond |x| ~ 6000
+inline void sincos( f32 x, f32& s, f32& c )
+{
+    i32 k;
+    f32 r = detail::reduce( x, k );
+    f32 r2 = r * r;
+    f32 ps = detail::sinPoly( r, r2 );
+    f32 pc = detail::cosPoly( r2 );
+    // quadrant picks polynomial and sign
+    f32 sn = ( k & 1 ) ? pc : ps;
+    f32 cs = ( k & 1 ) ? ps : pc;
+    s = ( k & 2 ) ? -sn : sn;
+    c = ( ( k + 1 ) & 2 ) ? -cs : cs;
+}
+
+//! Sine, same error as sincos
+inline f32 sin( f32 x )
+{
+    f32 s, c;
+    sincos( x, s, c );
+    return s;
+}
+
+//! Cosine, same error as sincos
+inline f32 cos( f32 x )
+{
+    f32 s, c;
+    sincos( x, s, c );
+    return c;
+}
+
+//! Angle of (x, y) in [-pi, pi], max absolute error 3e-7 rad.
+//! atan2(0, 0) is 0, signed zeros are not distinguished
+inline f32 atan2( f32 y, f32 x )
+{
+    f32 ax = fabsf( x ), ay = fabsf( y );
+    f32 hi = ax > ay ? ax : ay;
+    f32 lo = ax > ay ? ay : ax;
+    f32 a = hi > 0.0f ? lo / hi : 0.0f;
+    // atan(a) = pi/4 + atan((a - 1) / (a + 1))
+    f32 offset = 0.0f;
+    if ( a > detail::kTanPiOver8 ) {
+        a = ( a - 1.0f ) / ( a + 1.0f );
+        offset = detail::kPiOver4;
+    }
+    f32 z = a * a;
+    f32 r = offset + a + a * z * ( detail::kAtan1 + z * ( detail::kAtan2 + z * ( detail::kAtan3 + z * detail::kAtan4 ) ) );
+    if ( ay > ax )
+        r = detail::kPiOver2 - r;
+    if ( x < 0.0f )
+        r = detail::kPi - r;
+    return y < 0.0f ? -r : r;
+}
+
+#ifdef MATH_SSE
+
+//! 1 / sqrt(x) for x > 0: estimate refined by one Newton step, max relative error 3e-7
+inline f32 rsqrt( f32 x )
+{
+    __m128 v = _mm_set_ss( x );
+    __m128 y = _mm_rsqrt_ss( v );
+    // y * (1.5 - 0.5 * x * y * y)
+    __m128 yy = _mm_mul_ss( _mm_mul_ss( v, y ), y );
+    y = _mm_mul_ss( _mm_mul_ss( _mm_set_ss( 0.5f ), y ), _mm_sub_ss( _mm_set_ss( 3.0f ), yy ) );
+    return _mm_cvtss_f32( y );
+}
+
+inline __m128 rsqrt( __m128 x )
+{
+    __m128 y = _mm_rsqrt_ps( x );
+    __m128 yy = _mm_mul_ps( _mm_mul_ps( x, y ), y );
+    return _mm_mul_ps( _mm_mul_ps( simd::splat( 0.5f ), y ), _mm_sub_ps( simd::splat( 3.0f ), yy ) );
+}
+
+namespace detail
+{
+
+inline __m128 select( __m128 mask, __m128 a, __m128 b )
+{
+    return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+} // namespace detail
+
+inline void sincos( __m128 x, __m128& s, __m128& c )
+{
+    using namespace detail;
+    // same rounding as scalar reduce(): truncation of x * 2/pi +- 0.5
+    __m128 fk = _mm_mul_ps( x, simd::splat( kTwoOverPi ) );
+    __m128 half = _mm_or_ps( simd::splat( 0.5f ), _mm_and_ps( fk, simd::splat( -0.0f ) ) );
+    __m128i k = _mm_cvttps_epi32( _mm_add_ps( fk, half ) );
+    fk = _mm_cvtepi32_ps( k );
+    __m128 r = _mm_sub_ps( x, _mm_mul_ps( fk, simd::splat( kPiOver2Hi ) ) );
+    r = _mm_sub_ps( r, _mm_mul_ps( fk, simd::splat( kPiOver2Mid ) ) );
+    r = _mm_sub_ps( r, _mm_mul_ps( fk, simd::splat( kPiOver2Lo ) ) );
+    __m128 r2 = _mm_mul_ps( r, r );
+
+    __m128 ps = _mm_add_ps( simd::splat( kSin2 ), _mm_mul_ps( r2, simd::splat( kSin3 ) ) );
+    ps = _mm_add_ps( simd::splat( kSin1 ), _mm_mul_ps( r2, ps ) );
+    ps = _mm_add_ps( r, _mm_mul_ps( _mm_mul_ps( r, r2 ), ps ) );
+    __m128 pc = _mm_add_ps( simd::splat( kCos2 ), _mm_mul_ps( r2, simd::splat( kCos3 ) ) );
+    pc = _mm_add_ps( simd::splat( kCos1 ), _mm_mul_ps( r2, pc ) );
+    pc = _mm_add_ps( _mm_sub_ps( simd::splat( 1.0f ), _mm_mul_ps( simd::splat( 0.5f ), r2 ) ),
+                     _mm_mul_ps( _mm_mul_ps( r2, r2 ), pc ) );
+
+    const __m128i one = _mm_set1_epi32( 1 );
+    const __m128i two = _mm_set1_epi32( 2 );
+    __m128 swap = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( k, one ), one ) );
+    __m128 sn = select( swap, pc, ps );
+    __m128 cs = select( swap, ps, pc );
+    // bit 1 of k (and of k + 1 for cosine) moved to the sign bit
+    __m128 signS = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( k, two ), 30 ) );
+    __m128 signC = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( _mm_add_epi32( k, one ), two ), 30 ) );
+    s = _mm_xor_ps( sn, signS );
+    c = _mm_xor_ps( cs, signC );
+}
+
+inline __m128 sin( __m128 x )
+{
+    __m128 s, c;
+    sincos( x, s, c );
+    return s;
+}
+
+inline __m128 cos( __m128 x )
+{
+    __m128 s, c;
+    sincos( x, s, c );
+    return c;
+}
+
+inline __m128 atan2( __m128 y, __m128 x )
+{
+    using namespace detail;
+    const __m128 signMask = simd::splat( -0.0f );
+    const __m128 zero = _mm_setzero_ps();
+    __m128 ax = _mm_andnot_ps( signMask, x );
+    __m128 ay = _mm_andnot_ps( signMask, y );
+    __m128 hi = _mm_max_ps( ax, ay );
+    __m128 lo = _mm_min_ps( ax, ay );
+    __m128 a = _mm_and_ps( _mm_cmpgt_ps( hi, zero ), _mm_div_ps( lo, hi ) );
+    __m128 reduce = _mm_cmpgt_ps( a, simd::splat( kTanPiOver8 ) );
+    const __m128 one = simd::splat( 1.0f );
+    a = select( reduce, _mm_div_ps( _mm_sub_ps( a, one ), _mm_add_ps( a, one ) ), a );
+    __m128 offset = _mm_and_ps( reduce, simd::splat( kPiOver4 ) );
+    __m128 z = _mm_mul_ps( a, a );
+    __m128 p = _mm_add_ps( simd::splat( kAtan3 ), _mm_mul_ps( z, simd::splat( kAtan4 ) ) );
+    p = _mm_add_ps( simd::splat( kAtan2 ), _mm_mul_ps( z, p ) );
+    p = _mm_add_ps( simd::splat( kAtan1 ), _mm_mul_ps( z, p ) );
+    __m128 r = _mm_add_ps( _mm_add_ps( offset, a ), _mm_mul_ps( _mm_mul_ps( a, z ), p ) );
+    r = select( _mm_cmpgt_ps( ay, ax ), _mm_sub_ps( simd::splat( kPiOver2 ), r ), r );
+    r = select( _mm_cmplt_ps( x, zero ), _mm_sub_ps( simd::splat( kPi ), r ), r );
+    return _mm_xor_ps( r, _mm_and_ps( _mm_cmplt_ps( y, zero ), signMask ) );
+}
+
+#else
+
+//! Exact fallback without SSE
+inline f32 rsqrt( f32 x )
+{
+    return 1.0f / sqrtf( x );
+}
+
+#endif // MATH_SSE
+
+} // namespace fast
+} // namespace math
+} // namespace base
@@ -16,7 +16,7 @@ namespace math
 {
 
 const f32 eps = 0.000001f;
-const f32 pi = 3.1415f;
+const f32 pi = 3.14159265f;
 const f32 deg_to_rad = pi / 180.0f;
 const f32 pi_over_2 = pi / 2.0f;
 
@@ -2,6 +2,8 @@
 
 #include "math/matrix.h"
 #include "math/vec3.h"
+#include "math/simd.h"
+#include "math/fastmath.h"
 #include <math.h>
 
 namespace base
@@ -122,6 +124,71 @@ inline f32 Matrix4::Elem( u32 i, u32 j ) const
     return c[j];
 }
 
+#ifdef MATH_SSE
+
+inline const Matrix4 Matrix4::operator +( const Matrix4& m ) const
+{
+    Matrix4 r;
+    for ( u32 i = 0; i < 4; i++ ) {
+        simd::store( &r.Column( i ).x, _mm_add_ps( simd::load( &Column( i ).x ), simd::load( &m.Column( i ).x ) ) );
+    }
+    return r;
+}
+
+inline const Matrix4 Matrix4::operator -( const Matrix4& m ) const
+{
+    Matrix4 r;
+    for ( u32 i = 0; i < 4; i++ ) {
+        simd::store( &r.Column( i ).x, _mm_sub_ps( simd::load( &Column( i ).x ), simd::load( &m.Column( i ).x ) ) );
+    }
+    return r;
+}
+
+inline const Matrix4 Matrix4::operator *( f32 s ) const
+{
+    Matrix4 r;
+    __m128 vs = simd::splat( s );
+    for ( u32 i = 0; i < 4; i++ ) {
+        simd::store( &r.Column( i ).x, _mm_mul_ps( simd::load( &Column( i ).x ), vs ) );
+    }
+    return r;
+}
+
+inline const vec4f Matrix4::operator *( const vec4f& v ) const
+{
+    vec4f r;
+    simd::store( &r.x, simd::combine( simd::load( &v.x ),
+                                      simd::load( &column0_.x ), simd::load( &column1_.x ),
+                                      simd::load( &column2_.x ), simd::load( &column3_.x ) ) );
+    return r;
+}
+
+inline const vec4f Matrix4::operator *( const vec3f& v ) const
+{
+    // w is 0, so the translation column does not contribute
+    __m128 c0 = _mm_mul_ps( simd::load( &column0_.x ), simd::splat( v.x ) );
+    __m128 c1 = _mm_mul_ps( simd::load( &column1_.x ), simd::splat( v.y ) );
+    __m128 c2 = _mm_mul_ps( simd::load( &column2_.x ), simd::splat( v.z ) );
+    vec4f r;
+    simd::store( &r.x, _mm_add_ps( _mm_add_ps( c0, c1 ), c2 ) );
+    return r;
+}
+
+inline const Matrix4 Matrix4::operator *( const Matrix4& m ) const
+{
+    __m128 c0 = simd::load( &column0_.x );
+    __m128 c1 = simd::load( &column1_.x );
+    __m128 c2 = simd::load( &column2_.x );
+    __m128 c3 = simd::load( &column3_.x );
+    Matrix4 r;
+    for ( u32 i = 0; i < 4; i++ ) {
+        simd::store( &r.Column( i ).x, simd::combine( simd::load( &m.Column( i ).x ), c0, c1, c2, c3 ) );
+    }
+    return r;
+}
+
+#else
+
 inline const Matrix4 Matrix4::operator +( const Matrix4& m ) const
 {
     return Matrix4(
@@ -183,6 +250,8 @@ inline const Matrix4 Matrix4::operator *( const Matrix4& m ) const
            );
 }
 
+#endif // MATH_SSE
+
 inline bool Matrix4::operator ==( const Matrix4& m ) const
 {
     return column0_ == m.column0_ && column1_ == m.column1_ && column2_ == m.column2_ && column3_ == m.column3_;
@@ -229,8 +298,8 @@ inline const Matrix4 Matrix4::Identity()
 
 inline const Matrix4 Matrix4::RotationX( f32 radians )
 {
-    f32 c = cosf( radians );
-    f32 s = sinf( radians );
+    f32 s, c;
+    fast::sincos( radians, s, c );
     return Matrix4(
                vec4f( 1.0f, 0.0f, 0.0f, 0.0f ),
                vec4f( 0.0f,    c,    s, 0.0f ),
@@ -241,8 +310,8 @@ inline const Matrix4 Matrix4::RotationX( f32 radians )
 
 inline const Matrix4 Matrix4::RotationY( f32 radians )
 {
-    f32 c = cosf( radians );
-    f32 s = sinf( radians );
+    f32 s, c;
+    fast::sincos( radians, s, c );
     return Matrix4(
                vec4f(   c, 0.0f,   -s, 0.0f ),
                vec4f( 0.0f, 1.0f, 0.0f, 0.0f ),
@@ -253,8 +322,8 @@ inline const Matrix4 Matrix4::RotationY( f32 radians )
 
 inline const Matrix4 Matrix4::RotationZ( f32 radians )
 {
-    f32 c = cosf( radians );
-    f32 s = sinf( radians );
+    f32 s, c;
+    fast::sincos( radians, s, c );
     return Matrix4(
                vec4f(   c,    s, 0.0f, 0.0f ),
                vec4f(  -s,    c, 0.0f, 0.0f ),
@@ -290,12 +359,26 @@ inline const Matrix4 operator *( f32 s, const Matrix4& m )
 
 inline const Matrix4 Transpose( const Matrix4& m )
 {
+#ifdef MATH_SSE
+    __m128 c0 = simd::load( &m.Column( 0 ).x );
+    __m128 c1 = simd::load( &m.Column( 1 ).x );
+    __m128 c2 = simd::load( &m.Column( 2 ).x );
+    __m128 c3 = simd::load( &m.Column( 3 ).x );
+    _MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+    Matrix4 r;
+    simd::store( &r.Column( 0 ).x, c0 );
+    simd::store( &r.Column( 1 ).x, c1 );
+    simd::store( &r.Column( 2 ).x, c2 );
+    simd::store( &r.Column( 3 ).x, c3 );
+    return r;
+#else
     return Matrix4(
                m.Row( 0 ),
                m.Row( 1 ),
                m.Row( 2 ),
                m.Row( 3 )
            );
+#endif
 }
 
 } // namespace math
@@ -68,6 +68,143 @@ const Matrix4 Matrix4::Orthographic( f32 left, f32 right, f32 bottom, f32 top, f
            );
 }
 
+#ifdef MATH_SSE
+
+namespace
+{
+
+// 2x2 matrices packed into __m128 as ( m00, m01, m10, m11 )
+
+//! A * B
+inline __m128 mul2( __m128 a, __m128 b )
+{
+    return _mm_add_ps( _mm_mul_ps( a, MATH_SWIZZLE( b, 0, 3, 0, 3 ) ),
+                       _mm_mul_ps( MATH_SWIZZLE( a, 1, 0, 3, 2 ), MATH_SWIZZLE( b, 2, 1, 2, 1 ) ) );
+}
+
+//! adj(A) * B
+inline __m128 adjMul2( __m128 a, __m128 b )
+{
+    return _mm_sub_ps( _mm_mul_ps( MATH_SWIZZLE( a, 3, 3, 0, 0 ), b ),
+                       _mm_mul_ps( MATH_SWIZZLE( a, 1, 1, 2, 2 ), MATH_SWIZZLE( b, 2, 3, 0, 1 ) ) );
+}
+
+//! A * adj(B)
+inline __m128 mulAdj2( __m128 a, __m128 b )
+{
+    return _mm_sub_ps( _mm_mul_ps( a, MATH_SWIZZLE( b, 3, 0, 3, 0 ) ),
+                       _mm_mul_ps( MATH_SWIZZLE( a, 1, 0, 3, 2 ), MATH_SWIZZLE( b, 2, 1, 2, 1 ) ) );
+}
+
+} // namespace
+
+//! Block-wise inverse through 2x2 adjugates, inverse of transposed matrix
+//! is transposed inverse, so columns are handled as rows
+const Matrix4 Inverse( const Matrix4& m )
+{
+    __m128 c0 = simd::load( &m.Column( 0 ).x );
+    __m128 c1 = simd::load( &m.Column( 1 ).x );
+    __m128 c2 = simd::load( &m.Column( 2 ).x );
+    __m128 c3 = simd::load( &m.Column( 3 ).x );
+
+    // sub matrices | A B |
+    //              | C D |
+    __m128 a = _mm_movelh_ps( c0, c1 );
+    __m128 b = _mm_movehl_ps( c1, c0 );
+    __m128 c = _mm_movelh_ps( c2, c3 );
+    __m128 d = _mm_movehl_ps( c3, c2 );
+
+    // ( |A|, |B|, |C|, |D| )
+    __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps( MATH_SHUFFLE( c0, c2, 0, 2, 0, 2 ), MATH_SHUFFLE( c1, c3, 1, 3, 1, 3 ) ),
+        _mm_mul_ps( MATH_SHUFFLE( c0, c2, 1, 3, 1, 3 ), MATH_SHUFFLE( c1, c3, 0, 2, 0, 2 ) ) );
+    __m128 detA = MATH_SWIZZLE( detSub, 0, 0, 0, 0 );
+    __m128 detB = MATH_SWIZZLE( detSub, 1, 1, 1, 1 );
+    __m128 detC = MATH_SWIZZLE( detSub, 2, 2, 2, 2 );
+    __m128 detD = MATH_SWIZZLE( detSub, 3, 3, 3, 3 );
+
+    __m128 dc = adjMul2( d, c );
+    __m128 ab = adjMul2( a, b );
+    __m128 x = _mm_sub_ps( _mm_mul_ps( detD, a ), mul2( b, dc ) );
+    __m128 w = _mm_sub_ps( _mm_mul_ps( detA, d ), mul2( c, ab ) );
+    __m128 y = _mm_sub_ps( _mm_mul_ps( detB, c ), mulAdj2( d, ab ) );
+    __m128 z = _mm_sub_ps( _mm_mul_ps( detC, b ), mulAdj2( a, dc ) );
+
+    // |M| = |A| |D| + |B| |C| - tr( adj(A) B adj(D) C )
+    __m128 detM = _mm_add_ps( _mm_mul_ps( detA, detD ), _mm_mul_ps( detB, detC ) );
+    __m128 tr = _mm_mul_ps( ab, MATH_SWIZZLE( dc, 0, 2, 1, 3 ) );
+    tr = _mm_add_ps( tr, MATH_SWIZZLE( tr, 1, 0, 3, 2 ) );
+    tr = _mm_add_ps( tr, MATH_SWIZZLE( tr, 2, 3, 0, 1 ) );
+    detM = _mm_sub_ps( detM, tr );
+
+    __m128 rDetM = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), detM );
+    x = _mm_mul_ps( x, rDetM );
+    y = _mm_mul_ps( y, rDetM );
+    z = _mm_mul_ps( z, rDetM );
+    w = _mm_mul_ps( w, rDetM );
+
+    Matrix4 r;
+    simd::store( &r.Column( 0 ).x, MATH_SHUFFLE( x, y, 3, 1, 3, 1 ) );
+    simd::store( &r.Column( 1 ).x, MATH_SHUFFLE( x, y, 2, 0, 2, 0 ) );
+    simd::store( &r.Column( 2 ).x, MATH_SHUFFLE( z, w, 3, 1, 3, 1 ) );
+    simd::store( &r.Column( 3 ).x, MATH_SHUFFLE( z, w, 2, 0, 2, 0 ) );
+    return r;
+}
+
+const Matrix4 AffineInverse( const Matrix4& m )
+{
+    __m128 mask = simd::maskXYZ();
+    __m128 c0 = _mm_and_ps( simd::load( &m.Column( 0 ).x ), mask );
+    __m128 c1 = _mm_and_ps( simd::load( &m.Column( 1 ).x ), mask );
+    __m128 c2 = _mm_and_ps( simd::load( &m.Column( 2 ).x ), mask );
+    __m128 tr = simd::load( &m.Column( 3 ).x );
+    // rows of inverse are cross products of columns divided by determinant
+    __m128 r0 = simd::cross3( c1, c2 );
+    __m128 r1 = simd::cross3( c2, c0 );
+    __m128 r2 = simd::cross3( c0, c1 );
+    __m128 detInv = _mm_div_ps( simd::splat( 1.0f ), simd::dot3( c2, r2 ) );
+    r0 = _mm_mul_ps( r0, detInv );
+    r1 = _mm_mul_ps( r1, detInv );
+    r2 = _mm_mul_ps( r2, detInv );
+    __m128 r3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+    __m128 t = _mm_add_ps( _mm_add_ps(
+        _mm_mul_ps( r0, MATH_SWIZZLE( tr, 0, 0, 0, 0 ) ),
+        _mm_mul_ps( r1, MATH_SWIZZLE( tr, 1, 1, 1, 1 ) ) ),
+        _mm_mul_ps( r2, MATH_SWIZZLE( tr, 2, 2, 2, 2 ) ) );
+    t = _mm_sub_ps( _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f ), t );
+    Matrix4 r;
+    simd::store( &r.Column( 0 ).x, r0 );
+    simd::store( &r.Column( 1 ).x, r1 );
+    simd::store( &r.Column( 2 ).x, r2 );
+    simd::store( &r.Column( 3 ).x, t );
+    return r;
+}
+
+const Matrix4 OrthoInverse( const Matrix4& m )
+{
+    __m128 mask = simd::maskXYZ();
+    __m128 c0 = _mm_and_ps( simd::load( &m.Column( 0 ).x ), mask );
+    __m128 c1 = _mm_and_ps( simd::load( &m.Column( 1 ).x ), mask );
+    __m128 c2 = _mm_and_ps( simd::load( &m.Column( 2 ).x ), mask );
+    __m128 c3 = _mm_setzero_ps();
+    __m128 tr = simd::load( &m.Column( 3 ).x );
+    _MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+    __m128 t = _mm_add_ps( _mm_add_ps(
+        _mm_mul_ps( c0, MATH_SWIZZLE( tr, 0, 0, 0, 0 ) ),
+        _mm_mul_ps( c1, MATH_SWIZZLE( tr, 1, 1, 1, 1 ) ) ),
+        _mm_mul_ps( c2, MATH_SWIZZLE( tr, 2, 2, 2, 2 ) ) );
+    t = _mm_sub_ps( _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f ), t );
+    Matrix4 r;
+    simd::store( &r.Column( 0 ).x, c0 );
+    simd::store( &r.Column( 1 ).x, c1 );
+    simd::store( &r.Column( 2 ).x, c2 );
+    simd::store( &r.Column( 3 ).x, t );
+    return r;
+}
+
+#else
+
 const Matrix4 Inverse( const Matrix4& m )
 {
     vec4f res0, res1, res2, res3;
@@ -178,6 +315,8 @@ const Matrix4 OrthoInverse( const Matrix4& m )
            );
 }
 
+#endif // MATH_SSE
+
 f32 Determinant( const Matrix4& m )
 {
     vec4f res0;
@@ -44,6 +44,10 @@ public:
     const vec4f Row( u32 i ) const;
     f32 Elem( u32 i, u32 j ) const;
 
+    //! Column by reference, SIMD code loads and stores through it
+    vec4f& Column( u32 i ) { return *( &column0_ + i ); }
+    const vec4f& Column( u32 i ) const { return *( &column0_ + i ); }
+
 public:
     const Matrix4 operator +( const Matrix4& m ) const;
     const Matrix4 operator -( const Matrix4& m ) const;
@@ -6,6 +6,7 @@
 #include "math/quat.h"
 #include "math/matrix-inl.h"
 #include "math/mathlib.h"
+#include "math/simd.h"
 
 namespace base
 {
@@ -116,13 +117,39 @@ Quat Quat::operator- ( const Quat& _q ) const
     return q;
 }
 
+#ifdef MATH_SSE
+
+Quat Quat::operator* ( const Quat& _q ) const
+{
+    __m128 a = simd::load( &x );
+    __m128 b = simd::load( &_q.x );
+    // signs are applied by xor with -0.0f
+    const __m128 signX = _mm_setr_ps( 0.0f, -0.0f, 0.0f, -0.0f );
+    const __m128 signY = _mm_setr_ps( 0.0f, 0.0f, -0.0f, -0.0f );
+    const __m128 signZ = _mm_setr_ps( -0.0f, 0.0f, 0.0f, -0.0f );
+    __m128 r = _mm_mul_ps( MATH_SWIZZLE( a, 3, 3, 3, 3 ), b );
+    r = _mm_add_ps( r, _mm_mul_ps( MATH_SWIZZLE( a, 0, 0, 0, 0 ),
+                                   _mm_xor_ps( MATH_SWIZZLE( b, 3, 2, 1, 0 ), signX ) ) );
+    r = _mm_add_ps( r, _mm_mul_ps( MATH_SWIZZLE( a, 1, 1, 1, 1 ),
+                                   _mm_xor_ps( MATH_SWIZZLE( b, 2, 3, 0, 1 ), signY ) ) );
+    r = _mm_add_ps( r, _mm_mul_ps( MATH_SWIZZLE( a, 2, 2, 2, 2 ),
+                                   _mm_xor_ps( MATH_SWIZZLE( b, 1, 0, 3, 2 ), signZ ) ) );
+    Quat q;
+    simd::store( &q.x, r );
+    return q;
+}
+
+#else
+
 Quat Quat::operator* ( const Quat& _q ) const
 {
     return Quat( y * _q.z - z * _q.y + w * _q.x + x * _q.w,
                  z * _q.x - x * _q.z + w * _q.y + y * _q.w,
                  x * _q.y - y * _q.x + w * _q.z + z * _q.w,
                  w * _q.w - x * _q.x - y * _q.y - z * _q.z );
-};
+}
+
+#endif // MATH_SSE
 
 vec3f Quat::RotatePoint( const vec3f& v ) const
 {
@@ -180,11 +207,12 @@ Quat Quat::GetRotation( const vec3f& axis, f32 angle )
 
     if ( len ) {
         len = 1.0f / len;
-        f32 sinangle = sin( angle / 2.0f );
+        f32 sinangle, cosangle;
+        fast::sincos( angle / 2.0f, sinangle, cosangle );
         q.x = axis.x * len * sinangle;
         q.y = axis.y * len * sinangle;
         q.z = axis.z * len * sinangle;
-        q.w = cosf( angle / 2.0f );
+        q.w = cosangle;
     } else {
         q.x = q.y = q.z = 0.0f;
         q.w = 1.0f;
@@ -284,9 +312,9 @@ Matrix4 Quat::GetMatrix() const
     wx = w * x2;
     wy = w * y2;
     wz = w * z2;
-    m.SetCol1( vec4f( 1.0f - ( yy + zz ), xy - wz, xz + wy, 0.0f ) );
-    m.SetCol2( vec4f( xy + wz, 1.0f - ( xx + zz ), yz - wx, 0.0f ) );
-    m.SetCol3( vec4f( xz - wy, yz + wx, 1.0f - ( xx + yy ), 0.0f ) );
+    m.SetCol0( vec4f( 1.0f - ( yy + zz ), xy + wz, xz - wy, 0.0f ) );
+    m.SetCol1( vec4f( xy - wz, 1.0f - ( xx + zz ), yz + wx, 0.0f ) );
+    m.SetCol2( vec4f( xz + wy, yz - wx, 1.0f - ( xx + yy ), 0.0f ) );
     return m;
 }
 
@@ -0,0 +1,107 @@
+/**
+ * \file
+ * \brief       SSE helpers for math classes
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ *
+ * MATH_SSE is defined when SSE2 is available at compile time (always on x86-64),
+ * define NEGINE_NO_SIMD to build scalar fallback.
+ * Loads and stores are unaligned: matrices live inside Python objects and
+ * packed parameter blocks which do not guarantee 16 byte alignment, and
+ * unaligned access to aligned data costs nothing on current CPUs.
+ *
+ * MATH_AVX2 is defined when compiler can build AVX2/FMA functions without
+ * global -m flags; such functions are marked MATH_TARGET_AVX2 and are only
+ * called when cpu::tier() allows it
+ **/
+#pragma once
+
+#include "base/types.h"
+
+#if !defined(NEGINE_NO_SIMD) && defined(OS_CPU_X86) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+# define MATH_SSE
+#endif
+
+#if defined(MATH_SSE) && !defined(NEGINE_NO_AVX2)
+# define MATH_AVX2
+# if defined(COMPILER_MSVC)
+#  define MATH_TARGET_AVX2
+# else
+#  define MATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+# endif
+#endif
+
+#ifdef MATH_SSE
+# include <emmintrin.h>
+#endif
+#ifdef MATH_AVX2
+# include <immintrin.h>
+#endif
+
+#ifdef MATH_SSE
+
+namespace base
+{
+namespace math
+{
+namespace simd
+{
+
+#define MATH_SHUFFLE_MASK( x, y, z, w ) ( ( x ) | ( ( y ) << 2 ) | ( ( z ) << 4 ) | ( ( w ) << 6 ) )
+//! Result lanes are (a[x], a[y], b[z], b[w])
+#define MATH_SHUFFLE( a, b, x, y, z, w ) _mm_shuffle_ps( ( a ), ( b ), MATH_SHUFFLE_MASK( x, y, z, w ) )
+#define MATH_SWIZZLE( a, x, y, z, w ) \
+    _mm_castsi128_ps( _mm_shuffle_epi32( _mm_castps_si128( a ), MATH_SHUFFLE_MASK( x, y, z, w ) ) )
+
+inline __m128 load( const f32* p ) { return _mm_loadu_ps( p ); }
+inline void store( f32* p, __m128 v ) { _mm_storeu_ps( p, v ); }
+inline __m128 splat( f32 a ) { return _mm_set1_ps( a ); }
+
+//! Dot product of four lanes in every lane
+inline __m128 dot4( __m128 a, __m128 b )
+{
+    __m128 m = _mm_mul_ps( a, b );
+    m = _mm_add_ps( m, MATH_SWIZZLE( m, 1, 0, 3, 2 ) );
+    return _mm_add_ps( m, MATH_SWIZZLE( m, 2, 3, 0, 1 ) );
+}
+
+//! Dot product of xyz lanes in every lane
+inline __m128 dot3( __m128 a, __m128 b )
+{
+    __m128 m = _mm_mul_ps( a, b );
+    __m128 x = MATH_SWIZZLE( m, 0, 0, 0, 0 );
+    __m128 y = MATH_SWIZZLE( m, 1, 1, 1, 1 );
+    __m128 z = MATH_SWIZZLE( m, 2, 2, 2, 2 );
+    return _mm_add_ps( _mm_add_ps( x, y ), z );
+}
+
+//! Cross product of xyz lanes, w lane is 0
+inline __m128 cross3( __m128 a, __m128 b )
+{
+    __m128 a1 = MATH_SWIZZLE( a, 1, 2, 0, 3 );
+    __m128 b1 = MATH_SWIZZLE( b, 1, 2, 0, 3 );
+    __m128 c = _mm_sub_ps( _mm_mul_ps( a, b1 ), _mm_mul_ps( a1, b ) );
+    return MATH_SWIZZLE( c, 1, 2, 0, 3 );
+}
+
+//! Linear combination of four columns by lanes of v: c0 * v.x + c1 * v.y + c2 * v.z + c3 * v.w
+inline __m128 combine( __m128 v, __m128 c0, __m128 c1, __m128 c2, __m128 c3 )
+{
+    __m128 r = _mm_mul_ps( c0, MATH_SWIZZLE( v, 0, 0, 0, 0 ) );
+    r = _mm_add_ps( r, _mm_mul_ps( c1, MATH_SWIZZLE( v, 1, 1, 1, 1 ) ) );
+    r = _mm_add_ps( r, _mm_mul_ps( c2, MATH_SWIZZLE( v, 2, 2, 2, 2 ) ) );
+    return _mm_add_ps( r, _mm_mul_ps( c3, MATH_SWIZZLE( v, 3, 3, 3, 3 ) ) );
+}
+
+//! Mask which clears w lane
+inline __m128 maskXYZ()
+{
+    return _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+}
+
+} // namespace simd
+} // namespace math
+} // namespace base
+
+#endif // MATH_SSE
@@ -8,6 +8,7 @@
 
 #include "base/types.h"
 #include "math/mathlib.h"
+#include "math/fastmath.h"
 
 namespace base
 {
@@ -65,7 +66,7 @@ typedef vec2<i32> vec2i;
 inline f32 dot( const vec2f& a, const vec2f& b ) { return a.x * b.x + a.y * b.y; }
 inline f32 length( const vec2f& a ) { return sqrt( dot( a, a ) ); }
 inline f32 length2( const vec2f& a ) { return dot( a, a ); }
-inline vec2f normalize( const vec2f& v ) { return v / length( v ); }
+inline vec2f normalize( const vec2f& v ) { return v * fast::rsqrt( dot( v, v ) ); }
 
 }
 }
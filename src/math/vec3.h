@@ -70,7 +70,7 @@ typedef vec3<i32> vec3i;
 inline f32 dot( const vec3f& a, const vec3f& b ) { return a.x * b.x + a.y * b.y + a.z * b.z; }
 inline f32 length( const vec3f& a ) { return sqrt( dot( a, a ) ); }
 inline f32 length2( const vec3f& a ) { return dot( a, a ); }
-inline vec3f normalize( const vec3f& v ) { return v / length( v ); }
+inline vec3f normalize( const vec3f& v ) { return v * fast::rsqrt( dot( v, v ) ); }
 
 template<typename T> inline vec3<T> cross( const vec3<T>& a, const vec3<T>& b ) {
     return vec3<T>( a.y * b.z - a.z * b.y,  a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x );
@@ -72,7 +72,7 @@ typedef vec4<f32> vec4f;
 inline f32 dot( const vec4f& a, const vec4f& b ) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
 inline f32 length( const vec4f& a ) { return sqrt( dot( a, a ) ); }
 inline f32 length2( const vec4f& a ) { return dot( a, a ); }
-inline vec4f normalize( const vec4f& v ) { return v / length( v ); }
+inline vec4f normalize( const vec4f& v ) { return v * fast::rsqrt( dot( v, v ) ); }
 
 }
 }
@@ -1,14 +1,32 @@
 #include "physics/physics.h"
 #include <btBulletDynamicsCommon.h>
 #include "game/components/transform.h"
+#include "base/memorytags.h"
 
 #include <iostream>
 
 namespace base {
 namespace phys {
 
+static void* physicsAlloc(size_t size, int alignment)
+{
+    return memory::allocator(MemoryTag::Physics).allocate(static_cast<u32>(size), static_cast<u32>(alignment));
+}
+
+static void* physicsAllocUnaligned(size_t size)
+{
+    return memory::allocator(MemoryTag::Physics).allocate(static_cast<u32>(size), 16);
+}
+
+static void physicsFree(void* p)
+{
+    memory::allocator(MemoryTag::Physics).deallocate(p);
+}
+
 Physics::Physics()
 {
+    btAlignedAllocSetCustom(physicsAllocUnaligned, physicsFree);
+    btAlignedAllocSetCustomAligned(physicsAlloc, physicsFree);
     broadphase_ = new btDbvtBroadphase;
     collisionConfiguration_ = new btDefaultCollisionConfiguration;
     collisionDispatcher_ = new btCollisionDispatcher(collisionConfiguration_);
@@ -25,13 +43,16 @@ Physics::~Physics()
     delete collisionDispatcher_;
     delete collisionConfiguration_;
     delete broadphase_;
+    // hooks stay: bodies still owned by scene are freed later, the physics
+    // allocator outlives memory::shutdown for them
 }
 
-void Physics::simulate(f32 dt)
+void Physics::simulate(u64 elapsed)
 {
-    const f32 timeStep = 1 / 60.f;
+    const f64 timeStep = 1 / 60.0;
+    f64 dt = elapsed / 1e9;
     int numSteps = (int)(dt / timeStep) + 1;
-    world_->stepSimulation(dt, numSteps);
+    world_->stepSimulation(static_cast<btScalar>(dt), numSteps, static_cast<btScalar>(timeStep));
 }
 
 class MotionState : public btMotionState {
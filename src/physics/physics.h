@@ -27,7 +27,8 @@ public:
     Physics();
     ~Physics();
 
-    NEGINE_API void simulate(f32 dt);
+    //! Advances world by elapsed time in nanoseconds
+    NEGINE_API void simulate(u64 elapsed);
 private:
     btBroadphaseInterface* broadphase_;
     btDefaultCollisionConfiguration* collisionConfiguration_;
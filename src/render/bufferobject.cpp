@@ -40,9 +40,9 @@ void BufferObject::bindBase( u32 index )
     GL.BindBufferBase( target_, index, id_ );
 }
 
-void BufferObject::bindRange( u32 index, void* offset, void* size )
+void BufferObject::bindRange( u32 index, u32 offset, u32 size )
 {
-    GL.BindBufferRange( target_, index, id_, reinterpret_cast<GLintptr>(offset), reinterpret_cast<GLsizeiptr>(size) );
+    GL.BindBufferRange( target_, index, id_, offset, size );
 }
 
 void BufferObject::setData( u32 size, const void* dataPtr )
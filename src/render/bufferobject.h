@@ -52,7 +52,7 @@ public:
     //! Bind buffer to target by index
     void bindBase( u32 index );
     //! Bind buffer to target by index, and to desired position
-    void bindRange( u32 index, void* offset, void* size );
+    void bindRange( u32 index, u32 offset, u32 size );
 
     //! Sets data of buffer, copy from memory to GPU
     void setData( u32 size, const void* dataPtr );
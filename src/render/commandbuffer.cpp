@@ -0,0 +1,302 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "render/commandbuffer.h"
+#include "render/glcontext.h"
+#include "render/gpuprogram.h"
+#include "render/renderstate.h"
+#include "render/streambuffer.h"
+#include "base/parameter.h"
+#include "base/log.h"
+#include "base/profiler.h"
+#include <string.h>
+#include <algorithm>
+
+namespace base
+{
+namespace opengl
+{
+
+namespace
+{
+
+const u32 kRadixBits = 8;
+const u32 kRadixPasses = 64 / kRadixBits;
+const u32 kBuckets = 1 << kRadixBits;
+const u32 kNoRange = ~0u;
+
+//! Top 24 bits of positive float keep its order, negative and NaN go to 0
+u32 depthBits(f32 depth)
+{
+    if (!(depth > 0.0f))
+        return 0;
+    u32 bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return bits >> 8;
+}
+
+//! Stable LSD radix sort by 8-bit digits, result in items.
+//! Digits which are equal for all keys are skipped
+template<typename T>
+void radixSort(std::vector<T>& items, std::vector<T>& scratch)
+{
+    const u32 count = static_cast<u32>(items.size());
+    scratch.resize(count);
+    u32 histogram[kRadixPasses][kBuckets];
+    memset(histogram, 0, sizeof(histogram));
+    for (u32 i = 0; i < count; i++) {
+        u64 key = items[i].key;
+        for (u32 pass = 0; pass < kRadixPasses; pass++)
+            histogram[pass][(key >> (pass * kRadixBits)) & (kBuckets - 1)]++;
+    }
+
+    T* from = items.data();
+    T* to = scratch.data();
+    for (u32 pass = 0; pass < kRadixPasses; pass++) {
+        u32* h = histogram[pass];
+        const u32 shift = pass * kRadixBits;
+        if (count == 0 || h[(from[0].key >> shift) & (kBuckets - 1)] == count)
+            continue;
+        u32 offset = 0;
+        for (u32 b = 0; b < kBuckets; b++) {
+            u32 n = h[b];
+            h[b] = offset;
+            offset += n;
+        }
+        for (u32 i = 0; i < count; i++)
+            to[h[(from[i].key >> shift) & (kBuckets - 1)]++] = from[i];
+        T* t = from;
+        from = to;
+        to = t;
+    }
+    if (from != items.data())
+        items.swap(scratch);
+}
+
+} // namespace
+
+CommandBuffer::CommandBuffer()
+    : sorted_(true)
+{
+}
+
+void CommandBuffer::clear()
+{
+    commands_.clear();
+    items_.clear();
+    programIds_.clear();
+    materialIds_.clear();
+    sorted_ = true;
+}
+
+u64 CommandBuffer::makeKey(u32 pass, u32 program, u32 material, f32 depth)
+{
+    return (static_cast<u64>(pass & 0xff) << 56)
+        | (static_cast<u64>(program & 0xffff) << 40)
+        | (static_cast<u64>(material & 0xffff) << 24)
+        | depthBits(depth);
+}
+
+u32 CommandBuffer::idOf(IdMap& ids, const void* object)
+{
+    const u32 id = ids.insert(std::make_pair(object, static_cast<u32>(ids.size()))).first->second;
+    // larger ids would alias in key and break grouping of draws
+    ASSERT(id <= 0xffff);
+    return id;
+}
+
+void CommandBuffer::add(u32 pass, f32 depth, const DrawCommand& command)
+{
+    ASSERT(command.instances > 0);
+    SortItem item;
+    item.key = makeKey(pass, idOf(programIds_, command.program), idOf(materialIds_, command.materialParams), depth);
+    item.index = static_cast<u32>(commands_.size());
+    commands_.push_back(command);
+    items_.push_back(item);
+    sorted_ = false;
+}
+
+void CommandBuffer::sort()
+{
+    if (sorted_)
+        return;
+    radixSort(items_, scratch_);
+    sorted_ = true;
+}
+
+//! Allocates block in stream and fills it by params, in order, later ones win
+static u32 packBlock(StreamBuffer& stream, u32 alignment, const UniformBlockLayout& layout,
+    const Params* first, const Params* second, const Params* third)
+{
+    StreamBuffer::Allocation allocation = stream.allocate(layout.size, alignment);
+    if (allocation.data == nullptr) {
+        ERR("stream buffer is full, uniform block is not updated");
+        return kNoRange;
+    }
+    memset(allocation.data, 0, layout.size);
+    layout.pack(*first, allocation.data);
+    if (second != nullptr)
+        layout.pack(*second, allocation.data);
+    if (third != nullptr)
+        layout.pack(*third, allocation.data);
+    return allocation.offset;
+}
+
+// Follows the same state changes as submit()
+void CommandBuffer::packBlocks(DeviceContext& GL, const Params& passParams, StreamBuffer& stream)
+{
+    const u32 alignment = GL.uniformAlignment();
+    const u32 count = size();
+    ranges_.resize(count);
+    objectRanges_.clear();
+    const GpuProgram* program = nullptr;
+    const Params* material = nullptr;
+    bool restoreMaterial = false;
+    // pass values are same for all draws, programs share Frame block while its layout is same
+    const UniformBlockLayout* frameLayout = nullptr;
+    u32 frameOffset = kNoRange;
+    u32 boundFrame = kNoRange;
+    // block which did not fit stays missing until it is packed again
+    bool frameMissing = false;
+    bool materialMissing = false;
+    for (u32 i = 0; i < count; i++) {
+        const DrawCommand& command = sorted(i);
+        BlockRanges& ranges = ranges_[i];
+        for (u32 b = 0; b < UniformBlocks::Count; b++)
+            ranges.offset[b] = kNoRange;
+        ranges.skip = false;
+        bool materialChanged = command.materialParams != material || restoreMaterial;
+        if (command.program != program) {
+            program = command.program;
+            materialChanged = true;
+            const UniformBlockLayout& frame = program->block(UniformBlocks::Frame);
+            frameMissing = false;
+            if (frame.valid()) {
+                if (frameLayout == nullptr || !frameLayout->sameLayout(frame)) {
+                    frameLayout = &frame;
+                    frameOffset = packBlock(stream, alignment, frame, &passParams, nullptr, nullptr);
+                    boundFrame = kNoRange;
+                }
+                frameMissing = frameOffset == kNoRange;
+                if (!frameMissing && frameOffset != boundFrame) {
+                    ranges.offset[UniformBlocks::Frame] = frameOffset;
+                    boundFrame = frameOffset;
+                }
+            }
+        }
+        material = command.materialParams;
+        restoreMaterial = command.meshParams != nullptr && !command.meshParams->empty();
+        const UniformBlockLayout& materialBlock = program->block(UniformBlocks::Material);
+        if (!materialBlock.valid()) {
+            materialMissing = false;
+        } else if (materialChanged || restoreMaterial) {
+            ranges.offset[UniformBlocks::Material] = packBlock(stream, alignment, materialBlock,
+                material, restoreMaterial ? command.meshParams : nullptr, &passParams);
+            materialMissing = ranges.offset[UniformBlocks::Material] == kNoRange;
+        }
+        if (frameMissing || materialMissing) {
+            ranges.skip = true;
+            continue;
+        }
+        const UniformBlockLayout& object = program->block(UniformBlocks::Object);
+        if (!object.valid())
+            continue;
+        // one block for each draw, which takes up to capacity instances
+        ranges.offset[UniformBlocks::Object] = static_cast<u32>(objectRanges_.size());
+        const u32 capacity = program->instanceCapacity();
+        for (u32 first = 0; first < command.instances; first += capacity) {
+            StreamBuffer::Allocation allocation = stream.allocate(object.size, alignment);
+            if (allocation.data == nullptr) {
+                ERR("stream buffer is full, uniform block is not updated");
+                objectRanges_.push_back(kNoRange);
+                continue;
+            }
+            memset(allocation.data, 0, object.size);
+            const u32 last = std::min(first + capacity, command.instances);
+            for (u32 k = first; k < last; k++)
+                object.write(STRING_ID("mvp"), ParamType::Mat4, command.mvp + k, allocation.data, k - first);
+            objectRanges_.push_back(allocation.offset);
+        }
+    }
+    stream.flush();
+}
+
+CommandBuffer::Stats CommandBuffer::submit(DeviceContext& GL, const Params& passParams, StreamBuffer* stream)
+{
+    sort();
+    if (stream != nullptr)
+        packBlocks(GL, passParams, *stream);
+    Stats stats = { 0, 0, 0, 0 };
+    GpuProgram* program = nullptr;
+    UniformHandle mvp = kInvalidUniform;
+    u32 capacity = 1;
+    const Params* material = nullptr;
+    // material values were overridden by mesh ones and have to be set again
+    bool restoreMaterial = false;
+    const u32 count = size();
+    for (u32 i = 0; i < count; i++) {
+        const DrawCommand& command = sorted(i);
+        if (command.program != program) {
+            program = command.program;
+            GL.setProgram(program);
+            mvp = program->uniformHandle(STRING_ID("mvp"));
+            // instances need mvp array in stream, otherwise they are drawn one by one
+            capacity = stream != nullptr ? program->instanceCapacity() : 1;
+            material = nullptr;
+            stats.programChanges++;
+        }
+        if (command.materialParams != material || restoreMaterial) {
+            material = command.materialParams;
+            program->setParams(*material);
+            program->setParams(passParams);
+            stats.materialChanges++;
+        }
+        restoreMaterial = command.meshParams != nullptr && !command.meshParams->empty();
+        if (restoreMaterial) {
+            program->setParams(*command.meshParams);
+            program->setParams(passParams);
+        }
+        u32 object = kNoRange;
+        if (stream != nullptr) {
+            const BlockRanges& ranges = ranges_[i];
+            for (u32 b = UniformBlocks::Frame; b < UniformBlocks::Object; b++) {
+                if (ranges.offset[b] != kNoRange)
+                    stream->buffer().bindRange(b, ranges.offset[b], program->block(static_cast<UniformBlockBinding>(b)).size);
+            }
+            object = ranges.offset[UniformBlocks::Object];
+            if (ranges.skip)
+                continue;
+        }
+        for (u32 first = 0; first < command.instances; first += capacity) {
+            if (object != kNoRange) {
+                // block did not fit into stream, bound one holds matrices of other draw
+                u32 offset = objectRanges_[object++];
+                if (offset == kNoRange)
+                    continue;
+                stream->buffer().bindRange(UniformBlocks::Object, offset, program->block(UniformBlocks::Object).size);
+            }
+            // mvp in Object block is not an active uniform, handle is invalid
+            program->setUniform(mvp, command.mvp[first]);
+            GL.renderState().render(*command.mesh, command.from, command.count, std::min(capacity, command.instances - first));
+            stats.draws++;
+        }
+        stats.instances += command.instances;
+    }
+
+    if (Profiler::enabled()) {
+        static const u32 drawsId = Profiler::intern("render.draws");
+        static const u32 programsId = Profiler::intern("render.programChanges");
+        static const u32 materialsId = Profiler::intern("render.materialChanges");
+        static const u32 instancesId = Profiler::intern("render.instances");
+        Profiler::counter(drawsId) = static_cast<f32>(stats.draws);
+        Profiler::counter(instancesId) = static_cast<f32>(stats.instances);
+        Profiler::counter(programsId) = static_cast<f32>(stats.programChanges);
+        Profiler::counter(materialsId) = static_cast<f32>(stats.materialChanges);
+    }
+    return stats;
+}
+
+} // namespace opengl
+} // namespace base
@@ -0,0 +1,128 @@
+/**
+ * \file
+ * \brief       Sorted buffer of draw commands
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ *
+ * Draws are recorded as small packets with 64-bit sort key, radix sorted
+ * and submitted in key order, so draws sharing program and material go
+ * together and state is set only when it changes.
+ *
+ * Key layout, from high bits: pass (8), program (16), material (16), depth (24)
+ *
+ * With stream buffer, programs which declare Frame, Material and Object
+ * uniform blocks get their values packed into the stream before the first
+ * draw; then each draw costs one BindBufferRange for Object block, and
+ * Material range is bound only when program or material change. Frame block
+ * is packed once and bound again only when program has other layout of it.
+ * Draw whose blocks do not fit into stream is skipped, stream tells how
+ * much it had to hold, so owner can grow it.
+ *
+ * Command may draw several instances of mesh. Program with mvp array in
+ * Object block draws them by instanced draws of up to array size copies,
+ * other programs draw them one by one
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "math/matrix.h"
+#include "render/uniformblock.h"
+#include <vector>
+#include <unordered_map>
+
+namespace base
+{
+class Params;
+
+namespace opengl
+{
+
+class DeviceContext;
+class GpuProgram;
+class Mesh;
+class StreamBuffer;
+
+//! One draw. Pointed objects have to stay alive until submit()
+struct DrawCommand
+{
+    const Mesh* mesh;
+    GpuProgram* program;
+    const Params* materialParams;   //!< shared by all meshes of material, identifies material
+    const Params* meshParams;
+    const math::Matrix4* mvp;       //!< instances matrices, one after another
+    u32 instances;
+    u32 from;
+    u32 count;
+};
+
+class CommandBuffer
+{
+public:
+    //! State changes made by submit()
+    struct Stats
+    {
+        u32 draws;
+        u32 instances;
+        u32 programChanges;
+        u32 materialChanges;
+    };
+
+    NEGINE_API CommandBuffer();
+
+    //! Removes recorded commands and ids of their programs and materials
+    NEGINE_API void clear();
+
+    //! Records draw. Pass orders groups of draws, depth is view distance,
+    //! draws with same program and material go front to back
+    NEGINE_API void add(u32 pass, f32 depth, const DrawCommand& command);
+
+    //! Sorts commands by key
+    NEGINE_API void sort();
+
+    //! Sorts and issues commands. Parameters are applied in order material,
+    //! mesh, passParams, so later ones win; mvp goes to "mvp" uniform.
+    //! Uniform blocks are filled from stream, when it is given
+    NEGINE_API Stats submit(DeviceContext& context, const Params& passParams, StreamBuffer* stream = nullptr);
+
+    u32 size() const { return static_cast<u32>(commands_.size()); }
+    //! Command in sorted order, valid after sort()
+    const DrawCommand& sorted(u32 i) const { return commands_[items_[i].index]; }
+    u64 sortedKey(u32 i) const { return items_[i].key; }
+
+    NEGINE_API static u64 makeKey(u32 pass, u32 program, u32 material, f32 depth);
+
+private:
+    struct SortItem
+    {
+        u64 key;
+        u32 index;
+    };
+
+    //! Offsets of block ranges to bind before sorted draw, kNoRange when
+    //! binding stays as is. Object one is index of first range in objectRanges_
+    struct BlockRanges
+    {
+        u32 offset[UniformBlocks::Count];
+        bool skip;      //!< some block did not fit into stream, draw would read values of other one
+    };
+
+    typedef std::unordered_map<const void*, u32> IdMap;
+
+    //! Dense 16-bit id of object, in order of first use since clear()
+    static u32 idOf(IdMap& ids, const void* object);
+
+    //! Packs uniform blocks of all draws into stream, fills ranges_
+    void packBlocks(DeviceContext& context, const Params& passParams, StreamBuffer& stream);
+
+    std::vector<DrawCommand> commands_;
+    std::vector<SortItem> items_;
+    std::vector<SortItem> scratch_;
+    std::vector<BlockRanges> ranges_;
+    std::vector<u32> objectRanges_;
+    IdMap programIds_;
+    IdMap materialIds_;
+    bool sorted_;
+};
+
+} // namespace opengl
+} // namespace base
@@ -147,7 +147,7 @@ void Framebuffer::complete() {
     const char* message = nullptr;
     completed_ = checkStatus(message);
     if (!completed_) {
-        ERR(message);
+        ERR("%s", message);
     }
     initialized_ = true;
 
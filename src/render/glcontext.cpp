@@ -3,6 +3,7 @@
 #include "base/debug.h"
 #include "render/renderstate.h"
 #include <type_traits>
+#include <string.h>
 #include "render/bufferobject.h"
 #include "render/gpuprogram.h"
 
@@ -89,6 +90,11 @@ void DeviceContext::setFramebuffer(Framebuffer* fbo) {
     state->framebuffer.set(fbo);
 }
 
+void DeviceContext::forgetProgram(const GpuProgram& program) {
+    if (state != NULL)
+        state->forgetProgram(program);
+}
+
 #ifdef OS_WIN
 class Library
 {
@@ -182,6 +188,9 @@ private:
 DeviceContext::DeviceContext()
     : loader(NULL)
     , state(NULL)
+    , uniformAlignment_(0)
+    , packedFormatsQueried_(false)
+    , packedFormats_(false)
 {
 }
 
@@ -197,6 +206,7 @@ void DeviceContext::init()
     loader = new GLFuncLoader;
 
     #define LOAD_GL(name) loader->getPointerWrap( name, "gl"#name );
+    #define LOAD_GL_OPTIONAL(name) name = loader->getPointer<decltype(name)>( "gl"#name );
     
     LOAD_GL(ActiveTexture                    );
     LOAD_GL(AttachShader                     );
@@ -208,40 +218,53 @@ void DeviceContext::init()
     LOAD_GL(BindVertexArray                  );
     LOAD_GL(BufferData                       );
     LOAD_GL(BufferSubData                    );
+    LOAD_GL_OPTIONAL(BufferStorage           );
     LOAD_GL(CompileShader                    );
     LOAD_GL(CreateProgram                    );
     LOAD_GL(CreateShader                     );
+    LOAD_GL_OPTIONAL(ClientWaitSync          );
     LOAD_GL(DeleteBuffers                    );
     LOAD_GL(DeleteProgram                    );
     LOAD_GL(DeleteShader                     );
+    LOAD_GL_OPTIONAL(DeleteSync              );
     LOAD_GL(DeleteTextures                   );
     LOAD_GL(DeleteVertexArrays               );
     LOAD_GL(DetachShader                     );
     LOAD_GL(DisableVertexAttribArray         );
     LOAD_GL(DrawElements                     );
+    LOAD_GL(DrawElementsInstanced            );
     LOAD_GL(DrawArrays                       );
+    LOAD_GL(DrawArraysInstanced              );
     LOAD_GL(EnableVertexAttribArray          );
+    LOAD_GL_OPTIONAL(FenceSync               );
     LOAD_GL(GenBuffers                       );
     LOAD_GL(GenTextures                      );
     LOAD_GL(GenVertexArrays                  );
     LOAD_GL(GenerateMipmap                   );
     LOAD_GL(GetActiveUniform                 );
+    LOAD_GL(GetActiveUniformBlockiv          );
+    LOAD_GL(GetActiveUniformBlockName        );
+    LOAD_GL(GetActiveUniformsiv              );
     LOAD_GL(GetBufferSubData                 );
     LOAD_GL(GetProgramInfoLog                );
     LOAD_GL(GetProgramiv                     );
     LOAD_GL(GetShaderInfoLog                 );
     LOAD_GL(GetShaderiv                      );
     LOAD_GL(GetUniformLocation               );
+    LOAD_GL(GetIntegerv                      );
     LOAD_GL(LinkProgram                      );
+    LOAD_GL(MapBufferRange                   );
     LOAD_GL(ShaderSource                     );
     LOAD_GL(TexImage2D                       );
     LOAD_GL(TexParameteri                    );
     LOAD_GL(TexParameterf);
+    LOAD_GL(UniformBlockBinding              );
     LOAD_GL(Uniform1i                        );
     LOAD_GL(Uniform1f                        );
     LOAD_GL(Uniform3f                        );
     LOAD_GL(Uniform4f                        );
     LOAD_GL(UniformMatrix4fv                 );
+    LOAD_GL(UnmapBuffer                      );
     LOAD_GL(UseProgram                       );
     LOAD_GL(VertexAttribPointer              );
 
@@ -251,6 +274,7 @@ void DeviceContext::init()
     LOAD_GL(GetError                         );
     LOAD_GL(Disable                          );
     LOAD_GL(GetString                        );
+    LOAD_GL(GetStringi                       );
     LOAD_GL(BlendFunc                        );
     LOAD_GL(Viewport                         );
     LOAD_GL(DepthMask                        );
@@ -270,9 +294,46 @@ void DeviceContext::init()
     LOAD_GL(DeleteRenderbuffers              );
 
     #undef LOAD_GL
+    #undef LOAD_GL_OPTIONAL
+
+    createState();
+}
 
+void DeviceContext::createState()
+{
+    ASSERT(state == NULL);
     state = new RenderState(*this);
 }
 
+u32 DeviceContext::uniformAlignment()
+{
+    if (uniformAlignment_ == 0) {
+        GLint alignment = 0;
+        GetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        // spec guarantees power of two, no more than 256
+        uniformAlignment_ = alignment > 0 ? static_cast<u32>(alignment) : 256;
+    }
+    return uniformAlignment_;
+}
+
+bool DeviceContext::packedVertexFormats()
+{
+    if (!packedFormatsQueried_) {
+        packedFormatsQueried_ = true;
+        GLint major = 0, minor = 0;
+        GetIntegerv(GL_MAJOR_VERSION, &major);
+        GetIntegerv(GL_MINOR_VERSION, &minor);
+        packedFormats_ = major > 3 || (major == 3 && minor >= 3);
+        GLint count = 0;
+        if (!packedFormats_)
+            GetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count && !packedFormats_; i++) {
+            const char* name = reinterpret_cast<const char*>(GetStringi(GL_EXTENSIONS, i));
+            packedFormats_ = name != nullptr && strcmp(name, "GL_ARB_vertex_type_2_10_10_10_rev") == 0;
+        }
+    }
+    return packedFormats_;
+}
+
 }
 }
@@ -41,41 +41,54 @@ public:
     PFNGLBINDTEXTUREPROC        BindTexture;
     PFNGLBINDVERTEXARRAYPROC    BindVertexArray;
     PFNGLBUFFERDATAPROC         BufferData;
+    PFNGLBUFFERSTORAGEPROC      BufferStorage;      //!< GL 4.4, may be null
     PFNGLBUFFERSUBDATAPROC      BufferSubData;
     PFNGLCOMPILESHADERPROC      CompileShader;
     PFNGLCREATEPROGRAMPROC      CreateProgram;
     PFNGLCREATESHADERPROC       CreateShader;
+    PFNGLCLIENTWAITSYNCPROC     ClientWaitSync;     //!< may be null, as other sync functions
     PFNGLDELETEBUFFERSPROC      DeleteBuffers;
     PFNGLDELETEPROGRAMPROC      DeleteProgram;
     PFNGLDELETESHADERPROC       DeleteShader;
+    PFNGLDELETESYNCPROC         DeleteSync;
     PFNGLDELETETEXTURESPROC     DeleteTextures;
     PFNGLDELETEVERTEXARRAYSPROC DeleteVertexArrays;
     PFNGLDETACHSHADERPROC       DetachShader;
     PFNGLDISABLEVERTEXATTRIBARRAYPROC   DisableVertexAttribArray;
     PFNGLENABLEVERTEXATTRIBARRAYPROC    EnableVertexAttribArray;
     PFNGLDRAWELEMENTSPROC       DrawElements;
+    PFNGLDRAWELEMENTSINSTANCEDPROC      DrawElementsInstanced;
     PFNGLDRAWARRAYSPROC         DrawArrays;
+    PFNGLDRAWARRAYSINSTANCEDPROC        DrawArraysInstanced;
+    PFNGLFENCESYNCPROC          FenceSync;
     PFNGLGENBUFFERSPROC         GenBuffers;
     PFNGLGENTEXTURESPROC        GenTextures;
     PFNGLGENVERTEXARRAYSPROC    GenVertexArrays;
     PFNGLGENERATEMIPMAPPROC     GenerateMipmap;
     PFNGLGETACTIVEUNIFORMPROC   GetActiveUniform;
+    PFNGLGETACTIVEUNIFORMBLOCKIVPROC    GetActiveUniformBlockiv;
+    PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC  GetActiveUniformBlockName;
+    PFNGLGETACTIVEUNIFORMSIVPROC        GetActiveUniformsiv;
     PFNGLGETBUFFERSUBDATAPROC   GetBufferSubData;
     PFNGLGETPROGRAMINFOLOGPROC  GetProgramInfoLog;
     PFNGLGETPROGRAMIVPROC       GetProgramiv;
     PFNGLGETSHADERINFOLOGPROC   GetShaderInfoLog;
     PFNGLGETSHADERIVPROC        GetShaderiv;
     PFNGLGETUNIFORMLOCATIONPROC GetUniformLocation;
+    PFNGLGETINTEGERVPROC        GetIntegerv;
     PFNGLLINKPROGRAMPROC        LinkProgram;
+    PFNGLMAPBUFFERRANGEPROC     MapBufferRange;
     PFNGLSHADERSOURCEPROC       ShaderSource;
     PFNGLTEXIMAGE2DPROC         TexImage2D;
     PFNGLTEXPARAMETERIPROC      TexParameteri;
     PFNGLTEXPARAMETERFPROC      TexParameterf;
+    PFNGLUNIFORMBLOCKBINDINGPROC        UniformBlockBinding;
     PFNGLUNIFORM1IPROC          Uniform1i;
     PFNGLUNIFORM1FPROC          Uniform1f;
     PFNGLUNIFORM3FPROC          Uniform3f;
     PFNGLUNIFORM4FPROC          Uniform4f;
     PFNGLUNIFORMMATRIX4FVPROC   UniformMatrix4fv;
+    PFNGLUNMAPBUFFERPROC        UnmapBuffer;
     PFNGLUSEPROGRAMPROC         UseProgram;
     PFNGLVERTEXATTRIBPOINTERPROC        VertexAttribPointer;
 
@@ -85,6 +98,7 @@ public:
     PFNGLGETERRORPROC           GetError;
     PFNGLDISABLEPROC            Disable;
     PFNGLGETSTRINGPROC          GetString;
+    PFNGLGETSTRINGIPROC         GetStringi;
     PFNGLBLENDFUNCPROC          BlendFunc;
     PFNGLVIEWPORTPROC           Viewport;
     PFNGLDEPTHMASKPROC          DepthMask;
@@ -106,6 +120,9 @@ public:
     void Assert(const char* file, int line);
 
     void init();
+    //! Creates state tracker over current functions, init() calls it.
+    //! Tests call it after setting stubs to function pointers
+    void createState();
 
     void setCullface(bool enable);
     void setDepthTest(bool enable);
@@ -118,11 +135,22 @@ public:
     void setTextureUnit(u32 id);
     void setTexture(Texture* texture);
     void setFramebuffer(Framebuffer* fbo);
+    //! Drops state of program before it is deleted, does nothing without state tracker
+    void forgetProgram(const GpuProgram& program);
+
+    //! Required alignment of uniform buffer range offset
+    u32 uniformAlignment();
+
+    //! Whether vertex attributes may be GL_INT_2_10_10_10_REV, it is core since GL 3.3
+    bool packedVertexFormats();
 
     RenderState& renderState();
 private:
     GLFuncLoader* loader;
     RenderState* state;
+    u32 uniformAlignment_;
+    bool packedFormatsQueried_;
+    bool packedFormats_;
 
 private:
     DISALLOW_COPY_AND_ASSIGN( DeviceContext );
@@ -8,6 +8,7 @@
 #include "math/matrix-inl.h"
 #include "render/texture.h"
 #include <memory>
+#include <string.h>
 #include "base/log.h"
 
 namespace base {
@@ -23,12 +24,17 @@ GpuProgram::GpuProgram(DeviceContext& gl)
     : GpuResource(gl)
     , vertexShader_(gl)
     , pixelShader_(gl)
+    , hasBlocks_(false)
+    , instanceCapacity_(1)
 {
+    static u32 programCount = 0;
+    serial_ = ++programCount;
 }
 
 void GpuProgram::destroy()
 {
     if ( id_ != 0 ) {
+        GL.forgetProgram( *this );
         GL.DeleteProgram( id_ );
         id_ = 0;
     }
@@ -72,34 +78,67 @@ void GpuProgram::unbind()
 
 void GpuProgram::setParams(const Params& params)
 {
-    for(Params::Iterator it = params.iterator(); !it.isDone(); it.advance())
+    for (u32 i = 0; i < params.size(); i++)
     {
-        UniformVar* uniform = nullptr;
-        if (uniformBinding_.tryGet(it.key(), uniform)) {
-            setParam(*uniform, it.value());
-        } else {
-            ERR("uniform variable '%s' is not presented in program", it.key().c_str());
+        u32* index = nullptr;
+        if (uniformBinding_.tryGet(params.key(i), index)) {
+            setParam(uniforms_[*index], params.type(i), params.data(i));
+        } else if (!isBlockMember(params.key(i))) {
+            ERR("uniform variable '%s' is not presented in program", params.key(i).c_str());
         }
     }
 }
 
-void GpuProgram::setParam(const std::string& paramName, const Variant& value)
+void GpuProgram::setParam(StringId paramName, const Variant& value)
 {
-    UniformVar* uniform = nullptr;
-    if (uniformBinding_.tryGet(paramName.c_str(), uniform)) {
-        setParam(*uniform, value);
+    u32* index = nullptr;
+    if (uniformBinding_.tryGet(paramName, index)) {
+        u8 buffer[16 * sizeof(f32)];
+        ParamType type = Params::pack(value, buffer);
+        setParam(uniforms_[*index], type, buffer);
     }
 }
 
-void GpuProgram::setParam(UniformVar& uniform, const Variant& value)
+UniformHandle GpuProgram::uniformHandle(StringId name) const
 {
-    if (uniform.value == value)
+    return uniformBinding_.get(name, kInvalidUniform);
+}
+
+void GpuProgram::setUniform(UniformHandle handle, ParamType type, const void* data)
+{
+    if (handle >= uniforms_.size())
+        return;
+    setParam(uniforms_[handle], type, static_cast<const u8*>(data));
+}
+
+static ParamType uniformParamType(u32 type)
+{
+    switch (type) {
+        case GL_SAMPLER_2D: return ParamType::String;
+        case GL_FLOAT_MAT4: return ParamType::Mat4;
+        case GL_FLOAT_VEC4: return ParamType::Vec4;
+        case GL_FLOAT: return ParamType::Float;
+        default: return ParamType::None;
+    }
+}
+
+void GpuProgram::setParam(UniformVar& uniform, ParamType type, const u8* data)
+{
+    u32 size = Params::typeSize(type);
+    if (uniformCache_.type(uniform.cacheIndex) == type
+        && memcmp(uniformCache_.data(uniform.cacheIndex), data, size) == 0)
+        return;
+    if (type != uniformParamType(uniform.type)) {
+        ERR("Uniform type %#X does not match parameter type %d", uniform.type, static_cast<i32>(type));
         return;
-    uniform.value = value;
+    }
+    uniformCache_.setAt(uniform.cacheIndex, type, data);
     switch(uniform.type) {
         case GL_SAMPLER_2D:
         {
-            Texture* texture = ResourceRef(value.asString()).resourceAs<Texture>();
+            u64 id;
+            memcpy(&id, data, sizeof(id));
+            Texture* texture = ResourceRef(StringId::fromValue(id)).resourceAs<Texture>();
             GL.setTextureUnit(uniform.samplerIdx);
             GL.setTexture(texture);
             GL.Uniform1i( uniform.location, uniform.samplerIdx );
@@ -107,19 +146,22 @@ void GpuProgram::setParam(UniformVar& uniform, const Variant& value)
         }
         case GL_FLOAT_MAT4:
         {
-            const Matrix4 m = value.asMat4();
-            GL.UniformMatrix4fv( uniform.location, 1, GL_FALSE, reinterpret_cast<const f32*>( &m ) );
+            f32 m[16];
+            memcpy(m, data, sizeof(m));
+            GL.UniformMatrix4fv( uniform.location, 1, GL_FALSE, m );
             break;
         }
         case GL_FLOAT_VEC4:
         {
-            const vec4f v = value.asVec4();
-            GL.Uniform4f( uniform.location, v.x, v.y, v.z, v.w );
+            f32 v[4];
+            memcpy(v, data, sizeof(v));
+            GL.Uniform4f( uniform.location, v[0], v[1], v[2], v[3] );
             break;
         }
         case GL_FLOAT:
         {
-            f32 v = value.asFloat();
+            f32 v;
+            memcpy(&v, data, sizeof(v));
             GL.Uniform1f ( uniform.location, v );
             break;
         }
@@ -143,6 +185,8 @@ void GpuProgram::populateUniformMap()
     }
 
     uniformBinding_.clear();
+    uniforms_.clear();
+    uniformCache_.clear();
 
     std::vector<char> buffer(maxNameLength);
 
@@ -151,6 +195,11 @@ void GpuProgram::populateUniformMap()
         GLsizei nameLength = 0;
         i32 typeSize = 0;
         GLenum uniformType = 0;
+        GLint blockIndex = -1;
+        GLuint uniformIndex = static_cast<GLuint>(i);
+        GL.GetActiveUniformsiv( id_, 1, &uniformIndex, GL_UNIFORM_BLOCK_INDEX, &blockIndex );
+        if (blockIndex != -1)
+            continue;
         GL.GetActiveUniform( id_, i, maxNameLength, &nameLength, &typeSize, &uniformType, buffer.data() );
         std::string uniformName( buffer.begin(), buffer.begin()+nameLength );
         u32 location = GL.GetUniformLocation( id_, uniformName.c_str() );
@@ -161,10 +210,105 @@ void GpuProgram::populateUniformMap()
             uni.samplerIdx = index++;
         else
             uni.samplerIdx = 0;
-        uniformBinding_[uniformName.c_str()] = uni;
+        uni.cacheIndex = 0;
+        StringId uniformId(uniformName);
+        uniformBinding_[uniformId] = static_cast<u32>(uniforms_.size());
+        uniforms_.push_back(uni);
+        uniformCache_.set(uniformId, ParamType::None, nullptr);
+    }
+    // indices are stable after all uniforms are added
+    for (UniformMap::Iterator it = uniformBinding_.iterator(); !it.isDone(); it.advance())
+        uniforms_[it.value()].cacheIndex = static_cast<u32>(uniformCache_.find(it.key()));
+}
+
+//! Name of block member without block prefix and array suffix
+static StringId memberName(const char* name)
+{
+    const char* dot = strrchr(name, '.');
+    if (dot != nullptr)
+        name = dot + 1;
+    const char* bracket = strchr(name, '[');
+    if (bracket == nullptr)
+        return StringId(name);
+    return StringId(std::string(name, bracket));
+}
+
+void GpuProgram::populateUniformBlocks()
+{
+    for (u32 b = 0; b < UniformBlocks::Count; b++)
+        blocks_[b] = UniformBlockLayout();
+    hasBlocks_ = false;
+    instanceCapacity_ = 1;
+
+    GLint blockCount = 0;
+    GL.GetProgramiv( id_, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount );
+    GLint maxNameLength = 0;
+    GL.GetProgramiv( id_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength );
+    std::vector<char> buffer(maxNameLength + 1, '\0');
+    for (GLint i = 0; i < blockCount; i++) {
+        GLint nameLength = 0;
+        GL.GetActiveUniformBlockiv( id_, i, GL_UNIFORM_BLOCK_NAME_LENGTH, &nameLength );
+        std::vector<char> name(nameLength + 1, '\0');
+        GL.GetActiveUniformBlockName( id_, i, nameLength + 1, nullptr, name.data() );
+        UniformBlockBinding binding = UniformBlocks::fromName(name.data());
+        if (binding == UniformBlocks::Count) {
+            ERR("uniform block '%s' is not one of Frame, Material, Object", name.data());
+            continue;
+        }
+        UniformBlockLayout& layout = blocks_[binding];
+        layout.binding = binding;
+        layout.index = static_cast<u32>(i);
+        GLint size = 0;
+        GL.GetActiveUniformBlockiv( id_, i, GL_UNIFORM_BLOCK_DATA_SIZE, &size );
+        layout.size = static_cast<u32>(size);
+
+        GLint memberCount = 0;
+        GL.GetActiveUniformBlockiv( id_, i, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &memberCount );
+        std::vector<GLint> indices(memberCount);
+        if (memberCount > 0)
+            GL.GetActiveUniformBlockiv( id_, i, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices.data() );
+        std::vector<GLuint> uniforms(indices.begin(), indices.end());
+        std::vector<GLint> types(memberCount), offsets(memberCount), matrixStrides(memberCount);
+        std::vector<GLint> arraySizes(memberCount), arrayStrides(memberCount);
+        if (memberCount > 0) {
+            GL.GetActiveUniformsiv( id_, memberCount, uniforms.data(), GL_UNIFORM_TYPE, types.data() );
+            GL.GetActiveUniformsiv( id_, memberCount, uniforms.data(), GL_UNIFORM_OFFSET, offsets.data() );
+            GL.GetActiveUniformsiv( id_, memberCount, uniforms.data(), GL_UNIFORM_MATRIX_STRIDE, matrixStrides.data() );
+            GL.GetActiveUniformsiv( id_, memberCount, uniforms.data(), GL_UNIFORM_SIZE, arraySizes.data() );
+            GL.GetActiveUniformsiv( id_, memberCount, uniforms.data(), GL_UNIFORM_ARRAY_STRIDE, arrayStrides.data() );
+        }
+
+        for (GLint m = 0; m < memberCount; m++) {
+            GLsizei length = 0;
+            GLint arraySize = 0;
+            GLenum type = 0;
+            GL.GetActiveUniform( id_, uniforms[m], maxNameLength + 1, &length, &arraySize, &type, buffer.data() );
+            UniformBlockLayout::Member member;
+            member.name = memberName(std::string(buffer.data(), length).c_str());
+            member.type = static_cast<u32>(types[m]);
+            member.offset = static_cast<u32>(offsets[m]);
+            member.matrixStride = static_cast<u32>(matrixStrides[m]);
+            member.arraySize = arraySizes[m] > 1 ? static_cast<u32>(arraySizes[m]) : 1;
+            member.arrayStride = static_cast<u32>(arrayStrides[m]);
+            layout.members.push_back(member);
+        }
+        const UniformBlockLayout::Member* mvp = layout.find(STRING_ID("mvp"));
+        if (binding == UniformBlocks::Object && mvp != nullptr && mvp->type == GL_FLOAT_MAT4)
+            instanceCapacity_ = mvp->arraySize;
+        GL.UniformBlockBinding( id_, i, binding );
+        hasBlocks_ = true;
     }
 }
 
+bool GpuProgram::isBlockMember(StringId name) const
+{
+    for (u32 b = 0; b < UniformBlocks::Count; b++) {
+        if (blocks_[b].find(name) != nullptr)
+            return true;
+    }
+    return false;
+}
+
 void GpuProgram::setAttribute(const std::string& name, VertexAttr attr, u32 idx)
 {
     AttrVar v;
@@ -172,16 +316,11 @@ void GpuProgram::setAttribute(const std::string& name, VertexAttr attr, u32 idx)
     v.idx = idx;
     v.location = static_cast<u32>(attributes_.size());
     attributes_[name.c_str()] = v;
-}
 
-u32 GpuProgram::getAttributeLoc(VertexAttr attr, u32 idx) const
-{
-    for (AttrMap::Iterator it = attributes_.iterator(); !it.isDone(); it.advance()) {
-        const AttrVar& v = it.value();
-        if (v.attr == attr && v.idx == idx)
-            return v.location;
-    }
-    return u32(-1);
+    u32 slot = idx * VertexAttrs::Count + attr;
+    if (slot >= attributeLocations_.size())
+        attributeLocations_.resize(slot + 1, u32(-1));
+    attributeLocations_[slot] = v.location;
 }
 
 bool GpuProgram::setShaderSource(ShaderType type, const std::string& source)
@@ -192,13 +331,13 @@ bool GpuProgram::setShaderSource(ShaderType type, const std::string& source)
     if (type == ShaderType::VERTEX) {
         vertexShader_.destroy();
         bool res = vertexShader_.create(ShaderType::VERTEX, sources, 1);
-        WARN(vertexShader_.status().c_str());
+        WARN("%s", vertexShader_.status().c_str());
         if (!res) ERR("errors during compilation of shader");
         return res;
     } else if (type == ShaderType::PIXEL) {
         pixelShader_.destroy();
         bool res = pixelShader_.create(ShaderType::PIXEL, sources, 1);
-        WARN(pixelShader_.status().c_str());
+        WARN("%s", pixelShader_.status().c_str());
         if (!res) ERR("errors during compilation of shader");
         return res;
     }
@@ -228,7 +367,7 @@ bool GpuProgram::complete()
     GLint linkStatus;
     GL.GetProgramiv( id_, GL_LINK_STATUS, &linkStatus );
     bool linked = ( linkStatus == GL_TRUE );
-    WARN(status().c_str());
+    WARN("%s", status().c_str());
 
     if (!linked) {
         ERR("error in linkage of shader program");
@@ -236,6 +375,7 @@ bool GpuProgram::complete()
     }
     
     populateUniformMap();
+    populateUniformBlocks();
     return true;
 }
 
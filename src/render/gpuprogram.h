@@ -8,7 +8,10 @@
 
 #include "render/gpuresource.h"
 #include "render/mesh.h"
+#include "render/uniformblock.h"
 #include "base/parameter.h"
+#include "base/smallstring.h"
+#include <vector>
 
 namespace base
 {
@@ -20,6 +23,10 @@ enum class ShaderType {
     PIXEL = GL_FRAGMENT_SHADER
 };
 
+//! Index of active uniform in program, resolved once by name
+typedef u32 UniformHandle;
+const UniformHandle kInvalidUniform = ~0u;
+
 //! Shader program object
 class GpuProgram : public GpuResource, public ResourceBase<GpuProgram>
 {
@@ -27,8 +34,8 @@ class GpuProgram : public GpuResource, public ResourceBase<GpuProgram>
     {
         u32 location;
         u32 type;
-        Variant value;
         u32 samplerIdx;
+        u32 cacheIndex;     //!< index of last set value in uniformCache_
     };
     struct AttrVar
     {
@@ -36,7 +43,8 @@ class GpuProgram : public GpuResource, public ResourceBase<GpuProgram>
         VertexAttr attr;
         u32 idx;
     };
-    typedef FixedMap<SmallString, UniformVar> UniformMap;
+    //! Index in uniforms_
+    typedef FixedMap<StringId, u32> UniformMap;
     typedef FixedMap<SmallString, AttrVar> AttrMap;
 
     //! Shader object
@@ -70,7 +78,14 @@ public:
 
     NEGINE_API void setAttribute(const std::string& name, VertexAttr attr, u32 idx = 0);
 
-    u32 getAttributeLoc(VertexAttr attr, u32 idx = 0) const;
+    //! Location of attribute, u32(-1) when program does not read it
+    u32 getAttributeLoc(VertexAttr attr, u32 idx = 0) const {
+        u32 slot = idx * VertexAttrs::Count + attr;
+        return slot < attributeLocations_.size() ? attributeLocations_[slot] : u32(-1);
+    }
+
+    //! Unique among all programs ever created, unlike handle or address
+    u32 serial() const { return serial_; }
 
     NEGINE_API bool setShaderSource(ShaderType type, const std::string& source);
 
@@ -78,14 +93,35 @@ public:
 
     NEGINE_API void setParams(const Params& params);
 
-    NEGINE_API void setParam(const std::string& paramName, const Variant& value);
+    NEGINE_API void setParam(StringId paramName, const Variant& value);
+
+    //! Handle of uniform, kInvalidUniform when it is not active. Valid after complete()
+    NEGINE_API UniformHandle uniformHandle(StringId name) const;
+
+    //! Sets uniform without lookup by name, invalid handle is ignored
+    NEGINE_API void setUniform(UniformHandle handle, ParamType type, const void* data);
+    void setUniform(UniformHandle handle, const math::Matrix4& value) { setUniform(handle, ParamType::Mat4, &value); }
+    void setUniform(UniformHandle handle, const math::vec4f& value) { setUniform(handle, ParamType::Vec4, &value); }
+    void setUniform(UniformHandle handle, f32 value) { setUniform(handle, ParamType::Float, &value); }
+
+    //! Layout of uniform block, not valid when program does not declare it
+    const UniformBlockLayout& block(UniformBlockBinding binding) const { return blocks_[binding]; }
+    bool hasBlocks() const { return hasBlocks_; }
+    //! Copies of mesh one draw can make, size of mvp array in Object block or 1
+    u32 instanceCapacity() const { return instanceCapacity_; }
 private:
     
-    void setParam(UniformVar& uniform, const Variant& value);
+    void setParam(UniformVar& uniform, ParamType type, const u8* data);
 
     //! Populate list of active uniforms
     void populateUniformMap();
 
+    //! Reflects uniform blocks and binds them to their binding points
+    void populateUniformBlocks();
+
+    //! True when name is member of some block
+    bool isBlockMember(StringId name) const;
+
     //! Returns status string
     const std::string status() const;
 private:
@@ -93,8 +129,14 @@ private:
     Shader vertexShader_;      //!< Attached vertex shader
 
     UniformMap uniformBinding_;
+    std::vector<UniformVar> uniforms_;
     AttrMap attributes_;
-    Params uniformCache_;
+    std::vector<u32> attributeLocations_;  //!< by idx * VertexAttrs::Count + attr
+    Params uniformCache_;      //!< Last values set to uniforms
+    u32 serial_;
+    UniformBlockLayout blocks_[UniformBlocks::Count];
+    bool hasBlocks_;
+    u32 instanceCapacity_;
 private:
     DISALLOW_COPY_AND_ASSIGN( GpuProgram );
 };
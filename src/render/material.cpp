@@ -8,7 +8,12 @@
 #include "render/gpuprogram.h"
 #include "render/renderstate.h"
 #include "render/glcontext.h"
+#include "render/streambuffer.h"
+#include "base/profiler.h"
+#include "base/frameallocator.h"
 #include "math/matrix-inl.h"
+#include "math/batch.h"
+#include <algorithm>
 
 namespace base {
 
@@ -17,18 +22,26 @@ ResourceType ResourceBase<opengl::Material>::type_ = ResourceManager::registerRe
 
 namespace opengl {
 
-bool Material::hasMode(const SmallString& mode) const {
+bool Material::hasMode(StringId mode) const {
     return modeMap.contains(mode);
 }
 
-opengl::GpuProgram* Material::program(const SmallString& mode) const {
+opengl::GpuProgram* Material::program(StringId mode) const {
     ResourceRef* ref;
     if (!modeMap.tryGet(mode, ref))
         return nullptr;
     return ref->resourceAs<opengl::GpuProgram>();
 }
 
-Renderer::Renderer() {
+namespace {
+//! Size of one frame region of stream buffer
+const u32 kStreamFrameSize = 1024 * 1024;
+}
+
+Renderer::Renderer(FrameAllocator& frameAllocator)
+    : stream_(nullptr)
+    , frameAllocator_(frameAllocator)
+{
     imp::MeshBuilder bb;
     bb.beginSurface();
     bb.addVertex(math::vec3f( 1, -1, -1), math::vec2f(0, 0));
@@ -42,17 +55,36 @@ Renderer::Renderer() {
     bb.getDrawingList(fullscreenQuad);
 }
 
+Renderer::~Renderer() {
+    delete stream_;
+}
+
 void Renderer::render(DeviceContext& GL, const RenderPipeline& pipeline, const game::Camera* camera) {
-    for (auto pass : pipeline) {
+    // draws did not fit into last frame and were skipped, region grows to hold all of them
+    if (stream_ != nullptr && stream_->needed() > stream_->frameSize()) {
+        u32 size = stream_->frameSize();
+        while (size < stream_->needed())
+            size *= 2;
+        delete stream_;
+        stream_ = new StreamBuffer(GL, BufferTarget::Uniform, size);
+    }
+    if (stream_ == nullptr)
+        stream_ = new StreamBuffer(GL, BufferTarget::Uniform, kStreamFrameSize);
+    stream_->beginFrame();
+    for (u32 k = 0; k < pipeline.size(); k++) {
+        const RenderPass& pass = pipeline[k];
         ResourceRef target(pass.target.c_str());
         GL.setFramebuffer(target.resourceAs<Framebuffer>());
         renderState(GL, pass);
         if (pass.generator == "scene") {
-            sceneRenderer(GL, pass.mode.c_str(), pass.params, camera);
+            PROFILER_SCOPE("render.scene");
+            sceneRenderer(GL, k, pass.mode, pass.params, camera);
         } else if (pass.generator == "fullscreen") {
-            fullscreenRenderer(GL, pass.mode.c_str(), pass.params);
+            PROFILER_SCOPE("render.fullscreen");
+            fullscreenRenderer(GL, pass.mode, pass.params);
         }
     }
+    stream_->endFrame();
 }
 
 void Renderer::renderState(DeviceContext& GL, const RenderPass& rp) {
@@ -65,31 +97,119 @@ void Renderer::renderState(DeviceContext& GL, const RenderPass& rp) {
     }
 }
 
-void Renderer::sceneRenderer(DeviceContext& GL, const std::string& mode, const Params& pp, const game::Camera* camera) {
+void Renderer::cull(const game::Camera* camera) {
+    PROFILER_SCOPE("render.cull");
     const game::Scene* root = camera->scene();
     auto begin = foundation::hash::begin(root->renderables_);
     auto end = foundation::hash::end(root->renderables_);
+    renderables_.clear();
+    matrices_.clear();
     for (auto it = begin; it != end; ++it) {
-        game::Renderable* r = it->value;
-        opengl::Model* model = r->model();
-        math::Matrix4 mvp = camera->clipMatrix() * r->world();
+        renderables_.push_back(it->value);
+        matrices_.push_back(it->value->world());
+    }
+
+    // model space boxes in streams 0..5, world space boxes in streams 6..11
+    const u32 count = static_cast<u32>(renderables_.size());
+    boxes_.resize(count * 12);
+    visible_.resize(count);
+    f32* s = boxes_.data();
+    math::batch::BoxSoA local = {
+        { s, s + count, s + 2 * count }, { s + 3 * count, s + 4 * count, s + 5 * count } };
+    math::batch::BoxSoA world = {
+        { s + 6 * count, s + 7 * count, s + 8 * count }, { s + 9 * count, s + 10 * count, s + 11 * count } };
+    for (u32 k = 0; k < count; k++) {
+        const Model::Bounds& bounds = renderables_[k]->model()->bounds();
+        local.min.x[k] = bounds.min.x;
+        local.min.y[k] = bounds.min.y;
+        local.min.z[k] = bounds.min.z;
+        local.max.x[k] = bounds.max.x;
+        local.max.y[k] = bounds.max.y;
+        local.max.z[k] = bounds.max.z;
+    }
+    math::batch::transformBounds(matrices_.data(), local, world, count);
+    const u32 visible = math::batch::cullBoxes(camera->planes(), 6, world, count, visible_.data());
 
+    u32 j = 0;
+    for (u32 k = 0; k < count; k++) {
+        if (!visible_[k])
+            continue;
+        renderables_[j] = renderables_[k];
+        matrices_[j] = matrices_[k];
+        j++;
+    }
+    renderables_.resize(j);
+    matrices_.resize(j);
+
+    if (Profiler::enabled()) {
+        static const u32 visibleId = Profiler::intern("render.visible");
+        static const u32 culledId = Profiler::intern("render.culled");
+        Profiler::counter(visibleId) = static_cast<f32>(visible);
+        Profiler::counter(culledId) = static_cast<f32>(count - visible);
+    }
+}
+
+void Renderer::sceneRenderer(DeviceContext& GL, u32 pass, const std::string& mode, const Params& pp, const game::Camera* camera) {
+    const StringId modeId(mode);
+    cull(camera);
+    const u32 count = static_cast<u32>(renderables_.size());
+    // view distance of object origin orders draws front to back
+    depths_.resize(count);
+    for (u32 k = 0; k < count; k++)
+        depths_[k] = -(camera->modelView() * matrices_[k].Column(3)).z;
+    // world matrices turn into mvp in place
+    math::batch::multiply(camera->clipMatrix(), matrices_.data(), matrices_.data(), count);
+
+    surfaces_.clear();
+    for (u32 k = 0; k < count; k++) {
+        opengl::Model* model = renderables_[k]->model();
         size_t meshCount = model->surfaceCount();
         for(size_t i=0; i<meshCount; i++) {
-            opengl::Mesh& m = const_cast<opengl::Mesh&>(model->surfaceAt(i).mesh);
-            Material* material = m.material_.resourceAs<Material>(); // m.material();
-            Params& meshParams = m.params_;
-            if (material->hasMode(mode.c_str())) {
-                opengl::GpuProgram* prog = material->program(mode.c_str());
-                GL.setProgram(prog);
-                prog->setParams(material->defaultParams);
-                prog->setParams(meshParams);
-                prog->setParams(pp);
-                prog->setParam("mvp", mvp);
-                GL.renderState().render(m, 0, m.numIndexes());
-            }
+            const opengl::Mesh& m = model->surfaceAt(i).mesh;
+            Material* material = const_cast<opengl::Mesh&>(m).material_.resourceAs<Material>();
+            opengl::GpuProgram* prog = material->program(modeId);
+            if (prog == nullptr)
+                continue;
+            SurfaceDraw surface = { &m, prog, material, k };
+            surfaces_.push_back(surface);
+        }
+    }
+    // same surface of a shared model goes together, nearest first
+    std::sort(surfaces_.begin(), surfaces_.end(), [this](const SurfaceDraw& a, const SurfaceDraw& b) {
+        if (a.mesh != b.mesh)
+            return a.mesh < b.mesh;
+        if (a.program != b.program)
+            return a.program < b.program;
+        return depths_[a.object] < depths_[b.object];
+    });
+
+    // one command for group, its mvp matrices are copied one after another,
+    // commands point into them until the end of frame
+    commands_.clear();
+    const u32 surfaceCount = static_cast<u32>(surfaces_.size());
+    math::Matrix4* instances = static_cast<math::Matrix4*>(
+        frameAllocator_.allocate(surfaceCount * sizeof(math::Matrix4), alignof(math::Matrix4)));
+    for (u32 first = 0; first < surfaceCount;) {
+        const SurfaceDraw& surface = surfaces_[first];
+        u32 last = first;
+        for (; last < surfaceCount; last++) {
+            if (surfaces_[last].mesh != surface.mesh || surfaces_[last].program != surface.program)
+                break;
+            instances[last] = matrices_[surfaces_[last].object];
         }
+        DrawCommand command;
+        command.mesh = surface.mesh;
+        command.program = surface.program;
+        command.materialParams = &surface.material->defaultParams;
+        command.meshParams = &surface.mesh->params_;
+        command.mvp = &instances[first];
+        command.instances = last - first;
+        command.from = 0;
+        command.count = surface.mesh->numIndexes();
+        commands_.add(pass, depths_[surface.object], command);
+        first = last;
     }
+    commands_.submit(GL, pp, stream_);
 }
     
 void Renderer::fullscreenRenderer(DeviceContext& GL, const std::string& mode, const Params& pp) {
@@ -6,26 +6,31 @@
 #include "base/parameter.h"
 #include "engine/resourceref.h"
 #include "render/mesh.h"
+#include "math/matrix.h"
+#include "render/commandbuffer.h"
 #include <vector>
 
 namespace base {
 
-namespace game { class Scene; class Camera; }
+class FrameAllocator;
+
+namespace game { class Scene; class Camera; class Renderable; }
 
 namespace opengl {
 
 class DeviceContext;
 class GpuProgram;
+class StreamBuffer;
 
 struct Material : public ResourceBase<Material>
 {
-    typedef FixedMap<SmallString, ResourceRef> ProgramMap;
+    typedef FixedMap<StringId, ResourceRef> ProgramMap;
     ProgramMap modeMap; // mode -> gpu program
     Params defaultParams;
 
-    bool hasMode(const SmallString& mode) const;
+    bool hasMode(StringId mode) const;
 
-    opengl::GpuProgram* program(const SmallString& mode) const;
+    opengl::GpuProgram* program(StringId mode) const;
 };
 
 struct RenderPass
@@ -61,15 +66,42 @@ typedef std::vector<RenderPass> RenderPipeline;
 
 struct Renderer {
 
-    Renderer();
+    //! Scratch data of a frame is taken from frameAllocator
+    Renderer(FrameAllocator& frameAllocator);
+    ~Renderer();
     NEGINE_API void render(DeviceContext& context, const RenderPipeline& pipeline, const game::Camera* camera);
+    //! Ring for data written every frame, valid during render()
+    StreamBuffer& stream() { return *stream_; }
 
 private:
+    //! Surface of visible object, surfaces of same mesh and program are
+    //! drawn as instances
+    struct SurfaceDraw
+    {
+        const Mesh* mesh;
+        GpuProgram* program;
+        Material* material;
+        u32 object;         //!< index in renderables_
+    };
+
     void renderState(DeviceContext& context, const RenderPass& rp);
-    void sceneRenderer(DeviceContext& context, const std::string& mode, const Params& pp, const game::Camera* camera);
+    void sceneRenderer(DeviceContext& context, u32 pass, const std::string& mode, const Params& pp, const game::Camera* camera);
     void fullscreenRenderer(DeviceContext& context, const std::string& mode, const Params& pp);
+    //! Leaves in renderables_ only objects which intersect camera frustum,
+    //! their world matrices are in matrices_
+    void cull(const game::Camera* camera);
 
     Mesh fullscreenQuad;
+    StreamBuffer* stream_;
+    FrameAllocator& frameAllocator_;
+    //! per frame scratch, kept to avoid allocations
+    std::vector<game::Renderable*> renderables_;
+    std::vector<math::Matrix4> matrices_;
+    std::vector<f32> boxes_;
+    std::vector<u8> visible_;
+    std::vector<f32> depths_;
+    std::vector<SurfaceDraw> surfaces_;
+    CommandBuffer commands_;
 };
 
 }
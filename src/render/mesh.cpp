@@ -5,6 +5,7 @@
  **/
 #include "render/mesh.h"
 #include "render/glcontext.h"
+#include "render/meshbuffers.h"
 #include "math/vec4.h"
 #include "base/debug.h"
 
@@ -108,38 +109,27 @@ Mesh& Mesh::indexCount(u32 nIndexes, IndexType type)
     return *this;    
 }
 
+Mesh& Mesh::vertexLayout(const VertexLayout& layout)
+{
+    layout_ = layout;
+    return *this;
+}
+
 void Mesh::complete()
 {
     u32 attrCounter[VertexAttrs::Count];
     memset(attrCounter, 0, VertexAttrs::Count * sizeof(u32));
 
-    #define MESH_ATTR_IN_ARRAY
-        rawSize_ = 0;
-    #ifdef MESH_ATTR_IN_ARRAY
-        for(u32 i=0; i<attr_.size(); i++) {
-            VertexAttr attr = attr_[i];
-            u32& idx = attrCounter[static_cast<u32>(attr)];
-            u32 size = VertexAttrs::GetSize(attr);
-            attributes_.push_back(MeshAttribute(attr, idx, rawSize_, size));
-            rawSize_ += size * numVertexes_;
-            idx++;
-        }
-    #else
-        u32 vertexSize = 0;
-        for(u32 i=0; i<attr_.size(); i++) {
-            VertexAttr attr = attr_[i];
-            vertexSize += VertexAttrs::GetSize(attr);
-        }
-        u32 pos = 0;
-        for(u32 i=0; i<attr_.size(); i++) {
-            VertexAttr attr = attr_[i];
-            u32& idx = attrCounter[static_cast<u32>(attr)];
-            u32 size = VertexAttrs::GetSize(attr);
-            attributes_.push_back(MeshAttribute(attr, idx, pos, vertexSize));
-            pos += size;
-        }
-        rawSize_ += vertexSize * numVertexes_;
-    #endif
+    // attributes are planar streams, vertex layout applies on upload
+    rawSize_ = 0;
+    for(u32 i=0; i<attr_.size(); i++) {
+        VertexAttr attr = attr_[i];
+        u32& idx = attrCounter[static_cast<u32>(attr)];
+        u32 size = VertexAttrs::GetSize(attr);
+        attributes_.push_back(MeshAttribute(attr, idx, rawSize_, size));
+        rawSize_ += size * numVertexes_;
+        idx++;
+    }
     attributeBuffer_.resize(rawSize_);
     if (numIndexes_ != 0) {
         if (indexType_ == IndexTypes::UInt16)
@@ -169,6 +159,20 @@ const MeshAttribute& Mesh::getLayer(VertexAttr attr, u32 idx) const {
     return invalidLayer;
 }
 
+bool Mesh::hasAttribute(VertexAttr attr, u32 idx) const {
+    for (const MeshAttribute& layer : attributes_)
+        if (attr == layer.attr_ && idx == layer.idx_)
+            return true;
+    return false;
+}
+
+MeshBuffers& Mesh::upload(DeviceContext& gl) const
+{
+    if (!buffers_)
+        buffers_ = std::make_shared<MeshBuffers>(gl, *this);
+    return *buffers_;
+}
+
 u8* Mesh::findAttributeRaw(VertexAttr attr, u32 idx) const
 {
     const MeshAttribute& layer = getLayer(attr, idx);
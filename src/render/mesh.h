@@ -8,9 +8,11 @@
 
 #include "base/types.h"
 #include <vector>
+#include <memory>
 #include "render/gl_lite.h"
 #include "engine/resourceref.h"
 #include "base/parameter.h"
+#include "base/memorytags.h"
 
 namespace base {
 namespace opengl {
@@ -38,6 +40,35 @@ u32 GetSize( VertexAttr attr );
 }
 typedef VertexAttrs::VertexAttr VertexAttr;
 
+namespace VertexFormats
+{
+//! Formats of attribute in vertex buffer, see render/vertexformat.h
+enum VertexFormat {
+    Float,          //!< as mesh stores it
+    Half,           //!< 16-bit float, padded to even count of components
+    Int2101010,     //!< signed normalized 10:10:10:2, for unit vectors
+    Octahedral,     //!< unit vector as two signed normalized 16-bit values
+    Unorm8,         //!< unsigned normalized bytes, padded to four, for colors
+
+    Count
+};
+}
+typedef VertexFormats::VertexFormat VertexFormat;
+
+//! How mesh vertices are laid out in vertex buffer
+struct VertexLayout
+{
+    VertexFormat formats[VertexAttrs::Count];
+    bool interleaved;
+
+    //! Planar floats, same as mesh streams
+    NEGINE_API VertexLayout();
+
+    //! Interleaved, half positions and texture coordinates, 10:10:10:2
+    //! normals and tangents, unorm8 colors
+    NEGINE_API static VertexLayout compact();
+};
+
 struct MeshAttribute
 {
     VertexAttr attr_;
@@ -59,6 +90,9 @@ namespace IndexTypes
 }
 typedef IndexTypes::IndexType IndexType;
 
+class DeviceContext;
+class MeshBuffers;
+
 class Mesh
 {
 public:
@@ -68,6 +102,8 @@ public:
     NEGINE_API Mesh& addAttribute(VertexAttr attr);
     NEGINE_API Mesh& vertexCount(u32 nVertexes);
     NEGINE_API Mesh& indexCount(u32 nIndexes, IndexType type);
+    //! Layout of uploaded vertices, attributes in mesh are float streams anyway
+    NEGINE_API Mesh& vertexLayout(const VertexLayout& layout);
     NEGINE_API void complete();
 
     inline u32 numVertexes() const { return numVertexes_; }
@@ -77,6 +113,7 @@ public:
     inline const std::vector<MeshAttribute>& attributes() const { return attributes_; }
     inline void* indices() { return indices_.data(); }
     inline IndexType indexType() const { return indexType_; }
+    inline const VertexLayout& vertexLayout() const { return layout_; }
 
     ResourceRef material_;
     Params params_;
@@ -87,6 +124,10 @@ public:
     }
 
     const MeshAttribute& getLayer(VertexAttr attr, u32 idx) const;
+    bool hasAttribute(VertexAttr attr, u32 idx = 0) const;
+
+    //! GPU copy of data, made on first call. Copies of mesh share it
+    NEGINE_API MeshBuffers& upload(DeviceContext& gl) const;
 private:
     u8* findAttributeRaw(VertexAttr attr, u32 idx) const;
 
@@ -95,10 +136,14 @@ private:
     u32 numVertexes_;
     u32 numIndexes_;
     std::vector<MeshAttribute> attributes_;
-    std::vector<u8> attributeBuffer_;
-    std::vector<u8> indices_;
+    //! vertex and index data are counted as render memory
+    typedef std::vector<u8, TagAllocator<u8, MemoryTag::Render>> Buffer;
+    Buffer attributeBuffer_;
+    Buffer indices_;
     u32 rawSize_;
     IndexType indexType_;
+    VertexLayout layout_;
+    mutable std::shared_ptr<MeshBuffers> buffers_;
 };
 
 } // namespace opengl
@@ -0,0 +1,147 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "render/meshbuffers.h"
+#include "render/gpuprogram.h"
+#include "render/renderstate.h"
+#include "render/vertexformat.h"
+#include "base/debug.h"
+#include "base/log.h"
+
+namespace base
+{
+namespace opengl
+{
+
+MeshBuffers::MeshBuffers(DeviceContext& gl, const Mesh& mesh)
+    : GL(gl)
+    , vertices_(gl, BufferTarget::Array, BufferUsage::StaticDraw)
+    , indices_(gl, BufferTarget::ElementArray, BufferUsage::StaticDraw)
+    , hasIndices_(mesh.numIndexes() != 0)
+    , indexType_(mesh.indexType())
+    , vertexBytes_(0)
+{
+    Mesh& m = const_cast<Mesh&>(mesh);
+    const VertexLayout& layout = m.vertexLayout();
+    const u32 vertexCount = m.numVertexes();
+
+    // offsets are relative to vertex for interleaved layout, to stream for planar one
+    u32 vertexSize = 0;
+    for (const MeshAttribute& source : m.attributes()) {
+        Attribute attribute;
+        attribute.attr = source.attr_;
+        attribute.idx = source.idx_;
+        attribute.format = layout.formats[source.attr_];
+        if (!VertexFormats::IsCompatible(attribute.format, attribute.attr)) {
+            ERR("vertex format %d does not fit attribute %d, float is used", attribute.format, attribute.attr);
+            attribute.format = VertexFormats::Float;
+        }
+        // older context can not read packed unit vectors, shader sees same vec3 in float
+        if (attribute.format == VertexFormats::Int2101010 && !GL.packedVertexFormats())
+            attribute.format = VertexFormats::Float;
+        const u32 size = VertexFormats::GetSize(attribute.format, attribute.attr);
+        attribute.offset = layout.interleaved ? vertexSize : vertexBytes_;
+        attribute.stride = size;
+        vertexSize += size;
+        vertexBytes_ += size * vertexCount;
+        attributes_.push_back(attribute);
+    }
+    if (layout.interleaved) {
+        for (Attribute& attribute : attributes_)
+            attribute.stride = vertexSize;
+    }
+
+    std::vector<u8> vertices(vertexBytes_);
+    const u8* data = static_cast<const u8*>(m.data());
+    for (u32 i = 0; i < attributes_.size(); i++) {
+        const Attribute& attribute = attributes_[i];
+        const u8* source = data + m.attributes()[i].start_;
+        VertexFormats::Encode(attribute.format, attribute.attr, source, vertexCount, vertices.data() + attribute.offset, attribute.stride);
+    }
+
+    RenderState& state = GL.renderState();
+    state.addMeshBuffers(this);
+    // element array binding belongs to vertex array object, do not change bound one
+    state.vertexArray.set(0);
+    state.vertexBuffer.set(vertices_.handle());
+    vertices_.setData(vertexBytes_, vertices.data());
+    if (hasIndices_) {
+        state.indexBuffer.set(indices_.handle());
+        if (indexType_ == IndexTypes::UInt32 && vertexCount <= 65536) {
+            std::vector<u16> narrow(m.numIndexes());
+            const u32* wide = static_cast<const u32*>(m.indices());
+            for (u32 i = 0; i < narrow.size(); i++)
+                narrow[i] = static_cast<u16>(wide[i]);
+            indexType_ = IndexTypes::UInt16;
+            indices_.setData(static_cast<u32>(narrow.size() * sizeof(u16)), narrow.data());
+        } else {
+            u32 indexSize = indexType_ == IndexTypes::UInt16 ? 2 : 4;
+            indices_.setData(m.numIndexes() * indexSize, m.indices());
+        }
+    }
+}
+
+MeshBuffers::~MeshBuffers()
+{
+    RenderState& state = GL.renderState();
+    for (const Binding& binding : arrays_) {
+        state.vertexArray.forget(binding.array);
+        GL.DeleteVertexArrays(1, &binding.array);
+    }
+    state.vertexBuffer.forget(vertices_.handle());
+    state.indexBuffer.forget(indices_.handle());
+    state.removeMeshBuffers(this);
+}
+
+void MeshBuffers::releaseProgram(u32 serial)
+{
+    for (u32 i = 0; i < arrays_.size(); i++) {
+        if (arrays_[i].program != serial)
+            continue;
+        GL.renderState().vertexArray.forget(arrays_[i].array);
+        GL.DeleteVertexArrays(1, &arrays_[i].array);
+        arrays_[i] = arrays_.back();
+        arrays_.pop_back();
+        return;
+    }
+}
+
+GLuint MeshBuffers::vertexArray(const GpuProgram& program)
+{
+    const u32 serial = program.serial();
+    for (const Binding& binding : arrays_) {
+        if (binding.program == serial)
+            return binding.array;
+    }
+
+    Binding binding;
+    binding.program = serial;
+    GL.GenVertexArrays(1, &binding.array);
+    ASSERT(binding.array != 0);
+    arrays_.push_back(binding);
+
+    RenderState& state = GL.renderState();
+    state.vertexArray.set(binding.array);
+    state.vertexBuffer.set(vertices_.handle());
+    if (hasIndices_)
+        state.indexBuffer.set(indices_.handle());
+    for (const Attribute& attr : attributes_) {
+        u32 location = program.getAttributeLoc(attr.attr, attr.idx);
+        if (location == u32(-1))
+            continue;
+        GL.EnableVertexAttribArray(location);
+        GL.VertexAttribPointer(
+            location,
+            VertexFormats::GetComponentCount(attr.format, attr.attr),
+            VertexFormats::GetGLType(attr.format),
+            VertexFormats::IsNormalized(attr.format) ? GL_TRUE : GL_FALSE,
+            attr.stride,
+            reinterpret_cast<void*>(static_cast<uptr>(attr.offset)));
+    }
+    return binding.array;
+}
+
+} // namespace opengl
+} // namespace base
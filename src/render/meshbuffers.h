@@ -0,0 +1,75 @@
+/**
+ * \file
+ * \brief       GPU copy of mesh data
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "render/bufferobject.h"
+#include "render/mesh.h"
+#include <vector>
+
+namespace base
+{
+namespace opengl
+{
+
+class GpuProgram;
+
+//! Vertex and index data of mesh uploaded once into static buffers.
+//! Keeps vertex array object per program which drew the mesh,
+//! so draw is bind and draw only.
+//!
+//! Vertices are encoded by vertex layout of mesh. 32-bit indices go as
+//! 16-bit ones when mesh has no more than 65536 vertices
+class MeshBuffers
+{
+public:
+    //! Uploads data of mesh, later changes of mesh are not seen
+    MeshBuffers(DeviceContext& gl, const Mesh& mesh);
+    ~MeshBuffers();
+
+    //! Vertex array object with mesh attributes at locations of program,
+    //! made and bound on first use
+    GLuint vertexArray(const GpuProgram& program);
+
+    //! Deletes vertex array of program, RenderState calls it when program is destroyed
+    void releaseProgram(u32 serial);
+
+    //! Type of uploaded indices, may be narrower than in mesh
+    IndexType indexType() const { return indexType_; }
+    //! Bytes in vertex buffer
+    u32 vertexBytes() const { return vertexBytes_; }
+
+private:
+    struct Binding
+    {
+        u32 program;        //!< GpuProgram::serial()
+        GLuint array;
+    };
+    //! Attribute in vertex buffer
+    struct Attribute
+    {
+        VertexAttr attr;
+        u32 idx;
+        VertexFormat format;
+        u32 offset;
+        u32 stride;
+    };
+
+    DeviceContext& GL;
+    BufferObject vertices_;
+    BufferObject indices_;
+    bool hasIndices_;
+    IndexType indexType_;
+    u32 vertexBytes_;
+    std::vector<Attribute> attributes_;
+    std::vector<Binding> arrays_;
+private:
+    DISALLOW_COPY_AND_ASSIGN( MeshBuffers );
+};
+
+} // namespace opengl
+} // namespace base
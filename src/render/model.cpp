@@ -5,7 +5,10 @@
  **/
 #include "render/model.h"
 #include "math/vec4.h"
+#include "math/batch.h"
 #include "base/debug.h"
+#include <algorithm>
+#include <math.h>
 
 using base::math::vec2f;
 using base::math::vec3f;
@@ -22,6 +25,8 @@ Model::Model() {
     vertexSize_ = 0;
     indexSize_ = 0;
     currentSurface_ = nullptr;
+    bounds_.min = bounds_.max = bounds_.center = vec3f(0.0f);
+    bounds_.radius = 0.0f;
 }
 
 Model::~Model() {
@@ -61,6 +66,54 @@ void Model::endSurface() {
 void Model::done() {
     if (currentSurface_ != nullptr)
         endSurface();
+    computeBounds();
+}
+
+static const vec3f* positionsOf(const Mesh& mesh) {
+    if (mesh.numVertexes() == 0 || !mesh.hasAttribute(VertexAttrs::tagPosition))
+        return nullptr;
+    return mesh.findAttribute<vec3f>(VertexAttrs::tagPosition);
+}
+
+void Model::computeBounds() {
+    bool empty = true;
+    std::vector<f32> x, y, z;
+    for (const Surface& surface : surfaces_) {
+        const vec3f* positions = positionsOf(surface.mesh);
+        if (positions == nullptr)
+            continue;
+        u32 count = surface.mesh.numVertexes();
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+        math::batch::Vec3SoA points = { x.data(), y.data(), z.data() };
+        math::batch::deinterleave(positions, points, count);
+        vec3f min, max;
+        math::batch::bounds(points, count, min, max);
+        if (empty) {
+            bounds_.min = min;
+            bounds_.max = max;
+            empty = false;
+            continue;
+        }
+        for (int i = 0; i < 3; i++) {
+            bounds_.min[i] = std::min(bounds_.min[i], min[i]);
+            bounds_.max[i] = std::max(bounds_.max[i], max[i]);
+        }
+    }
+    // sphere around box center is looser than minimal one, but is cheap to get
+    bounds_.center = (bounds_.min + bounds_.max) * 0.5f;
+    f32 radiusSq = 0.0f;
+    for (const Surface& surface : surfaces_) {
+        const vec3f* positions = positionsOf(surface.mesh);
+        if (positions == nullptr)
+            continue;
+        for (u32 i = 0; i < surface.mesh.numVertexes(); i++) {
+            vec3f d = positions[i] - bounds_.center;
+            radiusSq = std::max(radiusSq, dot(d, d));
+        }
+    }
+    bounds_.radius = sqrtf(radiusSq);
 }
 
 } // namespace opengl
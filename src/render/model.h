@@ -8,6 +8,7 @@
 #include "base/types.h"
 #include "engine/resource.h"
 #include "render/mesh.h"
+#include "math/vec3.h"
 #include <vector>
 
 namespace base {
@@ -28,16 +29,29 @@ public:
         u32 indexStart;     //! bytes
     };
 
+    //! Model space bounds of all surfaces
+    struct Bounds {
+        math::vec3f min;
+        math::vec3f max;
+        math::vec3f center; //! bounding sphere
+        f32 radius;
+    };
+
     NEGINE_API size_t surfaceCount() const;
     NEGINE_API const Surface& surfaceAt(size_t i) const;
     NEGINE_API Surface& beginSurface();
     NEGINE_API void endSurface();
+    //! Finishes last surface and computes bounds
     NEGINE_API void done();
+    inline const Bounds& bounds() const { return bounds_; }
 private:
+    void computeBounds();
+
     Surface* currentSurface_;
     std::vector<Surface> surfaces_;
     u32 vertexSize_;
     u32 indexSize_;
+    Bounds bounds_;
 };
 
 } // namespace opengl
@@ -31,6 +31,20 @@ Texture* createTexture(DeviceContext& gl, const char* name, const char* filename
     ref.setResource(texture);
     return ref.resourceAs<opengl::Texture>();
 }
+//! Texture is set to the resource when it is read and decoded,
+//! samplers refer to it by name and get nothing until then
+void textureLoaded(Texture* texture, void* user) {
+    StringId* name = static_cast<StringId*>(user);
+    if (texture != nullptr)
+        ResourceRef(*name).setResource(texture);
+    delete name;
+}
+void loadTextureResource(DeviceContext& gl, const char* name, const char* filename) {
+    TextureInfo defaultSettings;
+    defaultSettings.Filtering = TextureFilters::Anisotropic;
+    defaultSettings.GenerateMipmap = true;
+    loadTextureAsync(gl, defaultSettings, filename, textureLoaded, new StringId(name));
+}
 Framebuffer* createFramebuffer(DeviceContext& gl, const char* name) {
     Framebuffer* fbo = new Framebuffer(gl);
     ResourceRef ref(name);
@@ -49,6 +63,7 @@ void init_py_render()
         .def( "__str__", gl_tostr)
         .def( "createProgram", createProgram, return_value_policy<manage_new_object>() )
         .def( "createTexture", createTexture, return_value_policy<manage_new_object>() )
+        .def( "loadTexture", loadTextureResource )
         .def( "createFramebuffer", createFramebuffer, return_value_policy<manage_new_object>() )
         ;
     enum_<VertexAttr>("VertexAttrs")
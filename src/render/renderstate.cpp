@@ -1,6 +1,8 @@
 #include "render/renderstate.h"
 #include "render/mesh.h"
+#include "render/meshbuffers.h"
 #include "base/debug.h"
+#include <algorithm>
 
 namespace base {
 namespace opengl {
@@ -15,41 +17,50 @@ RenderState::RenderState(DeviceContext& context)
     , program(context)
     , indexBuffer(context)
     , vertexBuffer(context)
+    , vertexArray(context, indexBuffer)
     , activeTexture(context)
 {
 }
 
-void RenderState::render(const Mesh& mesh, u32 from, u32 count)
+void RenderState::render(const Mesh& mesh, u32 from, u32 count, u32 instances)
 {
-    if (true /*do not use buffers */) {
-        const std::vector<MeshAttribute>& attributes = mesh.attributes();
-        size_t size = attributes.size();
-        for (size_t i=0; i<size; i++) {
-            const MeshAttribute& attr = attributes[i];
-            ASSERT(attr.valid_);
-            u32 location = program.current().getAttributeLoc(attr.attr_, attr.idx_);
-            gl.EnableVertexAttribArray( location );
-            gl.VertexAttribPointer(
-                location,
-                VertexAttrs::GetComponentCount( attr.attr_ ),
-                VertexAttrs::GetGLType( attr.attr_ ),
-                GL_FALSE,
-                attr.stride_,
-                const_cast<Mesh&>(mesh).findAttribute<void*>(attr.attr_, attr.idx_) );
-        }
-        //if (mesh.numIndexes() == 0) {
-        //    gl.DrawArrays(GL_TRIANGLES, from, count);
-        //} else {
-            gl.DrawElements(GL_TRIANGLES, count, mesh.indexType(), (u32*)const_cast<Mesh&>(mesh).indices() + from);
-        //}
-        for (u32 i=0; i<size; i++) {
-            const MeshAttribute& attr = attributes[i];
-            ASSERT(attr.valid_);
-            u32 location = program.current().getAttributeLoc(attr.attr_, attr.idx_);
-            gl.DisableVertexAttribArray(location);
-        }
+    MeshBuffers& buffers = mesh.upload(gl);
+    vertexArray.set(buffers.vertexArray(program.current()));
+    if (mesh.numIndexes() == 0) {
+        if (instances == 1)
+            gl.DrawArrays(GL_TRIANGLES, from, count);
+        else
+            gl.DrawArraysInstanced(GL_TRIANGLES, from, count, instances);
+    } else {
+        const IndexType indexType = buffers.indexType();
+        u32 indexSize = indexType == IndexTypes::UInt16 ? 2 : 4;
+        void* offset = reinterpret_cast<void*>(static_cast<uptr>(from * indexSize));
+        if (instances == 1)
+            gl.DrawElements(GL_TRIANGLES, count, indexType, offset);
+        else
+            gl.DrawElementsInstanced(GL_TRIANGLES, count, indexType, offset, instances);
     }
 }
 
+void RenderState::addMeshBuffers(MeshBuffers* buffers)
+{
+    meshBuffers_.push_back(buffers);
+}
+
+void RenderState::removeMeshBuffers(MeshBuffers* buffers)
+{
+    std::vector<MeshBuffers*>::iterator it = std::find(meshBuffers_.begin(), meshBuffers_.end(), buffers);
+    ASSERT(it != meshBuffers_.end());
+    *it = meshBuffers_.back();
+    meshBuffers_.pop_back();
+}
+
+void RenderState::forgetProgram(const GpuProgram& program)
+{
+    this->program.forget(&program);
+    for (MeshBuffers* buffers : meshBuffers_)
+        buffers->releaseProgram(program.serial());
+}
+
 }
 }
\ No newline at end of file
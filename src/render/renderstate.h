@@ -6,6 +6,7 @@
 #include "render/gpuprogram.h"
 #include "render/texture.h"
 #include "render/framebuffer.h"
+#include <vector>
 
 namespace base {
 namespace opengl {
@@ -88,6 +89,12 @@ public:
         return true;
     }
     GpuProgram& current() { return *current_; }
+    //! GL keeps deleted program in use until other one is set, address may be reused
+    void forget(const GpuProgram* program)
+    {
+        if (current_ == program)
+            current_ = nullptr;
+    }
 private:
     DeviceContext& gl;
     GpuProgram* current_;
@@ -105,11 +112,51 @@ public:
         current = buffer;
         gl.BindBuffer(Buffer, current);
     }
+    //! GL unbinds deleted buffer, its name may be reused
+    void forget(u32 buffer)
+    {
+        if (current == buffer)
+            current = 0;
+    }
+    //! Binding was changed outside, next set() binds anyway
+    void invalidate()
+    {
+        current = ~0u;
+    }
 private:
     DeviceContext& gl;
     u32 current;
 };
 
+//! Element array binding is part of vertex array object, so cache of
+//! index buffer is dropped when other vertex array is bound
+class VertexArrayState
+{
+public:
+    VertexArrayState(DeviceContext& context, BufferState<GL_ELEMENT_ARRAY_BUFFER>& indexBuffer)
+        : gl(context), indices(indexBuffer), current(0) {}
+    void set(u32 array)
+    {
+        if (current == array)
+            return;
+        current = array;
+        gl.BindVertexArray(current);
+        indices.invalidate();
+    }
+    //! GL unbinds deleted array, its name may be reused
+    void forget(u32 array)
+    {
+        if (current == array) {
+            current = 0;
+            indices.invalidate();
+        }
+    }
+private:
+    DeviceContext& gl;
+    BufferState<GL_ELEMENT_ARRAY_BUFFER>& indices;
+    u32 current;
+};
+
 class TextureUnitState
 {
 public:
@@ -166,6 +213,7 @@ public:
 
 
 class Mesh;
+class MeshBuffers;
 
 class RenderState
 {
@@ -182,13 +230,24 @@ public:
     GpuProgramState program;
     BufferState<GL_ELEMENT_ARRAY_BUFFER> indexBuffer;
     BufferState<GL_ARRAY_BUFFER> vertexBuffer;
+    VertexArrayState vertexArray;
     TextureUnitState activeTexture;
     TextureState textureState;
     FramebufferState framebuffer;
 
-    NEGINE_API void render(const Mesh& mesh, u32 from, u32 count);
+    //! Draws count indices starting from index from, uploads mesh on first draw.
+    //! More than one instance makes instanced draw
+    NEGINE_API void render(const Mesh& mesh, u32 from, u32 count, u32 instances = 1);
+
+    //! Uploaded meshes keep vertex array per program, they are freed when program is destroyed
+    void addMeshBuffers(MeshBuffers* buffers);
+    void removeMeshBuffers(MeshBuffers* buffers);
+
+    //! Drops bindings and vertex arrays of destroyed program
+    void forgetProgram(const GpuProgram& program);
 private:
     DeviceContext& gl;
+    std::vector<MeshBuffers*> meshBuffers_;
 };
 
 
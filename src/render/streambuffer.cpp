@@ -0,0 +1,125 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "render/streambuffer.h"
+#include "base/debug.h"
+#include "base/profiler.h"
+
+namespace base
+{
+namespace opengl
+{
+
+namespace
+{
+
+const u32 kMaxAlign = 256;
+//! Single wait for fence, in nanoseconds
+const GLuint64 kWaitTimeout = 1000000;
+
+} // namespace
+
+// Buffer is bound to copy write target for upload, so tracked bindings
+// of array and element array targets are not changed
+StreamBuffer::StreamBuffer(DeviceContext& gl, BufferTarget target, u32 frameSize)
+    : GL(gl)
+    , buffer_(gl, target, BufferUsage::StreamDraw)
+    , frameSize_((frameSize + kMaxAlign - 1) & ~(kMaxAlign - 1))
+    , frame_(0)
+    , head_(0)
+    , needed_(0)
+    , flushed_(0)
+    , mapped_(nullptr)
+    , waits_(0)
+{
+    for (u32 i = 0; i < kFrames; i++)
+        fences_[i] = nullptr;
+
+    const u32 size = frameSize_ * kFrames;
+    GL.BindBuffer(GL_COPY_WRITE_BUFFER, buffer_.handle());
+    if (GL.BufferStorage != nullptr) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GL.BufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, flags);
+        mapped_ = static_cast<u8*>(GL.MapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+    }
+    if (mapped_ == nullptr) {
+        GL.BufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        staging_.resize(size);
+    }
+    GL.BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (u32 i = 0; i < kFrames; i++) {
+        if (fences_[i] != nullptr)
+            GL.DeleteSync(fences_[i]);
+    }
+    if (mapped_ != nullptr) {
+        GL.BindBuffer(GL_COPY_WRITE_BUFFER, buffer_.handle());
+        GL.UnmapBuffer(GL_COPY_WRITE_BUFFER);
+        GL.BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+}
+
+StreamBuffer::Allocation StreamBuffer::allocate(u32 size, u32 align)
+{
+    ASSERT(align != 0 && (align & (align - 1)) == 0 && align <= kMaxAlign);
+    Allocation result = { nullptr, 0 };
+    // regions start at multiple of kMaxAlign, local offset alignment is enough
+    u32 offset = (head_ + align - 1) & ~(align - 1);
+    needed_ = ((needed_ + align - 1) & ~(align - 1)) + size;
+    if (offset + size > frameSize_)
+        return result;
+    head_ = offset + size;
+    result.data = region() + offset;
+    result.offset = frame_ * frameSize_ + offset;
+    return result;
+}
+
+void StreamBuffer::flush()
+{
+    if (mapped_ != nullptr || flushed_ == head_)
+        return;
+    GL.BindBuffer(GL_COPY_WRITE_BUFFER, buffer_.handle());
+    GL.BufferSubData(GL_COPY_WRITE_BUFFER, frame_ * frameSize_ + flushed_, head_ - flushed_, region() + flushed_);
+    GL.BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    flushed_ = head_;
+}
+
+void StreamBuffer::beginFrame()
+{
+    frame_ = (frame_ + 1) % kFrames;
+    head_ = 0;
+    needed_ = 0;
+    flushed_ = 0;
+    GLsync fence = fences_[frame_];
+    if (fence == nullptr)
+        return;
+    GLenum status = GL.ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        PROFILER_SCOPE("render.streamWait");
+        waits_++;
+        do {
+            status = GL.ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kWaitTimeout);
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+    GL.DeleteSync(fence);
+    fences_[frame_] = nullptr;
+}
+
+void StreamBuffer::endFrame()
+{
+    flush();
+    if (GL.FenceSync != nullptr)
+        fences_[frame_] = GL.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (Profiler::enabled()) {
+        static const u32 bytesId = Profiler::intern("render.streamBytes");
+        Profiler::counter(bytesId) = static_cast<f32>(head_);
+    }
+}
+
+} // namespace opengl
+} // namespace base
@@ -0,0 +1,87 @@
+/**
+ * \file
+ * \brief       Ring buffer for data written by CPU every frame
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ *
+ * Buffer is split into kFrames regions, frame writes only into its own one.
+ * Allocation is a pointer bump, data goes to GPU without driver calls when
+ * buffer is persistently mapped (GL 4.4), otherwise it is staged in memory
+ * and uploaded by one BufferSubData per flush().
+ *
+ * Region is reused kFrames frames later. endFrame() puts fence after the
+ * frame, beginFrame() waits for fence of region it is going to overwrite.
+ * Without sync objects it relies on driver not queueing more than
+ * kFrames - 1 frames
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "render/bufferobject.h"
+#include <vector>
+
+namespace base
+{
+namespace opengl
+{
+
+class StreamBuffer
+{
+public:
+    static const u32 kFrames = 3;
+
+    //! Place for data in current frame
+    struct Allocation
+    {
+        u8* data;       //!< write pointer, null when frame region is full
+        u32 offset;     //!< offset from start of buffer, for bindRange and attribute pointers
+    };
+
+    //! frameSize is size of one region, rounded up to 256 bytes
+    NEGINE_API StreamBuffer(DeviceContext& gl, BufferTarget target, u32 frameSize);
+    NEGINE_API ~StreamBuffer();
+
+    //! Reserves size bytes aligned to align (power of two, up to 256).
+    //! Data has to be written before flush() or endFrame()
+    NEGINE_API Allocation allocate(u32 size, u32 align = 16);
+
+    //! Makes data written since last flush visible to GPU, call before draws
+    //! which read it. Does nothing for persistent mapping
+    NEGINE_API void flush();
+
+    //! Switches to next region, waits while GPU reads it
+    NEGINE_API void beginFrame();
+
+    //! Flushes data and fences current region
+    NEGINE_API void endFrame();
+
+    BufferObject& buffer() { return buffer_; }
+    bool persistent() const { return mapped_ != nullptr; }
+    u32 frameSize() const { return frameSize_; }
+    //! Bytes allocated in current frame
+    u32 used() const { return head_; }
+    //! Bytes current frame asked for, more than frameSize() when some allocations failed
+    u32 needed() const { return needed_; }
+    //! Count of beginFrame() calls which had to wait for GPU
+    u32 waits() const { return waits_; }
+
+private:
+    u8* region() { return (mapped_ != nullptr ? mapped_ : staging_.data()) + frame_ * frameSize_; }
+
+    DeviceContext& GL;
+    BufferObject buffer_;
+    u32 frameSize_;
+    u32 frame_;         //!< current region
+    u32 head_;          //!< allocated bytes in region
+    u32 needed_;        //!< head_ if failed allocations took place too
+    u32 flushed_;       //!< bytes of region already uploaded
+    u8* mapped_;
+    std::vector<u8> staging_;
+    GLsync fences_[kFrames];
+    u32 waits_;
+private:
+    DISALLOW_COPY_AND_ASSIGN( StreamBuffer );
+};
+
+} // namespace opengl
+} // namespace base
@@ -0,0 +1,113 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "render/uniformblock.h"
+#include "render/gl_lite.h"
+#include "base/log.h"
+#include <string.h>
+
+namespace base
+{
+namespace opengl
+{
+
+namespace UniformBlocks
+{
+
+Binding fromName(const char* name)
+{
+    if (strcmp(name, "Frame") == 0) return Frame;
+    if (strcmp(name, "Material") == 0) return Material;
+    if (strcmp(name, "Object") == 0) return Object;
+    return Count;
+}
+
+} // namespace UniformBlocks
+
+namespace
+{
+
+bool typeMatches(u32 glType, ParamType type)
+{
+    switch (glType) {
+        case GL_FLOAT: return type == ParamType::Float;
+        case GL_FLOAT_VEC2: return type == ParamType::Vec2;
+        case GL_FLOAT_VEC3: return type == ParamType::Vec3;
+        case GL_FLOAT_VEC4: return type == ParamType::Vec4;
+        case GL_FLOAT_MAT4: return type == ParamType::Mat4;
+        case GL_INT: return type == ParamType::Int;
+        case GL_BOOL: return type == ParamType::Bool;
+        default: return false;
+    }
+}
+
+} // namespace
+
+UniformBlockLayout::UniformBlockLayout()
+    : binding(UniformBlocks::Count)
+    , index(0)
+    , size(0)
+{
+}
+
+const UniformBlockLayout::Member* UniformBlockLayout::find(StringId name) const
+{
+    for (const Member& member : members) {
+        if (member.name == name)
+            return &member;
+    }
+    return nullptr;
+}
+
+bool UniformBlockLayout::sameLayout(const UniformBlockLayout& other) const
+{
+    if (size != other.size || members.size() != other.members.size())
+        return false;
+    for (u32 i = 0; i < members.size(); i++) {
+        const Member& a = members[i];
+        const Member& b = other.members[i];
+        if (a.name != b.name || a.type != b.type || a.offset != b.offset || a.matrixStride != b.matrixStride
+            || a.arraySize != b.arraySize || a.arrayStride != b.arrayStride)
+            return false;
+    }
+    return true;
+}
+
+bool UniformBlockLayout::write(StringId name, ParamType type, const void* data, u8* block, u32 element) const
+{
+    const Member* member = find(name);
+    if (member == nullptr)
+        return false;
+    if (!typeMatches(member->type, type)) {
+        ERR("Uniform type %#X does not match parameter type %d", member->type, static_cast<i32>(type));
+        return true;
+    }
+    if (element >= member->arraySize) {
+        ERR("element %d is out of uniform '%s' of size %d", element, name.c_str(), member->arraySize);
+        return true;
+    }
+    u8* out = block + member->offset + element * member->arrayStride;
+    if (type == ParamType::Mat4) {
+        // columns are matrixStride apart, 16 for std140
+        for (u32 column = 0; column < 4; column++)
+            memcpy(out + column * member->matrixStride, static_cast<const f32*>(data) + column * 4, 4 * sizeof(f32));
+    } else if (type == ParamType::Bool) {
+        // bool takes 4 bytes in block
+        u32 value = *static_cast<const bool*>(data) ? 1 : 0;
+        memcpy(out, &value, sizeof(value));
+    } else {
+        memcpy(out, data, Params::typeSize(type));
+    }
+    return true;
+}
+
+void UniformBlockLayout::pack(const Params& params, u8* block) const
+{
+    for (u32 i = 0; i < params.size(); i++)
+        write(params.key(i), params.type(i), params.data(i), block);
+}
+
+} // namespace opengl
+} // namespace base
@@ -0,0 +1,83 @@
+/**
+ * \file
+ * \brief       Layout of uniform block reflected from linked program
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ *
+ * Shaders declare constants in std140 blocks with fixed names:
+ *
+ *     layout(std140) uniform Frame    { ... };    // pass parameters
+ *     layout(std140) uniform Material { ... };    // material and mesh parameters
+ *     layout(std140) uniform Object   { mat4 mvp; ... };
+ *
+ * Object block with array of mvp, indexed by gl_InstanceID, makes program
+ * instanced: one draw covers up to array size copies of mesh
+ *
+ * Values are packed into block memory on CPU and block is bound with one
+ * BindBufferRange, instead of setting uniforms one by one
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "base/stringid.h"
+#include "base/parameter.h"
+#include <vector>
+
+namespace base
+{
+namespace opengl
+{
+
+namespace UniformBlocks
+{
+//! Binding points of blocks, same for all programs
+enum Binding {
+    Frame,
+    Material,
+    Object,
+
+    Count
+};
+
+//! Binding of block by its name, Count for unknown one
+Binding fromName(const char* name);
+}
+typedef UniformBlocks::Binding UniformBlockBinding;
+
+struct UniformBlockLayout
+{
+    struct Member
+    {
+        StringId name;      //!< without block prefix and array suffix
+        u32 type;           //!< GL type
+        u32 offset;
+        u32 matrixStride;
+        u32 arraySize;      //!< 1 for non-array
+        u32 arrayStride;
+    };
+
+    UniformBlockBinding binding;
+    u32 index;              //!< block index in program
+    u32 size;               //!< data size in bytes
+    std::vector<Member> members;
+
+    UniformBlockLayout();
+
+    bool valid() const { return binding != UniformBlocks::Count; }
+
+    //! Returns member or null
+    NEGINE_API const Member* find(StringId name) const;
+
+    //! True when other block has same members at same places, so data packed for one fits other
+    NEGINE_API bool sameLayout(const UniformBlockLayout& other) const;
+
+    //! Writes value to member or its array element, returns false when there
+    //! is no such member. Reports type mismatch and element out of array
+    NEGINE_API bool write(StringId name, ParamType type, const void* data, u8* block, u32 element = 0) const;
+
+    //! Writes values of params which are members, others are skipped
+    NEGINE_API void pack(const Params& params, u8* block) const;
+};
+
+} // namespace opengl
+} // namespace base
@@ -0,0 +1,234 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "render/vertexformat.h"
+#include "base/debug.h"
+#include <math.h>
+#include <string.h>
+
+namespace base
+{
+namespace opengl
+{
+
+namespace VertexFormats
+{
+
+namespace
+{
+
+u32 asUint(f32 value)
+{
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+f32 asFloat(u32 bits)
+{
+    f32 value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+f32 clamp(f32 value, f32 low, f32 high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+i32 snorm(f32 value, f32 scale)
+{
+    return static_cast<i32>(floorf(clamp(value, -1.0f, 1.0f) * scale + 0.5f));
+}
+
+u32 unorm8(f32 value)
+{
+    return static_cast<u32>(clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+//! Octahedral projection of unit vector, both values in [-1, 1]
+void octahedral(const f32* v, f32& x, f32& y)
+{
+    f32 sum = fabsf(v[0]) + fabsf(v[1]) + fabsf(v[2]);
+    if (sum == 0.0f) {
+        x = 0.0f;
+        y = 0.0f;
+        return;
+    }
+    x = v[0] / sum;
+    y = v[1] / sum;
+    if (v[2] < 0.0f) {
+        f32 ox = x;
+        x = (1.0f - fabsf(y)) * (ox >= 0.0f ? 1.0f : -1.0f);
+        y = (1.0f - fabsf(ox)) * (y >= 0.0f ? 1.0f : -1.0f);
+    }
+}
+
+} // namespace
+
+u16 FloatToHalf(f32 value)
+{
+    // adding magic number makes FPU round denormals to nearest even
+    const u32 infinity = 255 << 23;
+    const u32 overflow = (127 + 16) << 23;
+    const u32 denormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    u32 bits = asUint(value);
+    const u32 sign = bits & 0x80000000u;
+    bits ^= sign;
+    u32 half;
+    if (bits >= overflow) {
+        half = bits > infinity ? 0x7e00 : 0x7c00;
+    } else if (bits < (113u << 23)) {
+        half = asUint(asFloat(bits) + asFloat(denormMagic)) - denormMagic;
+    } else {
+        const u32 odd = (bits >> 13) & 1;
+        bits -= (127 - 15) << 23;
+        bits += 0xfff + odd;
+        half = bits >> 13;
+    }
+    return static_cast<u16>(half | (sign >> 16));
+}
+
+VertexFormat PositionFormat(const f32* positions, u32 count)
+{
+    const f32 halfMax = 65504.0f;
+    f32 low[3] = { halfMax, halfMax, halfMax };
+    f32 high[3] = { -halfMax, -halfMax, -halfMax };
+    f32 magnitude = 0.0f;
+    for (u32 i = 0; i < count * 3; i++) {
+        const f32 v = positions[i];
+        const u32 c = i % 3;
+        low[c] = v < low[c] ? v : low[c];
+        high[c] = v > high[c] ? v : high[c];
+        magnitude = fabsf(v) > magnitude ? fabsf(v) : magnitude;
+    }
+    // NaN fails comparison too
+    if (!(magnitude <= halfMax))
+        return Float;
+    // half keeps 11 significant bits, value is rounded by up to magnitude / 2048
+    f32 size = 0.0f;
+    for (u32 c = 0; c < 3; c++)
+        size = high[c] - low[c] > size ? high[c] - low[c] : size;
+    return magnitude <= size ? Half : Float;
+}
+
+bool IsCompatible(VertexFormat format, VertexAttr attr)
+{
+    if (format == Int2101010 || format == Octahedral)
+        return VertexAttrs::GetComponentCount(attr) == 3;
+    return format < Count;
+}
+
+u8 GetComponentCount(VertexFormat format, VertexAttr attr)
+{
+    const u8 count = VertexAttrs::GetComponentCount(attr);
+    switch (format) {
+        case Half: return (count + 1) & ~1;
+        case Int2101010: return 4;
+        case Octahedral: return 2;
+        case Unorm8: return 4;
+        default: return count;
+    }
+}
+
+u32 GetSize(VertexFormat format, VertexAttr attr)
+{
+    switch (format) {
+        case Float: return VertexAttrs::GetSize(attr);
+        case Half: return GetComponentCount(format, attr) * sizeof(u16);
+        case Int2101010: return sizeof(u32);
+        case Octahedral: return 2 * sizeof(i16);
+        case Unorm8: return 4;
+        default: return 0;
+    }
+}
+
+u32 GetGLType(VertexFormat format)
+{
+    switch (format) {
+        case Half: return GL_HALF_FLOAT;
+        case Int2101010: return GL_INT_2_10_10_10_REV;
+        case Octahedral: return GL_SHORT;
+        case Unorm8: return GL_UNSIGNED_BYTE;
+        default: return GL_FLOAT;
+    }
+}
+
+bool IsNormalized(VertexFormat format)
+{
+    return format == Int2101010 || format == Octahedral || format == Unorm8;
+}
+
+void Encode(VertexFormat format, VertexAttr attr, const u8* src, u32 count, u8* dst, u32 stride)
+{
+    ASSERT(IsCompatible(format, attr));
+    const u32 srcStride = VertexAttrs::GetSize(attr);
+    const u32 components = VertexAttrs::GetComponentCount(attr);
+    for (u32 i = 0; i < count; i++, src += srcStride, dst += stride) {
+        f32 v[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        memcpy(v, src, components * sizeof(f32));
+        switch (format) {
+            case Float:
+                memcpy(dst, src, srcStride);
+                break;
+            case Half: {
+                u16 h[4];
+                const u32 n = GetComponentCount(format, attr);
+                for (u32 c = 0; c < n; c++)
+                    h[c] = FloatToHalf(v[c]);
+                memcpy(dst, h, n * sizeof(u16));
+                break;
+            }
+            case Int2101010: {
+                // w stays 0, unit vectors have no fourth component
+                u32 packed = (static_cast<u32>(snorm(v[0], 511.0f)) & 0x3ff)
+                    | ((static_cast<u32>(snorm(v[1], 511.0f)) & 0x3ff) << 10)
+                    | ((static_cast<u32>(snorm(v[2], 511.0f)) & 0x3ff) << 20);
+                memcpy(dst, &packed, sizeof(packed));
+                break;
+            }
+            case Octahedral: {
+                f32 x, y;
+                octahedral(v, x, y);
+                i16 e[2] = { static_cast<i16>(snorm(x, 32767.0f)), static_cast<i16>(snorm(y, 32767.0f)) };
+                memcpy(dst, e, sizeof(e));
+                break;
+            }
+            case Unorm8: {
+                u32 packed = unorm8(v[0]) | (unorm8(v[1]) << 8) | (unorm8(v[2]) << 16) | (unorm8(v[3]) << 24);
+                memcpy(dst, &packed, sizeof(packed));
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+} // namespace VertexFormats
+
+VertexLayout::VertexLayout()
+    : interleaved(false)
+{
+    for (u32 i = 0; i < VertexAttrs::Count; i++)
+        formats[i] = VertexFormats::Float;
+}
+
+VertexLayout VertexLayout::compact()
+{
+    VertexLayout layout;
+    layout.interleaved = true;
+    layout.formats[VertexAttrs::tagPosition] = VertexFormats::Half;
+    layout.formats[VertexAttrs::tagNormal] = VertexFormats::Int2101010;
+    layout.formats[VertexAttrs::tagTexture] = VertexFormats::Half;
+    layout.formats[VertexAttrs::tagTangent] = VertexFormats::Int2101010;
+    layout.formats[VertexAttrs::tagBitangent] = VertexFormats::Int2101010;
+    layout.formats[VertexAttrs::tagColor] = VertexFormats::Unorm8;
+    return layout;
+}
+
+} // namespace opengl
+} // namespace base
@@ -0,0 +1,57 @@
+/**
+ * \file
+ * \brief       Encoding of vertex attributes into GPU formats
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ *
+ * Conversion of float streams of mesh into formats of its VertexLayout.
+ *
+ * Octahedral format is two values, shader decodes unit vector:
+ *
+ *     vec3 decodeOctahedral(vec2 e) {
+ *         vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+ *         if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy);
+ *         return normalize(n);
+ *     }
+ **/
+#pragma once
+
+#include "base/types.h"
+#include "render/mesh.h"
+
+namespace base
+{
+namespace opengl
+{
+
+namespace VertexFormats
+{
+
+//! Whether attribute can be stored in format, unit vector formats need three components
+NEGINE_API bool IsCompatible( VertexFormat format, VertexAttr attr );
+
+//! Size of one value in bytes
+NEGINE_API u32 GetSize( VertexFormat format, VertexAttr attr );
+
+//! Component count for VertexAttribPointer
+NEGINE_API u8 GetComponentCount( VertexFormat format, VertexAttr attr );
+
+//! Int2101010 needs GL 3.3 or ARB_vertex_type_2_10_10_10_rev, see DeviceContext::packedVertexFormats()
+NEGINE_API u32 GetGLType( VertexFormat format );
+
+NEGINE_API bool IsNormalized( VertexFormat format );
+
+//! Converts count values of attribute from float stream src, written values are stride apart
+NEGINE_API void Encode( VertexFormat format, VertexAttr attr, const u8* src, u32 count, u8* dst, u32 stride );
+
+//! 16-bit float, rounded to nearest even, out of range values become infinity
+NEGINE_API u16 FloatToHalf( f32 value );
+
+//! Format for count positions, three floats each. Half when its rounding error
+//! stays under 1/2048 of mesh size, Float for meshes far from origin or out of half range
+NEGINE_API VertexFormat PositionFormat( const f32* positions, u32 count );
+
+} // namespace VertexFormats
+
+} // namespace opengl
+} // namespace base
@@ -3,6 +3,7 @@
 #include <boost/python.hpp>
 #include "base/py.h"
 #include "base/log.h"
+#include "base/profiler.h"
 #include "math/matrix-inl.h"
 #include "engine/resourceref.h"
 #include "engine/engine.h"
@@ -22,6 +23,7 @@ Application& globalApp() {
 Demo::Demo(const std::string& filename) {
     intstance_ = this;
 
+    base::initPythonMemory();
     PyImport_AppendInittab("negine_core", PyInit_negine_core);
     PyImport_AppendInittab("negine_runtime", PyInit_negine_runtime);
     Py_Initialize();
@@ -107,10 +109,20 @@ Demo::~Demo() {
 }
 
 void Demo::OnFrame() {
-    Engine::physics().simulate(timer_.reset() / 1000.f);
-    UpdateWorld();
-    Engine::renderer().render(GL, pipeline_, cam_->camera);
-    GL_ASSERT(GL);
+    {
+        PROFILER_SCOPE("physics");
+        Engine::physics().simulate(timer_.resetNanoseconds());
+    }
+    {
+        PROFILER_SCOPE("scene");
+        UpdateWorld();
+    }
+    {
+        PROFILER_SCOPE("render");
+        Engine::renderer().render(GL, pipeline_, cam_->camera);
+        GL_ASSERT(GL);
+    }
+    PROFILER_SCOPE("swap");
     SDLApp::OnFrame();
 }
 
@@ -169,7 +181,7 @@ void Demo::OnKeyboardUp(u8 key) {
 }
 
 void Demo::OnMotion(i32 x, i32 y, i32 dx, i32 dy) {
-    game::Transform* cam = Engine::scene().getTyped<game::Transform>("camera1");
+    game::Transform* cam = Engine::scene().getTyped<game::Transform>(STRING_ID("camera1"));
     cam->turnHead(math::deg_to_rad * dx);
 
     if (fabs(cam->pitch() + math::deg_to_rad * dy) < math::pi / 2.0f) {
@@ -185,7 +197,7 @@ void Demo::OnMotion(i32 x, i32 y, i32 dx, i32 dy) {
 void Demo::UpdateWorld() {
     const f32 speed = 0.001f;
 
-    game::Transform* cam = Engine::scene().getTyped<game::Transform>("camera1");
+    game::Transform* cam = Engine::scene().getTyped<game::Transform>(STRING_ID("camera1"));
 
     if (keypressed_ & 1) {
         cam->moveForward(speed);
@@ -0,0 +1,126 @@
+/**
+ * \file
+ * \brief       libm vs fast approximations, scalar and SSE
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "math/fastmath.h"
+#include "base/timer.h"
+#include <math.h>
+#include <vector>
+#include <stdio.h>
+
+using namespace base;
+namespace fast = base::math::fast;
+
+namespace {
+
+const u32 kCount = 4096;
+const u32 kRepeat = 500;
+
+std::vector<f32> makeInput( f32 from, f32 to )
+{
+    std::vector<f32> input( kCount );
+    for ( u32 i = 0; i < kCount; i++ )
+        input[i] = from + ( to - from ) * i / kCount;
+    return input;
+}
+
+void report( const char* name, f32 time )
+{
+    printf( "%-22s %6.2f ns/op\n", name, time * 1e6f / ( kCount * kRepeat ) );
+}
+
+}
+
+TEST( fastmath, bench_sincos )
+{
+    std::vector<f32> x = makeInput( -10.0f, 10.0f );
+    std::vector<f32> s( kCount ), c( kCount );
+
+    Timer timer;
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ ) {
+            s[i] = sinf( x[i] );
+            c[i] = cosf( x[i] );
+        }
+    report( "sinf + cosf", timer.elapsed() );
+    f32 check = s[kCount / 3] + c[kCount / 5];
+
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            fast::sincos( x[i], s[i], c[i] );
+    report( "fast::sincos", timer.elapsed() );
+    EXPECT_NEAR( check, s[kCount / 3] + c[kCount / 5], 1e-6f );
+
+#ifdef MATH_SSE
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i += 4 ) {
+            __m128 vs, vc;
+            fast::sincos( _mm_loadu_ps( &x[i] ), vs, vc );
+            _mm_storeu_ps( &s[i], vs );
+            _mm_storeu_ps( &c[i], vc );
+        }
+    report( "fast::sincos sse", timer.elapsed() );
+    EXPECT_NEAR( check, s[kCount / 3] + c[kCount / 5], 1e-6f );
+#endif
+}
+
+TEST( fastmath, bench_atan2 )
+{
+    std::vector<f32> y = makeInput( -3.0f, 5.0f ), x = makeInput( 4.0f, -4.0f );
+    std::vector<f32> a( kCount );
+
+    Timer timer;
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            a[i] = atan2f( y[i], x[i] );
+    report( "atan2f", timer.elapsed() );
+    f32 check = a[kCount / 3];
+
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            a[i] = fast::atan2( y[i], x[i] );
+    report( "fast::atan2", timer.elapsed() );
+    EXPECT_NEAR( check, a[kCount / 3], 1e-6f );
+
+#ifdef MATH_SSE
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i += 4 )
+            _mm_storeu_ps( &a[i], fast::atan2( _mm_loadu_ps( &y[i] ), _mm_loadu_ps( &x[i] ) ) );
+    report( "fast::atan2 sse", timer.elapsed() );
+#endif
+}
+
+TEST( fastmath, bench_rsqrt )
+{
+    std::vector<f32> x = makeInput( 0.01f, 100.0f );
+    std::vector<f32> y( kCount );
+
+    Timer timer;
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            y[i] = 1.0f / sqrtf( x[i] );
+    report( "1 / sqrtf", timer.elapsed() );
+    f32 check = y[kCount / 3];
+
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            y[i] = fast::rsqrt( x[i] );
+    report( "fast::rsqrt", timer.elapsed() );
+    EXPECT_NEAR( check, y[kCount / 3], 1e-5f );
+
+#ifdef MATH_SSE
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i += 4 )
+            _mm_storeu_ps( &y[i], fast::rsqrt( _mm_loadu_ps( &x[i] ) ) );
+    report( "fast::rsqrt sse", timer.elapsed() );
+#endif
+}
@@ -0,0 +1,96 @@
+/**
+ * \file
+ * \brief       CPU cost of setting per-draw uniform by name and by handle
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "render/gpuprogram.h"
+#include "render/glcontext.h"
+#include "base/timer.h"
+#include "tests/glstub.h"
+#include <stdio.h>
+
+using namespace base;
+using namespace base::opengl;
+
+namespace {
+
+const u32 kDraws = 100000;
+
+void report( const char* name, f32 time )
+{
+    printf( "%-26s %6.2f ns/draw\n", name, time * 1e6f / kDraws );
+}
+
+//! Program on stub functions, two matrices so uniform cache does not skip the upload
+struct gpu_program : public glstub::Test
+{
+    void SetUp() {
+        glstub::Test::SetUp();
+        program = glstub::makeProgram( GL, { { "position", VertexAttrs::tagPosition, 0 },
+            { "normal", VertexAttrs::tagNormal, 0 }, { "uv", VertexAttrs::tagTexture, 1 } } );
+        matrices[0] = math::Matrix4::Identity();
+        matrices[1] = math::Matrix4::Identity();
+        matrices[1].SetElem( 0, 0, 2.0f );
+    }
+    void TearDown() {
+        delete program;
+        glstub::Test::TearDown();
+    }
+
+    GpuProgram* program;
+    math::Matrix4 matrices[2];
+};
+
+} // namespace
+
+TEST_F( gpu_program, handles )
+{
+    EXPECT_EQ( 0u, program->getAttributeLoc( VertexAttrs::tagPosition ) );
+    EXPECT_EQ( 1u, program->getAttributeLoc( VertexAttrs::tagNormal ) );
+    EXPECT_EQ( 2u, program->getAttributeLoc( VertexAttrs::tagTexture, 1 ) );
+    EXPECT_EQ( u32( -1 ), program->getAttributeLoc( VertexAttrs::tagTexture ) );
+    EXPECT_EQ( u32( -1 ), program->getAttributeLoc( VertexAttrs::tagPosition, 7 ) );
+
+    UniformHandle mvp = program->uniformHandle( STRING_ID( "mvp" ) );
+    ASSERT_NE( kInvalidUniform, mvp );
+    EXPECT_EQ( kInvalidUniform, program->uniformHandle( STRING_ID( "missing" ) ) );
+    program->setUniform( mvp, matrices[1] );
+    program->setUniform( mvp, matrices[1] );
+    program->setUniform( kInvalidUniform, matrices[0] );
+    EXPECT_EQ( 1u, glstub::calls().uniforms );
+}
+
+TEST_F( gpu_program, bench_set_mvp )
+{
+    Timer timer;
+    for ( u32 i = 0; i < kDraws; i++ )
+        program->setParam( StringId( "mvp" ), matrices[i & 1] );
+    report( "setParam(\"mvp\")", timer.elapsed() );
+
+    timer.reset();
+    for ( u32 i = 0; i < kDraws; i++ )
+        program->setParam( STRING_ID( "mvp" ), matrices[i & 1] );
+    report( "setParam(STRING_ID)", timer.elapsed() );
+
+    timer.reset();
+    UniformHandle mvp = program->uniformHandle( STRING_ID( "mvp" ) );
+    for ( u32 i = 0; i < kDraws; i++ )
+        program->setUniform( mvp, matrices[i & 1] );
+    report( "setUniform(handle)", timer.elapsed() );
+
+    EXPECT_EQ( 3 * kDraws, glstub::calls().uniforms );
+}
+
+TEST_F( gpu_program, bench_attribute_locations )
+{
+    static const VertexAttr attrs[] = { VertexAttrs::tagPosition, VertexAttrs::tagNormal, VertexAttrs::tagTexture };
+    u32 sum = 0;
+    Timer timer;
+    for ( u32 i = 0; i < kDraws; i++ )
+        for ( u32 a = 0; a < 3; a++ )
+            sum += program->getAttributeLoc( attrs[a], a == 2 ? 1 : 0 );
+    report( "getAttributeLoc x3", timer.elapsed() );
+    EXPECT_EQ( 3 * kDraws, sum );
+}
@@ -0,0 +1,69 @@
+/**
+ * \file
+ * \brief       parallel_for over transform-like work vs a single thread
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/jobs.h"
+#include "base/timer.h"
+#include "foundation/memory.h"
+#include <math.h>
+#include <stdio.h>
+
+using namespace base;
+
+namespace {
+
+const u32 kNodes = 1 << 18;
+const int kFrames = 20;
+
+struct Node
+{
+    f32 local[16];
+    f32 world[16];
+};
+
+void updateNodes( Node* begin, Node* end )
+{
+    for ( Node* n = begin; n != end; ++n ) {
+        for ( int r = 0; r < 4; r++ )
+            for ( int c = 0; c < 4; c++ ) {
+                f32 s = 0.0f;
+                for ( int k = 0; k < 4; k++ )
+                    s += n->local[r * 4 + k] * n->local[k * 4 + c];
+                n->world[r * 4 + c] = sqrtf( fabsf( s ) + 1.0f );
+            }
+    }
+}
+
+}
+
+TEST( jobs, bench_parallel_for )
+{
+    foundation::memory_globals::init();
+    {
+        foundation::Array<Node> nodes( foundation::memory_globals::default_allocator() );
+        foundation::array::resize( nodes, kNodes );
+        for ( u32 i = 0; i < kNodes; i++ )
+            for ( int k = 0; k < 16; k++ )
+                nodes[i].local[k] = static_cast<f32>( ( i + k ) % 7 );
+
+        Timer timer;
+        for ( int f = 0; f < kFrames; f++ )
+            updateNodes( foundation::array::begin( nodes ), foundation::array::end( nodes ) );
+        f32 serial = timer.elapsed();
+
+        jobs::init();
+        timer.reset();
+        for ( int f = 0; f < kFrames; f++ )
+            jobs::parallel_for( nodes, 1024, updateNodes );
+        f32 parallel = timer.elapsed();
+        u32 workers = jobs::workerCount();
+        jobs::shutdown();
+
+        printf( "serial:      %.2f ms/frame\n", serial / kFrames );
+        printf( "%2u workers:  %.2f ms/frame\n", workers, parallel / kFrames );
+    }
+    foundation::memory_globals::shutdown();
+}
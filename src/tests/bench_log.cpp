@@ -0,0 +1,87 @@
+/**
+ * \file
+ * \brief       cost per LOG call: synchronous ConsoleLog vs async backend
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/log.h"
+#include "base/timer.h"
+#include <stdio.h>
+
+#ifdef OS_UNIX
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+using base::Log;
+using base::Timer;
+using base::f32;
+
+namespace {
+
+const int kCalls = 20000;
+//! Stays below ring capacity, as a frame worth of messages
+const int kBurst = 200;
+
+//! Sends stdout to /dev/null while alive, so console does not dominate
+class SilenceStdout
+{
+public:
+    SilenceStdout() {
+        fflush(stdout);
+#ifdef OS_UNIX
+        saved_ = dup(STDOUT_FILENO);
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        close(null);
+#endif
+    }
+    ~SilenceStdout() {
+        fflush(stdout);
+#ifdef OS_UNIX
+        dup2(saved_, STDOUT_FILENO);
+        close(saved_);
+#endif
+    }
+private:
+    int saved_;
+};
+
+f32 logCalls( int count )
+{
+    Timer timer;
+    for ( int i = 0; i < count; i++ )
+        LOG( "frame %d: %s %f", i, "physics", i * 0.5f );
+    return timer.elapsed();
+}
+
+}
+
+TEST( log, bench_sync_vs_async )
+{
+    f32 sync, burst = 0.0f, sustained, disabled;
+    {
+        SilenceStdout silence;
+        sync = logCalls( kCalls );
+
+        base::startAsyncLog();
+        for ( int i = 0; i < kCalls / kBurst; i++ ) {
+            burst += logCalls( kBurst );
+            base::flushLog();
+        }
+        Timer timer;
+        logCalls( kCalls );
+        base::flushLog();
+        sustained = timer.elapsed();
+        base::stopAsyncLog();
+
+        base::setLogLevel( Log::LEVEL_ERROR );
+        disabled = logCalls( kCalls );
+        base::setLogLevel( Log::LEVEL_INFO );
+    }
+    printf( "sync ConsoleLog:  %.1f ns/call\n", sync * 1e6f / kCalls );
+    printf( "async, per frame: %.1f ns/call\n", burst * 1e6f / kCalls );
+    printf( "async, sustained: %.1f ns/call (bound by log thread)\n", sustained * 1e6f / kCalls );
+    printf( "disabled level:   %.1f ns/call\n", disabled * 1e6f / kCalls );
+}
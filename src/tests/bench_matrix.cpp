@@ -0,0 +1,259 @@
+/**
+ * \file
+ * \brief       Matrix4 and Quat: scalar reference vs SSE implementation
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "math/matrix-inl.h"
+#include "math/quat.h"
+#include "math/batch.h"
+#include "base/timer.h"
+#include "base/cpu.h"
+#include <vector>
+#include <stdio.h>
+
+using namespace base;
+using namespace base::math;
+
+namespace {
+
+const u32 kCount = 1024;
+const u32 kRepeat = 200;
+
+//! Scalar product by columns, same as Matrix4 operator* without MATH_SSE
+Matrix4 scalarMultiply( const Matrix4& a, const Matrix4& b )
+{
+    Matrix4 r = Matrix4::Identity();
+    for ( u32 i = 0; i < 4; i++ ) {
+        const vec4f& c = b.Col( i );
+        r.SetCol( i, a.Col0() * c.x + a.Col1() * c.y + a.Col2() * c.z + a.Col3() * c.w );
+    }
+    return r;
+}
+
+//! Scalar inverse with 2x2 sub-determinants
+Matrix4 scalarInverse( const Matrix4& m )
+{
+    f32 a[16];
+    for ( u32 i = 0; i < 4; i++ )
+        for ( u32 j = 0; j < 4; j++ )
+            a[i * 4 + j] = m.Elem( j, i );
+    f32 s0 = a[0] * a[5] - a[4] * a[1];
+    f32 s1 = a[0] * a[6] - a[4] * a[2];
+    f32 s2 = a[0] * a[7] - a[4] * a[3];
+    f32 s3 = a[1] * a[6] - a[5] * a[2];
+    f32 s4 = a[1] * a[7] - a[5] * a[3];
+    f32 s5 = a[2] * a[7] - a[6] * a[3];
+    f32 c5 = a[10] * a[15] - a[14] * a[11];
+    f32 c4 = a[9] * a[15] - a[13] * a[11];
+    f32 c3 = a[9] * a[14] - a[13] * a[10];
+    f32 c2 = a[8] * a[15] - a[12] * a[11];
+    f32 c1 = a[8] * a[14] - a[12] * a[10];
+    f32 c0 = a[8] * a[13] - a[12] * a[9];
+    f32 inv = 1.0f / ( s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0 );
+    f32 b[16] = {
+        ( a[5] * c5 - a[6] * c4 + a[7] * c3 ) * inv,
+        ( -a[1] * c5 + a[2] * c4 - a[3] * c3 ) * inv,
+        ( a[13] * s5 - a[14] * s4 + a[15] * s3 ) * inv,
+        ( -a[9] * s5 + a[10] * s4 - a[11] * s3 ) * inv,
+        ( -a[4] * c5 + a[6] * c2 - a[7] * c1 ) * inv,
+        ( a[0] * c5 - a[2] * c2 + a[3] * c1 ) * inv,
+        ( -a[12] * s5 + a[14] * s2 - a[15] * s1 ) * inv,
+        ( a[8] * s5 - a[10] * s2 + a[11] * s1 ) * inv,
+        ( a[4] * c4 - a[5] * c2 + a[7] * c0 ) * inv,
+        ( -a[0] * c4 + a[1] * c2 - a[3] * c0 ) * inv,
+        ( a[12] * s4 - a[13] * s2 + a[15] * s0 ) * inv,
+        ( -a[8] * s4 + a[9] * s2 - a[11] * s0 ) * inv,
+        ( -a[4] * c3 + a[5] * c1 - a[6] * c0 ) * inv,
+        ( a[0] * c3 - a[1] * c1 + a[2] * c0 ) * inv,
+        ( -a[12] * s3 + a[13] * s1 - a[14] * s0 ) * inv,
+        ( a[8] * s3 - a[9] * s1 + a[10] * s0 ) * inv,
+    };
+    Matrix4 r = Matrix4::Identity();
+    for ( u32 i = 0; i < 4; i++ )
+        for ( u32 j = 0; j < 4; j++ )
+            r.SetElem( j, i, b[i * 4 + j] );
+    return r;
+}
+
+Quat scalarMultiply( const Quat& a, const Quat& b )
+{
+    return Quat( a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                 a.w * b.y + a.y * b.w + a.z * b.x - a.x * b.z,
+                 a.w * b.z + a.z * b.w + a.x * b.y - a.y * b.x,
+                 a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z );
+}
+
+std::vector<Matrix4> makeMatrices()
+{
+    std::vector<Matrix4> matrices;
+    for ( u32 i = 0; i < kCount; i++ ) {
+        f32 t = static_cast<f32>( i );
+        matrices.push_back( Matrix4::Translation( vec3f( t, -t, 0.5f * t ) )
+                            * Matrix4::RotationY( 0.01f * t ) * Matrix4::RotationX( 0.02f * t ) );
+    }
+    return matrices;
+}
+
+void report( const char* name, f32 scalarTime, f32 simdTime )
+{
+    f32 perOp = 1e6f / ( kCount * kRepeat );
+    printf( "%-12s scalar %6.2f ns/op, simd %6.2f ns/op, %.1fx\n",
+            name, scalarTime * perOp, simdTime * perOp, scalarTime / simdTime );
+}
+
+}
+
+TEST( math, bench_matrix4 )
+{
+    std::vector<Matrix4> matrices = makeMatrices();
+    std::vector<Matrix4> result( kCount, Matrix4::Identity() );
+    const Matrix4 view = Matrix4::LookAt( vec3f( 1.0f, 2.0f, 3.0f ), vec3f( 0.0f ), vec3f( 0.0f, 1.0f, 0.0f ) );
+
+    Timer timer;
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            result[i] = scalarMultiply( view, matrices[i] );
+    f32 scalarTime = timer.elapsed();
+    Matrix4 check = result[kCount - 1];
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            result[i] = view * matrices[i];
+    f32 simdTime = timer.elapsed();
+    EXPECT_NEAR( check.Elem( 3, 0 ), result[kCount - 1].Elem( 3, 0 ), 1e-3f );
+    report( "multiply", scalarTime, simdTime );
+
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            result[i] = scalarInverse( matrices[i] );
+    scalarTime = timer.elapsed();
+    check = result[kCount - 1];
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            result[i] = Inverse( matrices[i] );
+    simdTime = timer.elapsed();
+    EXPECT_NEAR( check.Elem( 3, 0 ), result[kCount - 1].Elem( 3, 0 ), 1e-2f );
+    report( "inverse", scalarTime, simdTime );
+
+    std::vector<vec4f> points( kCount, vec4f( 1.0f, 2.0f, 3.0f, 1.0f ) );
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ ) {
+            const Matrix4& m = matrices[i];
+            const vec4f& p = points[i];
+            points[i] = m.Col0() * p.x + m.Col1() * p.y + m.Col2() * p.z + m.Col3() * p.w;
+            points[i].w = 1.0f;
+        }
+    scalarTime = timer.elapsed();
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ ) {
+            points[i] = matrices[i] * points[i];
+            points[i].w = 1.0f;
+        }
+    simdTime = timer.elapsed();
+    report( "transform", scalarTime, simdTime );
+}
+
+TEST( math, bench_quat )
+{
+    std::vector<Quat> quats;
+    for ( u32 i = 0; i < kCount; i++ )
+        quats.push_back( Quat::GetRotation( vec3f( 1.0f, 0.5f, 0.25f ), 0.001f * i ) );
+    const Quat step = Quat::GetRotationY( 0.001f );
+    std::vector<Quat> a( quats ), b( quats );
+
+    Timer timer;
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            a[i] = scalarMultiply( a[i], step );
+    f32 scalarTime = timer.elapsed();
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            b[i] = b[i] * step;
+    f32 simdTime = timer.elapsed();
+    EXPECT_NEAR( a[kCount - 1].w, b[kCount - 1].w, 1e-3f );
+    report( "quat mul", scalarTime, simdTime );
+}
+
+TEST( math, bench_batch )
+{
+    const u32 count = kCount * 4;
+    const Matrix4 world = Matrix4::Translation( vec3f( 1.0f, 2.0f, 3.0f ) ) * Matrix4::RotationY( 0.5f );
+    std::vector<vec3f> points( count );
+    std::vector<f32> x( count ), y( count ), z( count );
+    for ( u32 i = 0; i < count; i++ )
+        points[i] = vec3f( 0.001f * i, 1.0f, -0.002f * i );
+    batch::Vec3SoA soa = { x.data(), y.data(), z.data() };
+    batch::deinterleave( points.data(), soa, count );
+
+    Timer timer;
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < count; i++ )
+            points[i] = ( world * vec4f( points[i], 1.0f ) ).xyz();
+    f32 scalarTime = timer.elapsed();
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        batch::transformPoints( world, soa, soa, count );
+    f32 simdTime = timer.elapsed();
+    EXPECT_NEAR( points[count - 1].x, x[count - 1], 1e-2f );
+    report( "points", scalarTime / 4, simdTime / 4 );
+
+    std::vector<Matrix4> worlds = makeMatrices();
+    std::vector<Matrix4> mvps( kCount );
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        for ( u32 i = 0; i < kCount; i++ )
+            mvps[i] = world * worlds[i];
+    scalarTime = timer.elapsed();
+    timer.reset();
+    for ( u32 r = 0; r < kRepeat; r++ )
+        batch::multiply( world, worlds.data(), mvps.data(), kCount );
+    simdTime = timer.elapsed();
+    report( "mvp", scalarTime, simdTime );
+}
+
+TEST( math, bench_batch_tiers )
+{
+    const u32 count = kCount * 16;
+    const Matrix4 world = Matrix4::Translation( vec3f( 1.0f, 2.0f, 3.0f ) ) * Matrix4::RotationY( 0.5f );
+    std::vector<f32> streams[6];
+    for ( auto& s : streams )
+        s.assign( count, 0.0f );
+    for ( u32 i = 0; i < count; i++ ) {
+        streams[0][i] = 0.01f * i;
+        streams[1][i] = 1.0f;
+        streams[2][i] = -0.02f * i;
+    }
+    batch::Vec3SoA points = { streams[0].data(), streams[1].data(), streams[2].data() };
+    batch::Vec3SoA out = { streams[3].data(), streams[4].data(), streams[5].data() };
+    batch::BoxSoA boxes = { points, out };
+    std::vector<u8> visible( count );
+    const Plane planes[6] = {
+        Plane( vec3f( 1.0f, 0.0f, 0.0f ), 100.0f ), Plane( vec3f( -1.0f, 0.0f, 0.0f ), 100.0f ),
+        Plane( vec3f( 0.0f, 1.0f, 0.0f ), 100.0f ), Plane( vec3f( 0.0f, -1.0f, 0.0f ), 100.0f ),
+        Plane( vec3f( 0.0f, 0.0f, 1.0f ), 100.0f ), Plane( vec3f( 0.0f, 0.0f, -1.0f ), 100.0f ),
+    };
+
+    const cpu::Tier saved = cpu::tier();
+    for ( u32 tier = 0; tier <= static_cast<u32>( cpu::supportedTier() ); tier++ ) {
+        cpu::setTier( static_cast<cpu::Tier>( tier ) );
+        Timer timer;
+        for ( u32 r = 0; r < kRepeat; r++ )
+            batch::transformPoints( world, points, out, count );
+        f32 transformTime = timer.elapsed();
+        timer.reset();
+        for ( u32 r = 0; r < kRepeat; r++ )
+            batch::cullBoxes( planes, 6, boxes, count, visible.data() );
+        f32 cullTime = timer.elapsed();
+        f32 perOp = 1e6f / ( count * kRepeat );
+        printf( "%-8s points %5.2f ns/op, cull %5.2f ns/box\n",
+                cpu::tierName( cpu::tier() ), transformTime * perOp, cullTime * perOp );
+    }
+    cpu::setTier( saved );
+}
@@ -0,0 +1,96 @@
+/**
+ * \file
+ * \brief       setParams throughput: map of variants vs GpuProgram with packed parameter block
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/parameter.h"
+#include "base/smallstring.h"
+#include "base/timer.h"
+#include "render/gpuprogram.h"
+#include "tests/glstub.h"
+#include <stdio.h>
+
+using namespace base;
+using namespace base::opengl;
+
+namespace {
+
+const int kDraws = 200000;
+
+//! Previous parameter storage, uniform keeps last value as Variant
+struct MapProgram
+{
+    struct Uniform
+    {
+        Variant value;
+        u32 uploads;
+    };
+    typedef FixedMap<SmallString, Variant> MapParams;
+    FixedMap<SmallString, Uniform> binding;
+
+    void setParams(const MapParams& params) {
+        for (MapParams::Iterator it = params.iterator(); !it.isDone(); it.advance()) {
+            Uniform* uniform = nullptr;
+            if (binding.tryGet(it.key(), uniform)) {
+                if (uniform->value == it.value())
+                    continue;
+                uniform->value = it.value();
+                uniform->uploads++;
+            }
+        }
+    }
+};
+
+math::Matrix4 mvpOf(int draw) {
+    math::Matrix4 m = math::Matrix4::Identity();
+    return m.SetElem(0, 3, static_cast<f32>(draw));
+}
+
+typedef glstub::Test params_bench;
+
+}
+
+// stub programs have "color" and "mvp" uniforms, values of material stay, mvp changes every draw
+TEST_F( params_bench, bench_set_params )
+{
+    MapProgram mapProgram;
+    mapProgram.binding["color"] = MapProgram::Uniform();
+    mapProgram.binding["mvp"] = MapProgram::Uniform();
+    GpuProgram* program = glstub::makeProgram( GL );
+
+    MapProgram::MapParams mapMaterial;
+    Params material;
+    mapMaterial["color"] = Variant( math::vec4f( 1, 1, 1, 1 ) );
+    material.set( StringId( "color" ), Variant( math::vec4f( 1, 1, 1, 1 ) ) );
+
+    MapProgram::MapParams mapObject;
+    Params object;
+    const StringId mvpId = STRING_ID( "mvp" );
+    Timer timer;
+    for ( int i = 0; i < kDraws; i++ ) {
+        mapObject["mvp"] = Variant( mvpOf( i ) );
+        mapProgram.setParams( mapMaterial );
+        mapProgram.setParams( mapObject );
+    }
+    f32 mapTime = timer.elapsed();
+
+    timer.reset();
+    for ( int i = 0; i < kDraws; i++ ) {
+        object.set( mvpId, Variant( mvpOf( i ) ) );
+        program->setParams( material );
+        program->setParams( object );
+    }
+    f32 packedTime = timer.elapsed();
+
+    // both upload same values, GL stub counts uniform calls of program
+    MapProgram::Uniform* color = nullptr;
+    MapProgram::Uniform* mvp = nullptr;
+    ASSERT_TRUE( mapProgram.binding.tryGet( "color", color ) );
+    ASSERT_TRUE( mapProgram.binding.tryGet( "mvp", mvp ) );
+    EXPECT_EQ( color->uploads + mvp->uploads, glstub::calls().uniforms );
+    printf( "map of variants:     %.1f ns/draw\n", mapTime * 1e6f / kDraws );
+    printf( "GpuProgram params:   %.1f ns/draw\n", packedTime * 1e6f / kDraws );
+    delete program;
+}
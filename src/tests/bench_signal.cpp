@@ -0,0 +1,133 @@
+/**
+ * \file
+ * \brief       parent to child propagation: string keyed map of std::function vs delegate array
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "game/signal.h"
+#include "game/components/transform.h"
+#include "math/matrix-inl.h"
+#include "base/timer.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+using namespace base;
+using namespace base::game;
+
+namespace {
+
+const u32 kDepth = 64;
+const u32 kChildren = 4;
+const u32 kEmits = 2000;
+
+//! Previous signal, emit copies every map entry
+class MapSignal
+{
+public:
+    typedef std::function<void()> Slot;
+    void connect(const std::string& name, Slot slot) {
+        slots_[name] = slot;
+    }
+    void emit() {
+        for (auto it: slots_) {
+            Slot slot = it.second;
+            slot();
+        }
+    }
+private:
+    std::map<std::string, Slot> slots_;
+};
+
+struct MapNode
+{
+    MapSignal signal;
+    u32 updates;
+    void update() {
+        updates++;
+        signal.emit();
+    }
+};
+
+struct Node
+{
+    Signal signal;
+    u32 updates;
+    void update() {
+        updates++;
+        signal.emit();
+    }
+};
+
+}
+
+TEST( signal, bench_deep_hierarchy )
+{
+    // chain of kDepth levels, every level has kChildren leaves and one next level
+    std::vector<std::unique_ptr<MapNode>> mapNodes;
+    std::vector<std::unique_ptr<Node>> nodes;
+    mapNodes.push_back( std::unique_ptr<MapNode>( new MapNode() ) );
+    nodes.push_back( std::unique_ptr<Node>( new Node() ) );
+    MapNode* mapParent = mapNodes[0].get();
+    Node* parent = nodes[0].get();
+    for ( u32 level = 0; level < kDepth; level++ ) {
+        MapNode* mapNext = nullptr;
+        Node* next = nullptr;
+        for ( u32 c = 0; c <= kChildren; c++ ) {
+            mapNodes.push_back( std::unique_ptr<MapNode>( new MapNode() ) );
+            nodes.push_back( std::unique_ptr<Node>( new Node() ) );
+            MapNode* m = mapNodes.back().get();
+            Node* n = nodes.back().get();
+            char name[32];
+            snprintf( name, sizeof( name ), "node%u_%u.transform", level, c );
+            mapParent->signal.connect( name, std::bind( &MapNode::update, m ) );
+            parent->signal.connect<Node, &Node::update>( n );
+            mapNext = m;
+            next = n;
+        }
+        mapParent = mapNext;
+        parent = next;
+    }
+    for ( auto& n : mapNodes ) n->updates = 0;
+    for ( auto& n : nodes ) n->updates = 0;
+
+    Timer timer;
+    for ( u32 i = 0; i < kEmits; i++ )
+        mapNodes[0]->update();
+    f32 mapTime = timer.elapsed();
+
+    timer.reset();
+    for ( u32 i = 0; i < kEmits; i++ )
+        nodes[0]->update();
+    f32 arrayTime = timer.elapsed();
+
+    for ( size_t i = 0; i < nodes.size(); i++ )
+        ASSERT_EQ( mapNodes[i]->updates, nodes[i]->updates );
+    f32 perNode = 1e6f / ( kEmits * nodes.size() );
+    printf( "map of std::function: %.1f ns/node\n", mapTime * perNode );
+    printf( "delegate array:       %.1f ns/node\n", arrayTime * perNode );
+}
+
+TEST( signal, bench_transform_chain )
+{
+    std::vector<std::unique_ptr<Transform>> chain;
+    for ( u32 i = 0; i < kDepth * 4; i++ ) {
+        chain.push_back( std::unique_ptr<Transform>( new Transform() ) );
+        chain.back()->setPosition( math::vec3f( 0, 1, 0 ) );
+        if ( i > 0 )
+            chain.back()->setParent( chain[i - 1].get() );
+    }
+    Timer timer;
+    for ( u32 i = 0; i < kEmits; i++ )
+        chain[0]->update();
+    f32 time = timer.elapsed();
+    EXPECT_FLOAT_EQ( static_cast<f32>( chain.size() ), chain.back()->world().Elem( 3, 1 ) );
+    printf( "transform chain:      %.1f ns/transform\n", time * 1e6f / ( kEmits * chain.size() ) );
+    // children disconnect before parents are destroyed
+    while ( !chain.empty() )
+        chain.pop_back();
+}
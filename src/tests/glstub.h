@@ -0,0 +1,347 @@
+/**
+ * \file
+ * \brief       stub GL functions which count calls, for render tests without GPU
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#pragma once
+
+#include "gtest/gtest.h"
+#include "render/glcontext.h"
+#include "render/gpuprogram.h"
+#include "base/memorytags.h"
+#include "math/vec4.h"
+#include <string.h>
+#include <vector>
+#include <map>
+#include <initializer_list>
+
+namespace glstub {
+
+using base::u32;
+
+//! Buffer range bound by BindBufferRange
+struct Range
+{
+    u32 index;
+    u32 offset;
+    u32 size;
+};
+
+//! Arguments of VertexAttribPointer
+struct Pointer
+{
+    u32 size;
+    u32 type;
+    bool normalized;
+    u32 stride;
+    u32 offset;
+};
+
+//! Calls seen by stub functions
+struct Calls
+{
+    bool blocks;                                //!< programs linked now declare uniform blocks
+    bool instanceArray;                         //!< and mvp in Object block is array of 4
+    bool oldContext;                            //!< context is GL 3.2 instead of 3.3
+    std::vector<const char*> extensions;
+    u32 useProgram;
+    u32 genBuffers;
+    u32 bufferData;
+    u32 genVertexArrays;
+    u32 bindVertexArray;
+    u32 deleteVertexArrays;
+    u32 vertexArray;                            //!< bound vertex array
+    std::map<u32, u32> elementBuffers;          //!< element array buffer of each vertex array
+    u32 enableAttrib;
+    u32 disableAttrib;
+    u32 attribPointer;
+    u32 draws;
+    u32 uniforms;                               //!< Uniform* calls
+    base::math::vec4f color;                    //!< last value of "color" uniform
+    std::vector<base::math::vec4f> drawColors;  //!< color at each draw
+    std::vector<u32> drawOffsets;               //!< index offset in bytes at each draw
+    std::vector<u32> drawInstances;             //!< instance count of each instanced draw
+    std::vector<u32> bufferSizes;               //!< size of each BufferData
+    std::vector<u32> drawTypes;                 //!< index type of each draw
+    std::vector<Pointer> pointers;
+    std::vector<base::u8> storage;              //!< contents of buffer made by BufferStorage
+    std::vector<u32> subDataOffsets;            //!< offset of each BufferSubData
+    std::vector<u32> subDataSizes;
+    u32 unmaps;
+    u32 fences;                                 //!< fences alive
+    u32 clientWaits;
+    u32 timeouts;                               //!< count of ClientWaitSync calls to time out
+    u32 blockBindings[3];                       //!< binding point of each block
+    std::vector<Range> ranges;
+};
+
+inline Calls& calls()
+{
+    static Calls c;
+    return c;
+}
+
+// stub programs have two active uniforms, location is index in this table
+static const char* kUniforms[] = { "color", "mvp" };
+static const GLenum kUniformTypes[] = { GL_FLOAT_VEC4, GL_FLOAT_MAT4 };
+
+// with blocks, each uniform is only member of its block, all at offset 0:
+//   uniform Object { mat4 mvp; } object;
+//   uniform Frame { float time; };
+//   uniform Material { vec4 color; };
+static const char* kBlockUniforms[] = { "object.mvp", "time", "color" };
+static const GLenum kBlockUniformTypes[] = { GL_FLOAT_MAT4, GL_FLOAT, GL_FLOAT_VEC4 };
+static const char* kBlocks[] = { "Object", "Frame", "Material" };
+static const GLint kBlockSizes[] = { 64, 16, 16 };
+
+static GLuint APIENTRY createProgram() { return 1; }
+static GLuint APIENTRY createShader( GLenum ) { return 1; }
+static void APIENTRY shaderSource( GLuint, GLsizei, const GLchar* const*, const GLint* ) {}
+static void APIENTRY handle( GLuint ) {}
+static void APIENTRY attachShader( GLuint, GLuint ) {}
+static void APIENTRY bindAttribLocation( GLuint, GLuint, const GLchar* ) {}
+static void APIENTRY shaderiv( GLuint, GLenum pname, GLint* params )
+{
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+static void APIENTRY programiv( GLuint, GLenum pname, GLint* params )
+{
+    switch ( pname ) {
+        case GL_LINK_STATUS: *params = GL_TRUE; break;
+        case GL_ACTIVE_UNIFORMS: *params = calls().blocks ? 3 : 2; break;
+        case GL_ACTIVE_UNIFORM_BLOCKS: *params = calls().blocks ? 3 : 0; break;
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH: *params = 16; break;
+        default: *params = 0;
+    }
+}
+static void APIENTRY activeUniform( GLuint, GLuint index, GLsizei, GLsizei* length, GLint* size, GLenum* type, GLchar* name )
+{
+    const char* uniform = calls().blocks ? kBlockUniforms[index] : kUniforms[index];
+    if ( calls().instanceArray && index == 0 )
+        uniform = "object.mvp[0]";
+    *length = static_cast<GLsizei>( strlen( uniform ) );
+    *size = 1;
+    *type = calls().blocks ? kBlockUniformTypes[index] : kUniformTypes[index];
+    memcpy( name, uniform, *length );
+}
+static void APIENTRY activeUniformsiv( GLuint, GLsizei count, const GLuint* indices, GLenum pname, GLint* params )
+{
+    for ( GLsizei i = 0; i < count; i++ ) {
+        GLuint index = indices[i];
+        switch ( pname ) {
+            case GL_UNIFORM_BLOCK_INDEX: params[i] = calls().blocks ? static_cast<GLint>( index ) : -1; break;
+            case GL_UNIFORM_TYPE: params[i] = kBlockUniformTypes[index]; break;
+            case GL_UNIFORM_MATRIX_STRIDE: params[i] = kBlockUniformTypes[index] == GL_FLOAT_MAT4 ? 16 : 0; break;
+            case GL_UNIFORM_SIZE: params[i] = calls().instanceArray && index == 0 ? 4 : 1; break;
+            case GL_UNIFORM_ARRAY_STRIDE: params[i] = calls().instanceArray && index == 0 ? 64 : 0; break;
+            default: params[i] = 0;
+        }
+    }
+}
+static void APIENTRY activeUniformBlockiv( GLuint, GLuint block, GLenum pname, GLint* params )
+{
+    switch ( pname ) {
+        case GL_UNIFORM_BLOCK_NAME_LENGTH: *params = static_cast<GLint>( strlen( kBlocks[block] ) + 1 ); break;
+        case GL_UNIFORM_BLOCK_DATA_SIZE: *params = calls().instanceArray && block == 0 ? 256 : kBlockSizes[block]; break;
+        case GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS: *params = 1; break;
+        case GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES: *params = static_cast<GLint>( block ); break;
+        default: *params = 0;
+    }
+}
+static void APIENTRY activeUniformBlockName( GLuint, GLuint block, GLsizei, GLsizei*, GLchar* name )
+{
+    strcpy( name, kBlocks[block] );
+}
+static void APIENTRY uniformBlockBinding( GLuint, GLuint block, GLuint binding )
+{
+    calls().blockBindings[block] = binding;
+}
+static void APIENTRY getIntegerv( GLenum pname, GLint* data )
+{
+    switch ( pname ) {
+        case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT: *data = 256; break;
+        case GL_MAJOR_VERSION: *data = 3; break;
+        case GL_MINOR_VERSION: *data = calls().oldContext ? 2 : 3; break;
+        case GL_NUM_EXTENSIONS: *data = static_cast<GLint>( calls().extensions.size() ); break;
+        default: *data = 0;
+    }
+}
+static const GLubyte* APIENTRY getStringi( GLenum, GLuint index )
+{
+    return reinterpret_cast<const GLubyte*>( calls().extensions[index] );
+}
+static void APIENTRY bindBufferRange( GLenum, GLuint index, GLuint, GLintptr offset, GLsizeiptr size )
+{
+    Range range = { index, static_cast<u32>( offset ), static_cast<u32>( size ) };
+    calls().ranges.push_back( range );
+}
+static GLint APIENTRY uniformLocation( GLuint, const GLchar* name )
+{
+    return strcmp( name, kUniforms[0] ) == 0 ? 0 : 1;
+}
+static void APIENTRY useProgram( GLuint ) { calls().useProgram++; }
+static void APIENTRY uniform4f( GLint, GLfloat x, GLfloat y, GLfloat z, GLfloat w )
+{
+    calls().uniforms++;
+    calls().color = base::math::vec4f( x, y, z, w );
+}
+static void APIENTRY uniformMatrix( GLint, GLsizei, GLboolean, const GLfloat* ) { calls().uniforms++; }
+static void APIENTRY genObjects( GLsizei n, GLuint* names )
+{
+    static GLuint last = 0;
+    for ( GLsizei i = 0; i < n; i++ )
+        names[i] = ++last;
+}
+static void APIENTRY genBuffers( GLsizei n, GLuint* names ) { calls().genBuffers++; genObjects( n, names ); }
+static void APIENTRY deleteObjects( GLsizei, const GLuint* ) {}
+static void APIENTRY bindBuffer( GLenum target, GLuint buffer )
+{
+    if ( target == GL_ELEMENT_ARRAY_BUFFER )
+        calls().elementBuffers[calls().vertexArray] = buffer;
+}
+static void APIENTRY bufferData( GLenum, GLsizeiptr size, const void*, GLenum )
+{
+    calls().bufferData++;
+    calls().bufferSizes.push_back( static_cast<u32>( size ) );
+}
+static void APIENTRY bufferSubData( GLenum, GLintptr offset, GLsizeiptr size, const void* )
+{
+    calls().subDataOffsets.push_back( static_cast<u32>( offset ) );
+    calls().subDataSizes.push_back( static_cast<u32>( size ) );
+}
+static void APIENTRY bufferStorage( GLenum, GLsizeiptr size, const void*, GLbitfield )
+{
+    calls().storage.resize( size );
+}
+static void* APIENTRY mapBufferRange( GLenum, GLintptr offset, GLsizeiptr, GLbitfield )
+{
+    return calls().storage.data() + offset;
+}
+static GLboolean APIENTRY unmapBuffer( GLenum ) { calls().unmaps++; return GL_TRUE; }
+static GLsync APIENTRY fenceSync( GLenum, GLbitfield )
+{
+    calls().fences++;
+    return reinterpret_cast<GLsync>( static_cast<base::uptr>( calls().fences ) );
+}
+static void APIENTRY deleteSync( GLsync ) { calls().fences--; }
+static GLenum APIENTRY clientWaitSync( GLsync, GLbitfield, GLuint64 )
+{
+    calls().clientWaits++;
+    if ( calls().timeouts == 0 )
+        return GL_ALREADY_SIGNALED;
+    calls().timeouts--;
+    return GL_TIMEOUT_EXPIRED;
+}
+static void APIENTRY genVertexArrays( GLsizei n, GLuint* names ) { calls().genVertexArrays++; genObjects( n, names ); }
+static void APIENTRY bindVertexArray( GLuint array ) { calls().bindVertexArray++; calls().vertexArray = array; }
+static void APIENTRY deleteVertexArrays( GLsizei, const GLuint* ) { calls().deleteVertexArrays++; }
+static void APIENTRY enableAttrib( GLuint ) { calls().enableAttrib++; }
+static void APIENTRY disableAttrib( GLuint ) { calls().disableAttrib++; }
+static void APIENTRY attribPointer( GLuint, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset )
+{
+    calls().attribPointer++;
+    Pointer pointer = { static_cast<u32>( size ), type, normalized == GL_TRUE, static_cast<u32>( stride ),
+        static_cast<u32>( reinterpret_cast<base::uptr>( offset ) ) };
+    calls().pointers.push_back( pointer );
+}
+static void APIENTRY drawElements( GLenum, GLsizei, GLenum type, const void* offset )
+{
+    calls().draws++;
+    calls().drawTypes.push_back( type );
+    calls().drawColors.push_back( calls().color );
+    calls().drawOffsets.push_back( static_cast<u32>( reinterpret_cast<base::uptr>( offset ) ) );
+}
+static void APIENTRY drawElementsInstanced( GLenum mode, GLsizei count, GLenum type, const void* offset, GLsizei instances )
+{
+    drawElements( mode, count, type, offset );
+    calls().drawInstances.push_back( static_cast<u32>( instances ) );
+}
+
+//! Resets counters, sets stub functions and creates render state of context
+inline void init( base::opengl::DeviceContext& GL )
+{
+    calls() = Calls();
+    GL.CreateProgram = createProgram;
+    GL.CreateShader = createShader;
+    GL.ShaderSource = shaderSource;
+    GL.CompileShader = handle;
+    GL.GetShaderiv = shaderiv;
+    GL.DeleteShader = handle;
+    GL.DeleteProgram = handle;
+    GL.AttachShader = attachShader;
+    GL.BindAttribLocation = bindAttribLocation;
+    GL.LinkProgram = handle;
+    GL.GetProgramiv = programiv;
+    GL.GetActiveUniform = activeUniform;
+    GL.GetActiveUniformsiv = activeUniformsiv;
+    GL.GetActiveUniformBlockiv = activeUniformBlockiv;
+    GL.GetActiveUniformBlockName = activeUniformBlockName;
+    GL.UniformBlockBinding = uniformBlockBinding;
+    GL.GetIntegerv = getIntegerv;
+    GL.GetStringi = getStringi;
+    GL.BindBufferRange = bindBufferRange;
+    GL.GetUniformLocation = uniformLocation;
+    GL.UseProgram = useProgram;
+    GL.Uniform4f = uniform4f;
+    GL.UniformMatrix4fv = uniformMatrix;
+    GL.GenBuffers = genBuffers;
+    GL.DeleteBuffers = deleteObjects;
+    GL.BindBuffer = bindBuffer;
+    GL.BufferData = bufferData;
+    GL.BufferSubData = bufferSubData;
+    GL.BufferStorage = bufferStorage;
+    GL.MapBufferRange = mapBufferRange;
+    GL.UnmapBuffer = unmapBuffer;
+    GL.FenceSync = fenceSync;
+    GL.DeleteSync = deleteSync;
+    GL.ClientWaitSync = clientWaitSync;
+    GL.GenVertexArrays = genVertexArrays;
+    GL.BindVertexArray = bindVertexArray;
+    GL.DeleteVertexArrays = deleteVertexArrays;
+    GL.EnableVertexAttribArray = enableAttrib;
+    GL.DisableVertexAttribArray = disableAttrib;
+    GL.VertexAttribPointer = attribPointer;
+    GL.DrawElements = drawElements;
+    GL.DrawElementsInstanced = drawElementsInstanced;
+    GL.createState();
+}
+
+//! Attribute of program made by makeProgram()
+struct Attribute
+{
+    const char* name;
+    base::opengl::VertexAttr attr;
+    u32 idx;
+};
+
+//! Program linked by stub functions, which do not compile sources.
+//! Flags of calls() which change linking are set before
+inline base::opengl::GpuProgram* makeProgram( base::opengl::DeviceContext& GL,
+    std::initializer_list<Attribute> attributes = {}, const char* vs = "", const char* ps = "" )
+{
+    using namespace base::opengl;
+    GpuProgram* program = new GpuProgram( GL );
+    for ( const Attribute& attribute : attributes )
+        program->setAttribute( attribute.name, attribute.attr, attribute.idx );
+    program->setShaderSource( ShaderType::VERTEX, vs );
+    program->setShaderSource( ShaderType::PIXEL, ps );
+    program->complete();
+    return program;
+}
+
+//! Fixture with memory tags and device context on stub functions
+struct Test : public ::testing::Test
+{
+    void SetUp() {
+        base::memory::init();
+        init( GL );
+    }
+    void TearDown() {
+        base::memory::shutdown();
+    }
+
+    base::opengl::DeviceContext GL;
+};
+
+} // namespace glstub
@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
 #include "base/any.h"
+#include "math/matrix.h"
+#include "math/matrix-inl.h"
 #include <string>
+#include <vector>
 
 using namespace base;
 
@@ -14,3 +17,33 @@ TEST(any, easy)
     std::string str1 = any_cast<std::string>(str);
     EXPECT_STREQ("blah", str1.c_str());
 }
+
+TEST(any, inline_storage)
+{
+    EXPECT_TRUE(any::isInline<int>());
+    EXPECT_TRUE(any::isInline<math::Matrix4>());
+    EXPECT_FALSE(any::isInline<char[128]>());
+
+    math::Matrix4 m = math::Matrix4::Identity();
+    any value(m);
+    EXPECT_EQ(1.0f, any_cast<math::Matrix4>(value).Elem(2, 2));
+}
+
+TEST(any, move)
+{
+    any str(std::string("moved"));
+    any other(std::move(str));
+    EXPECT_TRUE(str.empty());
+    EXPECT_STREQ("moved", any_cast<std::string>(other).c_str());
+
+    any value(1);
+    value = std::move(other);
+    EXPECT_TRUE(other.empty());
+    EXPECT_STREQ("moved", any_cast<std::string>(value).c_str());
+
+    std::vector<int> big(100, 7);
+    any a(big), b(2.5f);
+    a.swap(b);
+    EXPECT_EQ(2.5f, any_cast<float>(a));
+    EXPECT_EQ(100u, any_cast<std::vector<int>&>(b).size());
+}
@@ -0,0 +1,250 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "math/batch.h"
+#include "math/matrix-inl.h"
+#include "base/cpu.h"
+#include <algorithm>
+#include <vector>
+
+using namespace base;
+using namespace base::math;
+
+namespace {
+
+//! Stream with its own storage
+struct Points
+{
+    std::vector<f32> x, y, z;
+
+    explicit Points( u32 count ) : x( count ), y( count ), z( count ) {}
+
+    batch::Vec3SoA soa() {
+        batch::Vec3SoA s = { x.data(), y.data(), z.data() };
+        return s;
+    }
+    vec3f at( u32 i ) const { return vec3f( x[i], y[i], z[i] ); }
+};
+
+Points makePoints( u32 count )
+{
+    Points p( count );
+    for ( u32 i = 0; i < count; i++ ) {
+        f32 t = static_cast<f32>( i );
+        p.x[i] = 1.0f + t;
+        p.y[i] = 2.0f - 0.5f * t;
+        p.z[i] = 0.25f * t * t - 3.0f;
+    }
+    return p;
+}
+
+const Matrix4 kWorld = Matrix4::Translation( vec3f( 1.0f, -2.0f, 5.0f ) )
+                       * Matrix4::RotationZ( 0.4f ) * Matrix4::RotationX( 1.1f )
+                       * Matrix4::Scale( vec3f( 2.0f, 1.0f, 0.5f ) );
+
+void expectNear( const vec3f& a, const vec3f& b, f32 tolerance = 1e-4f )
+{
+    EXPECT_NEAR( a.x, b.x, tolerance );
+    EXPECT_NEAR( a.y, b.y, tolerance );
+    EXPECT_NEAR( a.z, b.z, tolerance );
+}
+
+// counts cover empty input, tail only, full blocks and block with tail
+const u32 kCounts[] = { 0, 1, 3, 4, 8, 13 };
+
+} // namespace
+
+TEST( batch, transform_points )
+{
+    for ( u32 count : kCounts ) {
+        Points in = makePoints( count );
+        Points out( count );
+        batch::transformPoints( kWorld, in.soa(), out.soa(), count );
+        for ( u32 i = 0; i < count; i++ )
+            expectNear( ( kWorld * vec4f( in.at( i ), 1.0f ) ).xyz(), out.at( i ) );
+        // in place
+        batch::transformPoints( kWorld, in.soa(), in.soa(), count );
+        for ( u32 i = 0; i < count; i++ )
+            expectNear( out.at( i ), in.at( i ) );
+    }
+}
+
+TEST( batch, transform_normals )
+{
+    const Matrix4 normalMatrix = Transpose( Inverse( kWorld ) );
+    for ( u32 count : kCounts ) {
+        Points in = makePoints( count );
+        Points out( count );
+        batch::transformNormals( normalMatrix, in.soa(), out.soa(), count );
+        for ( u32 i = 0; i < count; i++ ) {
+            vec3f expected = normalize( ( normalMatrix * in.at( i ) ).xyz() );
+            expectNear( expected, out.at( i ) );
+        }
+    }
+    // zero normal does not turn into NaN
+    Points zero( 5 );
+    batch::transformNormals( normalMatrix, zero.soa(), zero.soa(), 5 );
+    for ( u32 i = 0; i < 5; i++ )
+        expectNear( vec3f( 0.0f ), zero.at( i ) );
+}
+
+TEST( batch, multiply )
+{
+    std::vector<Matrix4> in, out( 7 );
+    for ( u32 i = 0; i < 7; i++ )
+        in.push_back( Matrix4::RotationY( 0.3f * i ) * Matrix4::Translation( vec3f( 1.0f * i, 0.0f, 2.0f ) ) );
+    batch::multiply( kWorld, in.data(), out.data(), 7 );
+    for ( u32 i = 0; i < 7; i++ ) {
+        Matrix4 expected = kWorld * in[i];
+        for ( u32 c = 0; c < 4; c++ )
+            for ( u32 r = 0; r < 4; r++ )
+                EXPECT_NEAR( expected.Elem( c, r ), out[i].Elem( c, r ), 1e-4f );
+    }
+    batch::multiply( kWorld, in.data(), in.data(), 7 );
+    for ( u32 i = 0; i < 7; i++ )
+        EXPECT_TRUE( in[i] == out[i] );
+}
+
+TEST( batch, bounds )
+{
+    for ( u32 count : kCounts ) {
+        if ( count == 0 )
+            continue;
+        Points p = makePoints( count );
+        vec3f min, max;
+        batch::bounds( p.soa(), count, min, max );
+        vec3f expectedMin = p.at( 0 ), expectedMax = p.at( 0 );
+        for ( u32 i = 1; i < count; i++ )
+            for ( int j = 0; j < 3; j++ ) {
+                expectedMin[j] = std::min( expectedMin[j], p.at( i )[j] );
+                expectedMax[j] = std::max( expectedMax[j], p.at( i )[j] );
+            }
+        expectNear( expectedMin, min, 0.0f );
+        expectNear( expectedMax, max, 0.0f );
+    }
+}
+
+TEST( batch, transform_bounds )
+{
+    const u32 count = 6;
+    Points lo = makePoints( count ), hi = makePoints( count );
+    std::vector<Matrix4> matrices;
+    for ( u32 i = 0; i < count; i++ ) {
+        hi.x[i] += 1.0f;
+        hi.y[i] += 2.0f;
+        hi.z[i] += 0.5f * i;
+        matrices.push_back( kWorld * Matrix4::RotationY( 0.7f * i ) );
+    }
+    Points outLo( count ), outHi( count );
+    batch::BoxSoA in = { lo.soa(), hi.soa() };
+    batch::BoxSoA out = { outLo.soa(), outHi.soa() };
+    batch::transformBounds( matrices.data(), in, out, count );
+    for ( u32 i = 0; i < count; i++ ) {
+        // box of eight transformed corners
+        vec3f expectedMin( 1e30f ), expectedMax( -1e30f );
+        for ( u32 corner = 0; corner < 8; corner++ ) {
+            vec3f p( corner & 1 ? hi.x[i] : lo.x[i], corner & 2 ? hi.y[i] : lo.y[i], corner & 4 ? hi.z[i] : lo.z[i] );
+            vec3f t = ( matrices[i] * vec4f( p, 1.0f ) ).xyz();
+            for ( int j = 0; j < 3; j++ ) {
+                expectedMin[j] = std::min( expectedMin[j], t[j] );
+                expectedMax[j] = std::max( expectedMax[j], t[j] );
+            }
+        }
+        expectNear( expectedMin, outLo.at( i ) );
+        expectNear( expectedMax, outHi.at( i ) );
+    }
+}
+
+TEST( batch, interleave )
+{
+    for ( u32 count : kCounts ) {
+        std::vector<vec3f> aos( count ), back( count );
+        for ( u32 i = 0; i < count; i++ )
+            aos[i] = vec3f( 1.0f * i, 10.0f * i, 100.0f * i );
+        Points soa( count );
+        batch::deinterleave( aos.data(), soa.soa(), count );
+        for ( u32 i = 0; i < count; i++ )
+            EXPECT_TRUE( aos[i] == soa.at( i ) );
+        batch::interleave( soa.soa(), back.data(), count );
+        for ( u32 i = 0; i < count; i++ )
+            EXPECT_TRUE( aos[i] == back[i] );
+    }
+}
+
+TEST( batch, cull_boxes )
+{
+    // frustum planes are extracted the same way as in Camera::update
+    const Matrix4 clip = Matrix4::Perspective( 1.2f, 1.0f, 1.0f, 100.0f )
+                         * Matrix4::LookAt( vec3f( 0.0f ), vec3f( 0.0f, 0.0f, -1.0f ), vec3f( 0.0f, 1.0f, 0.0f ) );
+    Plane planes[6];
+    for ( int i = 0; i < 3; i++ ) {
+        planes[i * 2].set( clip.Row( 3 ) + clip.Row( i ) );
+        planes[i * 2 + 1].set( clip.Row( 3 ) - clip.Row( i ) );
+    }
+    // unit boxes at these centers
+    const vec3f centers[] = {
+        vec3f( 0.0f, 0.0f, -10.0f ),    // inside
+        vec3f( 0.0f, 0.0f, 10.0f ),     // behind
+        vec3f( 0.0f, 0.0f, -200.0f ),   // beyond far plane
+        vec3f( 50.0f, 0.0f, -10.0f ),   // right
+        vec3f( 0.0f, -50.0f, -10.0f ),  // below
+        vec3f( 0.0f, 0.0f, -100.5f ),   // crosses far plane
+        vec3f( 7.0f, 0.0f, -10.0f ),    // crosses right plane
+        vec3f( 0.0f, 0.0f, -0.5f ),     // crosses near plane
+        vec3f( -3.0f, 2.0f, -30.0f ),   // inside
+    };
+    const u8 expected[] = { 1, 0, 0, 0, 0, 1, 1, 1, 1 };
+    const u32 count = sizeof( expected );
+    Points lo( count ), hi( count );
+    for ( u32 i = 0; i < count; i++ ) {
+        lo.x[i] = centers[i].x - 1.0f;
+        lo.y[i] = centers[i].y - 1.0f;
+        lo.z[i] = centers[i].z - 1.0f;
+        hi.x[i] = centers[i].x + 1.0f;
+        hi.y[i] = centers[i].y + 1.0f;
+        hi.z[i] = centers[i].z + 1.0f;
+    }
+    batch::BoxSoA boxes = { lo.soa(), hi.soa() };
+    u8 visible[count];
+    EXPECT_EQ( 5u, batch::cullBoxes( planes, 6, boxes, count, visible ) );
+    for ( u32 i = 0; i < count; i++ )
+        EXPECT_EQ( expected[i], visible[i] ) << "box " << i;
+}
+
+TEST( batch, tiers_agree )
+{
+    // every kernel variant gives the same result as baseline one
+    const cpu::Tier saved = cpu::tier();
+    const u32 count = 37;
+    const Matrix4 normalMatrix = Transpose( Inverse( kWorld ) );
+    Points in = makePoints( count );
+    Points points[2] = { Points( count ), Points( count ) };
+    Points normals[2] = { Points( count ), Points( count ) };
+    vec3f min[2], max[2];
+    u8 visible[2][count];
+    u32 visibleCount[2];
+    Plane planes[2] = { Plane( vec3f( 1.0f, 0.0f, 0.0f ), -5.0f ), Plane( vec3f( 0.0f, -1.0f, 0.0f ), 0.0f ) };
+    for ( u32 tier = 0; tier <= static_cast<u32>( cpu::supportedTier() ); tier++ ) {
+        u32 k = tier == 0 ? 0 : 1;
+        cpu::setTier( static_cast<cpu::Tier>( tier ) );
+        batch::transformPoints( kWorld, in.soa(), points[k].soa(), count );
+        batch::transformNormals( normalMatrix, in.soa(), normals[k].soa(), count );
+        batch::bounds( in.soa(), count, min[k], max[k] );
+        batch::BoxSoA boxes = { in.soa(), points[0].soa() };
+        visibleCount[k] = batch::cullBoxes( planes, 2, boxes, count, visible[k] );
+        if ( k == 0 )
+            continue;
+        for ( u32 i = 0; i < count; i++ ) {
+            expectNear( points[0].at( i ), points[1].at( i ) );
+            expectNear( normals[0].at( i ), normals[1].at( i ), 1e-5f );
+            EXPECT_EQ( visible[0][i], visible[1][i] ) << cpu::tierName( cpu::tier() ) << " box " << i;
+        }
+        expectNear( min[0], min[1], 0.0f );
+        expectNear( max[0], max[1], 0.0f );
+        EXPECT_EQ( visibleCount[0], visibleCount[1] );
+    }
+    cpu::setTier( saved );
+}
@@ -0,0 +1,189 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "render/commandbuffer.h"
+#include "render/glcontext.h"
+#include "render/gpuprogram.h"
+#include "render/mesh.h"
+#include "base/parameter.h"
+#include "tests/glstub.h"
+#include <stdlib.h>
+#include <vector>
+
+using namespace base;
+using namespace base::opengl;
+
+namespace {
+
+//! Device context with stub functions, two programs, three materials and one mesh
+struct command_buffer : public glstub::Test
+{
+    void SetUp() {
+        glstub::Test::SetUp();
+        for ( u32 i = 0; i < 2; i++ )
+            programs[i] = glstub::makeProgram( GL );
+        for ( u32 i = 0; i < 3; i++ )
+            materials[i].set( StringId( "color" ), Variant( math::vec4f( static_cast<f32>( i ), 0.0f, 0.0f, 1.0f ) ) );
+        mesh = new Mesh;
+        mesh->addAttribute( VertexAttrs::tagPosition ).vertexCount( 3 ).indexCount( 3, IndexTypes::UInt16 );
+        mesh->complete();
+    }
+    void TearDown() {
+        delete mesh;
+        delete programs[0];
+        delete programs[1];
+        glstub::Test::TearDown();
+    }
+
+    DrawCommand command( u32 program, u32 material, const Params* meshParams = nullptr ) {
+        DrawCommand c;
+        c.mesh = mesh;
+        c.program = programs[program];
+        c.materialParams = &materials[material];
+        c.meshParams = meshParams;
+        c.mvp = &mvp;
+        c.instances = 1;
+        c.from = 0;
+        c.count = 3;
+        return c;
+    }
+
+    GpuProgram* programs[2];
+    Params materials[3];
+    Mesh* mesh;
+    math::Matrix4 mvp;
+};
+
+} // namespace
+
+TEST( command_buffer_key, order )
+{
+    // pass, then program, then material, then depth
+    EXPECT_LT( CommandBuffer::makeKey( 0, 9, 9, 1e6f ), CommandBuffer::makeKey( 1, 0, 0, 0.0f ) );
+    EXPECT_LT( CommandBuffer::makeKey( 1, 0, 9, 1e6f ), CommandBuffer::makeKey( 1, 1, 0, 0.0f ) );
+    EXPECT_LT( CommandBuffer::makeKey( 1, 1, 0, 1e6f ), CommandBuffer::makeKey( 1, 1, 1, 0.0f ) );
+    EXPECT_LT( CommandBuffer::makeKey( 1, 1, 1, 0.5f ), CommandBuffer::makeKey( 1, 1, 1, 2.0f ) );
+    EXPECT_LT( CommandBuffer::makeKey( 1, 1, 1, 2.0f ), CommandBuffer::makeKey( 1, 1, 1, 300.0f ) );
+    // behind camera is nearest
+    EXPECT_EQ( CommandBuffer::makeKey( 1, 1, 1, -5.0f ), CommandBuffer::makeKey( 1, 1, 1, 0.0f ) );
+}
+
+TEST_F( command_buffer, sort_is_stable )
+{
+    CommandBuffer buffer;
+    std::vector<math::Matrix4> matrices( 1000 );
+    srand( 7 );
+    for ( u32 i = 0; i < matrices.size(); i++ ) {
+        DrawCommand c = command( rand() % 2, rand() % 3 );
+        c.mvp = &matrices[i];
+        u32 pass = rand() % 3;
+        f32 depth = static_cast<f32>( rand() % 8 );
+        buffer.add( pass, depth, c );
+    }
+    buffer.sort();
+    ASSERT_EQ( matrices.size(), buffer.size() );
+    for ( u32 i = 1; i < buffer.size(); i++ ) {
+        ASSERT_LE( buffer.sortedKey( i - 1 ), buffer.sortedKey( i ) );
+        if ( buffer.sortedKey( i - 1 ) == buffer.sortedKey( i ) )
+            EXPECT_LT( buffer.sorted( i - 1 ).mvp, buffer.sorted( i ).mvp );
+    }
+}
+
+TEST_F( command_buffer, submit_groups_state )
+{
+    CommandBuffer buffer;
+    // interleaved order would switch program on every draw
+    for ( u32 i = 0; i < 60; i++ )
+        buffer.add( 0, static_cast<f32>( 60 - i ), command( i % 2, i % 3 ) );
+    CommandBuffer::Stats stats = buffer.submit( GL, Params() );
+
+    EXPECT_EQ( 60u, stats.draws );
+    EXPECT_EQ( 60u, glstub::calls().draws );
+    EXPECT_EQ( 2u, stats.programChanges );
+    EXPECT_EQ( 2u, glstub::calls().useProgram );
+    // each program sees every material
+    EXPECT_EQ( 6u, stats.materialChanges );
+    for ( u32 i = 1; i < buffer.size(); i++ ) {
+        if ( buffer.sorted( i - 1 ).program == buffer.sorted( i ).program
+             && buffer.sorted( i - 1 ).materialParams == buffer.sorted( i ).materialParams )
+            EXPECT_LT( buffer.sortedKey( i - 1 ) & 0xffffff, buffer.sortedKey( i ) & 0xffffff );
+    }
+
+    // second submit of same state does not bind anything
+    glstub::calls().useProgram = 0;
+    buffer.clear();
+    buffer.add( 0, 1.0f, command( 1, 2 ) );
+    stats = buffer.submit( GL, Params() );
+    EXPECT_EQ( 1u, stats.programChanges );
+    EXPECT_EQ( 0u, glstub::calls().useProgram );
+}
+
+TEST_F( command_buffer, ids_restart_after_clear )
+{
+    CommandBuffer buffer;
+    buffer.add( 0, 1.0f, command( 0, 0 ) );
+    buffer.add( 0, 1.0f, command( 1, 2 ) );
+    buffer.add( 0, 1.0f, command( 0, 2 ) );
+    buffer.sort();
+    const u64 idMask = 0xffffffffull << 24;
+    EXPECT_EQ( CommandBuffer::makeKey( 0, 1, 1, 1.0f ), buffer.sortedKey( 2 ) );
+    EXPECT_EQ( CommandBuffer::makeKey( 0, 0, 1, 1.0f ), buffer.sortedKey( 1 ) );
+
+    // objects of previous frame take no ids, first object of frame gets 0
+    buffer.clear();
+    buffer.add( 0, 1.0f, command( 1, 2 ) );
+    buffer.sort();
+    EXPECT_EQ( 0u, buffer.sortedKey( 0 ) & idMask );
+}
+
+TEST_F( command_buffer, mesh_params_override_material )
+{
+    Params meshParams;
+    meshParams.set( StringId( "color" ), Variant( math::vec4f( 7, 7, 7, 7 ) ) );
+    Params passParams;
+
+    CommandBuffer buffer;
+    buffer.add( 0, 1.0f, command( 0, 1 ) );
+    buffer.add( 0, 2.0f, command( 0, 1, &meshParams ) );
+    buffer.add( 0, 3.0f, command( 0, 1 ) );
+    buffer.submit( GL, passParams );
+    ASSERT_EQ( 3u, glstub::calls().drawColors.size() );
+    EXPECT_EQ( 1.0f, glstub::calls().drawColors[0].x );
+    EXPECT_EQ( 7.0f, glstub::calls().drawColors[1].x );
+    // material value is restored after mesh one
+    EXPECT_EQ( 1.0f, glstub::calls().drawColors[2].x );
+
+    // pass parameters win over material and mesh
+    passParams.set( StringId( "color" ), Variant( math::vec4f( 5, 5, 5, 5 ) ) );
+    glstub::calls().drawColors.clear();
+    buffer.submit( GL, passParams );
+    ASSERT_EQ( 3u, glstub::calls().drawColors.size() );
+    for ( u32 i = 0; i < 3; i++ )
+        EXPECT_EQ( 5.0f, glstub::calls().drawColors[i].x );
+}
+
+TEST_F( command_buffer, instances_without_array_are_drawn_one_by_one )
+{
+    math::Matrix4 matrices[3];
+    for ( u32 i = 0; i < 3; i++ ) {
+        matrices[i] = math::Matrix4::Identity();
+        matrices[i].SetElem( 0, 0, static_cast<f32>( i + 2 ) );
+    }
+    CommandBuffer buffer;
+    DrawCommand c = command( 0, 0 );
+    c.mvp = matrices;
+    c.instances = 3;
+    buffer.add( 0, 1.0f, c );
+    u32 uniforms = glstub::calls().uniforms;
+    CommandBuffer::Stats stats = buffer.submit( GL, Params() );
+
+    EXPECT_EQ( 3u, stats.draws );
+    EXPECT_EQ( 3u, stats.instances );
+    EXPECT_EQ( 3u, glstub::calls().draws );
+    EXPECT_TRUE( glstub::calls().drawInstances.empty() );
+    // color once, mvp for each instance
+    EXPECT_EQ( uniforms + 4, glstub::calls().uniforms );
+}
@@ -0,0 +1,45 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/cpu.h"
+
+using namespace base;
+
+TEST( cpu, tier_names )
+{
+    for ( u32 i = 0; i <= static_cast<u32>( cpu::Tier::AVX2 ); i++ ) {
+        cpu::Tier tier = static_cast<cpu::Tier>( i );
+        cpu::Tier parsed;
+        ASSERT_TRUE( cpu::parseTier( cpu::tierName( tier ), parsed ) );
+        EXPECT_EQ( tier, parsed );
+    }
+    cpu::Tier parsed = cpu::Tier::SSE41;
+    EXPECT_FALSE( cpu::parseTier( "avx512", parsed ) );
+    EXPECT_EQ( cpu::Tier::SSE41, parsed );
+}
+
+TEST( cpu, supported_tier )
+{
+    cpu::Tier supported = cpu::supportedTier();
+    if ( supported >= cpu::Tier::SSE41 )
+        EXPECT_TRUE( cpu::has( cpu::Features::SSE41 ) );
+    if ( supported == cpu::Tier::AVX2 ) {
+        EXPECT_TRUE( cpu::has( cpu::Features::AVX ) );
+        EXPECT_TRUE( cpu::has( cpu::Features::AVX2 ) );
+        EXPECT_TRUE( cpu::has( cpu::Features::FMA ) );
+    }
+    EXPECT_LE( cpu::tier(), supported );
+}
+
+TEST( cpu, set_tier )
+{
+    const cpu::Tier saved = cpu::tier();
+    EXPECT_EQ( cpu::Tier::Baseline, cpu::setTier( cpu::Tier::Baseline ) );
+    EXPECT_EQ( cpu::Tier::Baseline, cpu::tier() );
+    // never goes above what CPU has
+    EXPECT_EQ( cpu::supportedTier(), cpu::setTier( cpu::Tier::AVX2 ) );
+    cpu::setTier( saved );
+}
@@ -0,0 +1,122 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "math/fastmath.h"
+#include <math.h>
+#include <string.h>
+
+using namespace base;
+namespace fast = base::math::fast;
+
+namespace {
+
+const u32 kSamples = 1 << 20;
+
+//! Sample i of kSamples evenly spread over [from, to]
+f32 sample( u32 i, f32 from, f32 to )
+{
+    return from + ( to - from ) * ( static_cast<f32>( i ) / static_cast<f32>( kSamples - 1 ) );
+}
+
+#ifdef MATH_SSE
+bool sameBits( f32 a, f32 b )
+{
+    return memcmp( &a, &b, sizeof( f32 ) ) == 0;
+}
+
+f32 lane( __m128 v, u32 i )
+{
+    f32 lanes[4];
+    _mm_storeu_ps( lanes, v );
+    return lanes[i];
+}
+#endif
+
+} // namespace
+
+TEST( fastmath, sincos_error )
+{
+    f64 maxError = 0.0;
+    for ( u32 i = 0; i < kSamples; i++ ) {
+        f32 x = sample( i, -1000.0f, 1000.0f );
+        f32 s, c;
+        fast::sincos( x, s, c );
+        maxError = std::max( maxError, fabs( s - ::sin( static_cast<f64>( x ) ) ) );
+        maxError = std::max( maxError, fabs( c - ::cos( static_cast<f64>( x ) ) ) );
+    }
+    EXPECT_LT( maxError, 1e-7 );
+
+    // libm single precision for reference
+    f64 libmError = 0.0;
+    for ( u32 i = 0; i < kSamples; i++ ) {
+        f32 x = sample( i, -1000.0f, 1000.0f );
+        libmError = std::max( libmError, fabs( sinf( x ) - ::sin( static_cast<f64>( x ) ) ) );
+    }
+    EXPECT_LT( libmError, 6e-8 );
+}
+
+TEST( fastmath, sincos_values )
+{
+    const f32 pi = 3.14159265f;
+    EXPECT_EQ( 0.0f, fast::sin( 0.0f ) );
+    EXPECT_EQ( 1.0f, fast::cos( 0.0f ) );
+    EXPECT_NEAR( 1.0f, fast::sin( pi / 2 ), 1e-7f );
+    EXPECT_NEAR( -1.0f, fast::cos( pi ), 1e-7f );
+    EXPECT_NEAR( -1.0f, fast::sin( -pi / 2 ), 1e-7f );
+    EXPECT_NEAR( 0.0f, fast::cos( 3 * pi / 2 ), 1e-6f );
+}
+
+TEST( fastmath, atan2_error )
+{
+    f64 maxError = 0.0;
+    for ( u32 i = 0; i < kSamples; i++ ) {
+        f32 angle = sample( i, -3.2f, 3.2f );
+        f32 radius = 0.001f + ( i % 977 );
+        f32 y = radius * sinf( angle ), x = radius * cosf( angle );
+        maxError = std::max( maxError, fabs( fast::atan2( y, x ) - ::atan2( static_cast<f64>( y ), static_cast<f64>( x ) ) ) );
+    }
+    EXPECT_LT( maxError, 3e-7 );
+    EXPECT_EQ( 0.0f, fast::atan2( 0.0f, 0.0f ) );
+    EXPECT_EQ( 0.0f, fast::atan2( 0.0f, 1.0f ) );
+    EXPECT_NEAR( 3.14159265f, fast::atan2( 0.0f, -1.0f ), 1e-7f );
+    EXPECT_NEAR( -1.57079633f, fast::atan2( -2.0f, 0.0f ), 1e-7f );
+}
+
+TEST( fastmath, rsqrt_error )
+{
+    f64 maxError = 0.0;
+    for ( u32 i = 0; i < kSamples; i++ ) {
+        // mantissa sweep over several exponents
+        f32 x = ldexpf( sample( i, 1.0f, 4.0f ), static_cast<int>( i % 61 ) - 30 );
+        f64 exact = 1.0 / ::sqrt( static_cast<f64>( x ) );
+        maxError = std::max( maxError, fabs( fast::rsqrt( x ) - exact ) / exact );
+    }
+    EXPECT_LT( maxError, 3e-7 );
+}
+
+#ifdef MATH_SSE
+TEST( fastmath, simd_matches_scalar )
+{
+    for ( u32 i = 0; i < kSamples; i += 4 ) {
+        f32 x[4], y[4];
+        for ( u32 k = 0; k < 4; k++ ) {
+            x[k] = sample( i + k, -100.0f, 100.0f );
+            y[k] = sample( kSamples - 1 - i - k, -50.0f, 70.0f );
+        }
+        __m128 vx = _mm_loadu_ps( x ), vy = _mm_loadu_ps( y );
+        __m128 s, c;
+        fast::sincos( vx, s, c );
+        __m128 a = fast::atan2( vy, vx );
+        __m128 r = fast::rsqrt( _mm_mul_ps( vx, vx ) );
+        for ( u32 k = 0; k < 4; k++ ) {
+            ASSERT_TRUE( sameBits( fast::sin( x[k] ), lane( s, k ) ) ) << x[k];
+            ASSERT_TRUE( sameBits( fast::cos( x[k] ), lane( c, k ) ) ) << x[k];
+            ASSERT_TRUE( sameBits( fast::atan2( y[k], x[k] ), lane( a, k ) ) ) << y[k] << " " << x[k];
+            ASSERT_TRUE( sameBits( fast::rsqrt( x[k] * x[k] ), lane( r, k ) ) ) << x[k];
+        }
+    }
+}
+#endif
@@ -0,0 +1,64 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/frameallocator.h"
+#include "foundation/array.h"
+
+using base::FrameAllocator;
+using base::u32;
+using base::uptr;
+
+TEST( frameallocator, bump )
+{
+    foundation::memory_globals::init();
+    {
+        FrameAllocator frame( foundation::memory_globals::default_allocator(), 1024 );
+        void* a = frame.allocate( 10, 4 );
+        void* b = frame.allocate( 16, 16 );
+        EXPECT_EQ( 0u, reinterpret_cast<uptr>( b ) % 16 );
+        EXPECT_LT( reinterpret_cast<uptr>( a ), reinterpret_cast<uptr>( b ) );
+        EXPECT_GE( frame.used(), 26u );
+
+        // previous frame memory is still valid, then reused
+        frame.beginFrame();
+        EXPECT_EQ( 0u, frame.used() );
+        void* c = frame.allocate( 10, 4 );
+        EXPECT_NE( a, c );
+        frame.beginFrame();
+        EXPECT_EQ( a, frame.allocate( 10, 4 ) );
+    }
+    foundation::memory_globals::shutdown();
+}
+
+TEST( frameallocator, overflow_and_high_water )
+{
+    foundation::memory_globals::init();
+    {
+        FrameAllocator frame( foundation::memory_globals::default_allocator(), 256 );
+        foundation::Array<u32> values( frame );
+        for ( u32 i = 0; i < 1000; i++ )
+            foundation::array::push_back( values, i );
+        EXPECT_EQ( 999u, values[999] );
+        EXPECT_GT( frame.used(), 4000u );
+
+        frame.beginFrame();
+        EXPECT_GT( frame.overflows(), 0u );
+        EXPECT_GT( frame.highWater(), 4000u );
+        EXPECT_EQ( frame.highWater(), frame.lastFrameUsed() );
+        EXPECT_GE( frame.capacity(), frame.highWater() );
+
+        // both arenas have grown, no overflow in steady state
+        frame.beginFrame();
+        for ( int f = 0; f < 2; f++ ) {
+            foundation::Array<u32> more( frame );
+            for ( u32 i = 0; i < 1000; i++ )
+                foundation::array::push_back( more, i );
+            frame.beginFrame();
+            EXPECT_EQ( 0u, frame.overflows() );
+        }
+    }
+    foundation::memory_globals::shutdown();
+}
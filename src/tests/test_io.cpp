@@ -0,0 +1,230 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/io.h"
+#include "base/memorytags.h"
+#include "base/pack.h"
+#include "base/vfs.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace base;
+using base::u8;
+using base::u32;
+using base::u64;
+
+namespace {
+
+struct io_service : public ::testing::Test
+{
+    void SetUp() {
+        memory::init();
+        path = "test_io.bin";
+        content.clear();
+        for ( u32 i = 0; i < 10000; i++ )
+            content.push_back( static_cast<char>( 'a' + i % 26 ) );
+        FILE* f = fopen( path.c_str(), "wb" );
+        fwrite( content.data(), 1, content.size(), f );
+        fclose( f );
+    }
+    void TearDown() {
+        remove( path.c_str() );
+        memory::shutdown();
+    }
+    std::string path;
+    std::string content;
+};
+
+struct Received
+{
+    std::vector<u32> ids;
+    std::vector<io::Status> statuses;
+    std::vector<std::string> data;
+    std::vector<u64> sizes;
+    std::thread::id thread;
+};
+
+void onRead( io::Result& result )
+{
+    Received* r = static_cast<Received*>( result.user );
+    r->ids.push_back( result.id );
+    r->statuses.push_back( result.status );
+    r->sizes.push_back( result.size );
+    r->data.push_back( result.data != nullptr
+        ? std::string( reinterpret_cast<const char*>( result.data ), static_cast<size_t>( result.size ) )
+        : std::string() );
+    r->thread = std::this_thread::get_id();
+}
+
+u8* kept = nullptr;
+
+void onKeep( io::Result& result )
+{
+    kept = result.data;
+    result.data = nullptr;
+}
+
+} // namespace
+
+TEST_F( io_service, batch )
+{
+    io::init( 2 );
+    Received received;
+    std::vector<io::Request> batch;
+    batch.push_back( io::Request( path, onRead, &received ) );
+    io::Request range( path, onRead, &received );
+    range.offset = 26;
+    range.size = 52;
+    batch.push_back( range );
+    batch.push_back( io::Request( "not_existing_file.bin", onRead, &received ) );
+    io::Request stat( path, onRead, &received );
+    stat.operation = io::Operation::Stat;
+    batch.push_back( stat );
+    io::Request outside( path, onRead, &received );
+    outside.offset = 9990;
+    outside.size = 100;
+    batch.push_back( outside );
+
+    u32 first = io::submit( batch.data(), static_cast<u32>( batch.size() ) );
+    EXPECT_EQ( 5u, io::pending() );
+    io::flush();
+    EXPECT_EQ( 0u, io::pending() );
+    io::shutdown();
+
+    ASSERT_EQ( 5u, received.ids.size() );
+    EXPECT_EQ( std::this_thread::get_id(), received.thread );
+    for ( u32 i = 0; i < 5; i++ ) {
+        u32 k = received.ids[i] - first;
+        switch ( k ) {
+        case 0:
+            EXPECT_EQ( io::Status::Ok, received.statuses[i] );
+            EXPECT_EQ( content, received.data[i] );
+            break;
+        case 1:
+            EXPECT_EQ( io::Status::Ok, received.statuses[i] );
+            EXPECT_EQ( content.substr( 26, 52 ), received.data[i] );
+            break;
+        case 2:
+            EXPECT_EQ( io::Status::NotFound, received.statuses[i] );
+            break;
+        case 3:
+            EXPECT_EQ( io::Status::Ok, received.statuses[i] );
+            EXPECT_EQ( content.size(), received.sizes[i] );
+            EXPECT_TRUE( received.data[i].empty() );
+            break;
+        case 4:
+            EXPECT_EQ( io::Status::Failed, received.statuses[i] );
+            break;
+        default:
+            ADD_FAILURE() << "unexpected id " << received.ids[i];
+        }
+    }
+}
+
+TEST_F( io_service, inline_when_not_running )
+{
+    Received received;
+    io::submit( io::Request( path, onRead, &received ) );
+    EXPECT_EQ( 1u, io::pending() );
+    // completion waits for poll even when read is done inline
+    EXPECT_TRUE( received.ids.empty() );
+    EXPECT_EQ( 1u, io::poll() );
+    ASSERT_EQ( 1u, received.data.size() );
+    EXPECT_EQ( content, received.data[0] );
+}
+
+TEST_F( io_service, keep_buffer )
+{
+    io::init( 1 );
+    io::submit( io::Request( path, onKeep ) );
+    io::flush();
+    io::shutdown();
+    ASSERT_TRUE( kept != nullptr );
+    EXPECT_EQ( 0, memcmp( kept, content.data(), content.size() ) );
+    EXPECT_EQ( 1u, memory::stats( MemoryTag::Resources ).count );
+    io::release( kept );
+    EXPECT_EQ( 0u, memory::stats( MemoryTag::Resources ).count );
+}
+
+TEST_F( io_service, shutdown_delivers_or_cancels )
+{
+    io::init( 2 );
+    Received received;
+    for ( u32 i = 0; i < 16; i++ )
+        io::submit( io::Request( path, onRead, &received ) );
+    io::shutdown();
+    EXPECT_EQ( 0u, io::pending() );
+    // every request gets its callback once, finished reads are not polled
+    // yet, so they are cancelled as well
+    ASSERT_EQ( 16u, received.ids.size() );
+    for ( u32 i = 0; i < 16; i++ ) {
+        EXPECT_EQ( io::Status::Cancelled, received.statuses[i] );
+        EXPECT_TRUE( received.data[i].empty() );
+    }
+    EXPECT_EQ( 0u, memory::stats( MemoryTag::Resources ).count );
+}
+
+TEST_F( io_service, packed_through_vfs )
+{
+    // no file on disk under mount point, entry is compressed in pack
+    PackWriter writer;
+    const u8* data = reinterpret_cast<const u8*>( content.data() );
+    writer.add( path, data, content.size(), true );
+    ASSERT_TRUE( writer.write( "test_io.pack" ) );
+    ASSERT_TRUE( vfs::mount( "test_io.pack", "packed" ) );
+
+    io::init( 1 );
+    Received received;
+    io::Request range( "packed/" + path, onRead, &received );
+    range.offset = 26;
+    range.size = 52;
+    io::Request stat( "packed/" + path, onRead, &received );
+    stat.operation = io::Operation::Stat;
+    io::Request missing( "packed/missing.bin", onRead, &received );
+    u32 first = io::submit( io::Request( "packed/" + path, onRead, &received ) );
+    io::submit( range );
+    io::submit( stat );
+    io::submit( missing );
+    io::flush();
+    io::shutdown();
+    vfs::unmountAll();
+    remove( "test_io.pack" );
+
+    ASSERT_EQ( 4u, received.ids.size() );
+    for ( u32 i = 0; i < 4; i++ ) {
+        switch ( received.ids[i] - first ) {
+        case 0:
+            EXPECT_EQ( io::Status::Ok, received.statuses[i] );
+            EXPECT_EQ( content, received.data[i] );
+            break;
+        case 1:
+            EXPECT_EQ( io::Status::Ok, received.statuses[i] );
+            EXPECT_EQ( content.substr( 26, 52 ), received.data[i] );
+            break;
+        case 2:
+            EXPECT_EQ( io::Status::Ok, received.statuses[i] );
+            EXPECT_EQ( content.size(), received.sizes[i] );
+            break;
+        default:
+            EXPECT_EQ( io::Status::NotFound, received.statuses[i] );
+        }
+    }
+    EXPECT_EQ( 0u, memory::stats( MemoryTag::Resources ).count );
+}
+
+TEST_F( io_service, read_file )
+{
+    u8* data = nullptr;
+    u64 size = 0;
+    ASSERT_EQ( io::Status::Ok, io::readFile( path, &data, &size ) );
+    EXPECT_EQ( content.size(), size );
+    EXPECT_EQ( 0, memcmp( data, content.data(), content.size() ) );
+    io::release( data );
+    EXPECT_EQ( io::Status::NotFound, io::readFile( "not_existing_file.bin", &data, &size ) );
+}
@@ -0,0 +1,131 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/jobs.h"
+#include "foundation/memory.h"
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace base;
+using base::u32;
+
+namespace {
+
+struct jobs_system : public ::testing::Test
+{
+    void SetUp() {
+        foundation::memory_globals::init();
+        jobs::init( 4 );
+    }
+    void TearDown() {
+        jobs::shutdown();
+        foundation::memory_globals::shutdown();
+    }
+};
+
+std::atomic<u32> executed( 0 );
+
+void countJob( void* )
+{
+    executed.fetch_add( 1 );
+}
+
+const u32 kManyJobs = 20000;
+std::atomic<u32> runs[kManyJobs];
+
+//! Data is id of the job
+void markJob( void* data )
+{
+    runs[reinterpret_cast<uintptr_t>( data )].fetch_add( 1 );
+}
+
+//! Queues more jobs from a worker and waits for them
+void spawnJob( void* )
+{
+    jobs::Counter children;
+    jobs::Job job = { &countJob, nullptr };
+    for ( int i = 0; i < 10; i++ )
+        jobs::run( job, &children );
+    jobs::wait( &children );
+}
+
+}
+
+TEST_F( jobs_system, counter )
+{
+    executed = 0;
+    jobs::Counter counter;
+    jobs::Job job = { &countJob, nullptr };
+    for ( int i = 0; i < 1000; i++ )
+        jobs::run( job, &counter );
+    jobs::wait( &counter );
+    EXPECT_EQ( 1000u, executed.load() );
+    EXPECT_EQ( 0u, counter.value.load() );
+}
+
+TEST_F( jobs_system, more_than_capacity )
+{
+    // more jobs than ring of slots holds, each must run exactly once
+    for ( u32 i = 0; i < kManyJobs; i++ )
+        runs[i] = 0;
+    jobs::Counter counter;
+    for ( u32 i = 0; i < kManyJobs; i++ ) {
+        jobs::Job job = { &markJob, reinterpret_cast<void*>( static_cast<uintptr_t>( i ) ) };
+        jobs::run( job, &counter );
+    }
+    jobs::wait( &counter );
+    EXPECT_EQ( 0u, counter.value.load() );
+    u32 lost = 0, repeated = 0;
+    for ( u32 i = 0; i < kManyJobs; i++ ) {
+        lost += runs[i] == 0;
+        repeated += runs[i] > 1;
+    }
+    EXPECT_EQ( 0u, lost );
+    EXPECT_EQ( 0u, repeated );
+}
+
+TEST_F( jobs_system, nested )
+{
+    executed = 0;
+    jobs::Counter counter;
+    jobs::Job job = { &spawnJob, nullptr };
+    for ( int i = 0; i < 100; i++ )
+        jobs::run( job, &counter );
+    jobs::wait( &counter );
+    EXPECT_EQ( 1000u, executed.load() );
+}
+
+TEST_F( jobs_system, parallel_for )
+{
+    EXPECT_EQ( 4u, jobs::workerCount() );
+    foundation::Array<u32> values( foundation::memory_globals::default_allocator() );
+    for ( u32 i = 0; i < 100000; i++ )
+        foundation::array::push_back( values, i );
+
+    std::mutex lock;
+    std::set<u32> workers;
+    jobs::parallel_for( values, 256, [&]( u32* begin, u32* end ) {
+        for ( u32* it = begin; it != end; ++it )
+            *it *= 2;
+        std::lock_guard<std::mutex> guard( lock );
+        workers.insert( jobs::workerIndex() );
+    } );
+    for ( u32 i = 0; i < 100000; i++ )
+        ASSERT_EQ( i * 2, values[i] );
+    EXPECT_GE( workers.size(), 1u );
+}
+
+TEST( jobs, inline_without_workers )
+{
+    executed = 0;
+    jobs::Counter counter;
+    jobs::Job job = { &countJob, nullptr };
+    jobs::run( job, &counter );
+    jobs::wait( &counter );
+    EXPECT_EQ( 1u, executed.load() );
+}
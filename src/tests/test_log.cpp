@@ -0,0 +1,124 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/log.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using base::Log;
+
+namespace {
+
+class CaptureLog : public Log
+{
+public:
+    CaptureLog(std::vector<std::string>* lines) : lines_(lines) {}
+    void write(Level, const char* message) {
+        std::lock_guard<std::mutex> guard(lock_);
+        lines_->push_back(message);
+    }
+private:
+    std::mutex lock_;
+    std::vector<std::string>* lines_;
+};
+
+template<typename... Args>
+std::string formatDeferred(const char* fmt, const Args&... args)
+{
+    base::LogRecord record;
+    record.fmt = fmt;
+    record.count = 0;
+    record.textUsed = 0;
+    record.text[base::LogRecord::TextSize - 1] = '\0';
+    base::logArgs(&record, args...);
+    char buffer[256];
+    base::formatLogRecord(record, buffer, sizeof(buffer));
+    return buffer;
+}
+
+}
+
+TEST( log, format )
+{
+    const unsigned char version[] = "3.2";
+    std::string str = "abc";
+    EXPECT_EQ( "a 5 -3 ok", formatDeferred( "a %d %i %s", 5u, -3, "ok" ) );
+    EXPECT_EQ( "0X1F  1.50 x", formatDeferred( "%#X %5.2f %c", 31, 1.5f, 'x' ) );
+    EXPECT_EQ( "[  abc] 100%", formatDeferred( "[%*s] %lu%%", 5, str.c_str(), 100ul ) );
+    EXPECT_EQ( "GL 3.2", formatDeferred( "GL %s", version ) );
+    EXPECT_EQ( "missing (?)", formatDeferred( "missing %s" ) );
+}
+
+TEST( log, async )
+{
+    std::vector<std::string> lines;
+    CaptureLog* capture = new CaptureLog( &lines );
+    base::openLog( capture );
+    base::setLogLevel( Log::LEVEL_WARNING );
+    base::startAsyncLog();
+
+    auto work = []( int id ) {
+        for ( int i = 0; i < 200; i++ ) {
+            LOG( "skipped %d", i );
+            WARN( "thread %d message %d", id, i );
+        }
+    };
+    std::thread t1( work, 1 ), t2( work, 2 );
+    t1.join();
+    t2.join();
+    base::flushLog();
+
+    ASSERT_EQ( 400u, lines.size() );
+    int next[3] = { 0, 0, 0 };
+    for ( const std::string& line : lines ) {
+        int id = -1, i = -1;
+        ASSERT_EQ( 2, sscanf( line.c_str(), "thread %d message %d", &id, &i ) );
+        EXPECT_EQ( next[id]++, i );
+    }
+
+    base::stopAsyncLog();
+    base::setLogLevel( Log::LEVEL_INFO );
+    base::closeLog( capture );
+}
+
+TEST( log, stop_while_logging )
+{
+    std::vector<std::string> lines;
+    CaptureLog* capture = new CaptureLog( &lines );
+    base::openLog( capture );
+    base::setLogLevel( Log::LEVEL_WARNING );
+
+    // threads keep writing to rings while log thread is stopped and restarted
+    std::atomic<int> running( 2 );
+    auto work = [&running]( int id ) {
+        for ( int i = 0; i < 5000; i++ )
+            WARN( "thread %d message %d", id, i );
+        running--;
+    };
+    base::startAsyncLog();
+    std::thread t1( work, 1 ), t2( work, 2 );
+    while ( running > 0 ) {
+        base::stopAsyncLog();
+        base::startAsyncLog();
+    }
+    t1.join();
+    t2.join();
+    base::stopAsyncLog();
+
+    ASSERT_EQ( 10000u, lines.size() );
+    int next[3] = { 0, 0, 0 };
+    for ( const std::string& line : lines ) {
+        int id = -1, i = -1;
+        ASSERT_EQ( 2, sscanf( line.c_str(), "thread %d message %d", &id, &i ) );
+        EXPECT_EQ( next[id]++, i );
+    }
+
+    base::setLogLevel( Log::LEVEL_INFO );
+    base::closeLog( capture );
+}
@@ -97,3 +97,83 @@ TEST(math, matrix4_assign)
 }
 
 */
+
+namespace {
+
+const Matrix4 kAffine( vec4f( 0.8f, 0.1f, -0.5f, 0.0f ),
+                       vec4f( -0.2f, 1.5f, 0.3f, 0.0f ),
+                       vec4f( 0.4f, -0.6f, 2.0f, 0.0f ),
+                       vec4f( 3.0f, -2.0f, 7.0f, 1.0f ) );
+
+const Matrix4 kGeneral( vec4f( 2.0f, 1.0f, 0.5f, 0.25f ),
+                        vec4f( -1.0f, 3.0f, 1.0f, 0.5f ),
+                        vec4f( 0.5f, -2.0f, 4.0f, 1.0f ),
+                        vec4f( 1.0f, 0.0f, -1.0f, 2.0f ) );
+
+void expectNear( const Matrix4& a, const Matrix4& b, base::f32 tolerance = 1e-5f )
+{
+    for ( base::u32 i = 0; i < 4; i++ )
+        for ( base::u32 j = 0; j < 4; j++ )
+            EXPECT_NEAR( a.Elem( i, j ), b.Elem( i, j ), tolerance ) << "column " << i << " row " << j;
+}
+
+//! Reference product by definition
+Matrix4 multiply( const Matrix4& a, const Matrix4& b )
+{
+    Matrix4 r = Matrix4::Identity();
+    for ( base::u32 i = 0; i < 4; i++ )
+        for ( base::u32 j = 0; j < 4; j++ ) {
+            base::f32 sum = 0.0f;
+            for ( base::u32 k = 0; k < 4; k++ )
+                sum += a.Elem( k, j ) * b.Elem( i, k );
+            r.SetElem( i, j, sum );
+        }
+    return r;
+}
+
+} // namespace
+
+TEST( math, matrix4_multiply )
+{
+    expectNear( multiply( kAffine, kGeneral ), kAffine * kGeneral );
+    expectNear( multiply( kGeneral, kAffine ), kGeneral * kAffine );
+    Matrix4 m = kGeneral;
+    m *= kAffine;
+    expectNear( multiply( kGeneral, kAffine ), m );
+}
+
+TEST( math, matrix4_transform )
+{
+    vec4f v( 1.0f, -2.0f, 3.0f, 1.0f );
+    vec4f r = kGeneral * v;
+    for ( int j = 0; j < 4; j++ )
+        EXPECT_NEAR( dot( kGeneral.Row( j ), v ), r[j], 1e-5f );
+    vec4f d = kAffine * base::math::vec3f( 1.0f, -2.0f, 3.0f );
+    vec4f e = kAffine * vec4f( 1.0f, -2.0f, 3.0f, 0.0f );
+    EXPECT_TRUE( d == e );
+}
+
+TEST( math, matrix4_transpose_and_ops )
+{
+    Matrix4 t = Transpose( kGeneral );
+    for ( base::u32 i = 0; i < 4; i++ )
+        for ( base::u32 j = 0; j < 4; j++ )
+            EXPECT_EQ( kGeneral.Elem( i, j ), t.Elem( j, i ) );
+    EXPECT_TRUE( Transpose( t ) == kGeneral );
+    expectNear( kGeneral * 2.0f, kGeneral + kGeneral );
+    expectNear( kGeneral - kGeneral, kGeneral * 0.0f );
+}
+
+TEST( math, matrix4_inverse )
+{
+    expectNear( Matrix4::Identity(), Inverse( kGeneral ) * kGeneral );
+    expectNear( Matrix4::Identity(), kGeneral * Inverse( kGeneral ) );
+    expectNear( Inverse( kAffine ), AffineInverse( kAffine ) );
+    expectNear( Matrix4::Identity(), AffineInverse( kAffine ) * kAffine );
+    EXPECT_NEAR( 1.0f / Determinant( kGeneral ), Determinant( Inverse( kGeneral ) ), 1e-5f );
+
+    Matrix4 rigid = Matrix4::Translation( base::math::vec3f( 1.0f, 2.0f, 3.0f ) )
+                    * Matrix4::RotationY( 0.7f ) * Matrix4::RotationX( -0.3f );
+    expectNear( Inverse( rigid ), OrthoInverse( rigid ) );
+    expectNear( Matrix4::Identity(), OrthoInverse( rigid ) * rigid );
+}
@@ -0,0 +1,82 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/memorytags.h"
+#include "foundation/array.h"
+#include <sstream>
+#include <vector>
+
+using namespace base;
+
+TEST( memorytags, counters )
+{
+    memory::init();
+    {
+        foundation::Allocator& scene = memory::allocator( MemoryTag::Scene );
+        void* a = scene.allocate( 100 );
+        void* b = scene.allocate( 200 );
+        MemoryStats s = memory::stats( MemoryTag::Scene );
+        EXPECT_EQ( 2u, s.count );
+        EXPECT_GE( s.live, 300u );
+        EXPECT_EQ( 0u, s.frameAllocations );
+        u64 live = s.live;
+
+        scene.deallocate( b );
+        memory::endFrame();
+        s = memory::stats( MemoryTag::Scene );
+        EXPECT_EQ( 1u, s.count );
+        EXPECT_LT( s.live, live );
+        EXPECT_EQ( live, s.peak );
+        EXPECT_EQ( 2u, s.frameAllocations );
+        EXPECT_EQ( 0u, memory::stats( MemoryTag::Physics ).count );
+
+        memory::endFrame();
+        EXPECT_EQ( 0u, memory::stats( MemoryTag::Scene ).frameAllocations );
+        scene.deallocate( a );
+        EXPECT_EQ( 0u, memory::stats( MemoryTag::Scene ).live );
+    }
+    memory::shutdown();
+}
+
+TEST( memorytags, physics_outlives_shutdown )
+{
+    // Bullet and Python may free their objects after the engine shut memory down
+    const MemoryTag tags[] = { MemoryTag::Physics, MemoryTag::Scripting };
+    for ( MemoryTag tag : tags ) {
+        memory::init();
+        foundation::Allocator* allocator = &memory::allocator( tag );
+        void* p = allocator->allocate( 64, 16 );
+        memory::shutdown();
+        allocator->deallocate( p );
+        p = allocator->allocate( 32, 16 );
+
+        memory::init();
+        EXPECT_EQ( allocator, &memory::allocator( tag ) ) << memory::tagName( tag );
+        EXPECT_EQ( 1u, memory::stats( tag ).count );
+        allocator->deallocate( p );
+        EXPECT_EQ( 0u, memory::stats( tag ).count );
+        memory::shutdown();
+    }
+}
+
+TEST( memorytags, containers )
+{
+    memory::init();
+    {
+        foundation::Array<u32> values( memory::allocator( MemoryTag::Resources ) );
+        foundation::array::resize( values, 1000 );
+        EXPECT_GE( memory::stats( MemoryTag::Resources ).live, 4000u );
+
+        std::vector<u8, TagAllocator<u8, MemoryTag::Render>> buffer( 5000 );
+        EXPECT_GE( memory::stats( MemoryTag::Render ).live, 5000u );
+
+        std::stringstream out;
+        memory::report( &out );
+        EXPECT_NE( std::string::npos, out.str().find( "render," ) );
+    }
+    EXPECT_EQ( 0u, memory::stats( MemoryTag::Render ).live );
+    memory::shutdown();
+}
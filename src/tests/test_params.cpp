@@ -0,0 +1,106 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/parameter.h"
+#include <string>
+
+using base::Params;
+using base::ParamType;
+using base::StringId;
+using base::Variant;
+using base::f32;
+using base::i32;
+using base::u32;
+
+TEST( params, set_find )
+{
+    Params p;
+    p.set( StringId( "color" ), Variant( base::math::vec4f( 1, 2, 3, 4 ) ) );
+    p.set( StringId( "alpha" ), Variant( 0.5f ) );
+    p.set( StringId( "count" ), Variant( 3 ) );
+    ASSERT_EQ( 3u, p.size() );
+    for ( u32 i = 1; i < p.size(); i++ )
+        EXPECT_TRUE( p.key( i - 1 ) < p.key( i ) );
+
+    i32 alpha = p.find( StringId( "alpha" ) );
+    ASSERT_GE( alpha, 0 );
+    EXPECT_EQ( ParamType::Float, p.type( alpha ) );
+    EXPECT_EQ( 0.5f, p.value( alpha ).asFloat() );
+    EXPECT_EQ( -1, p.find( StringId( "missing" ) ) );
+    EXPECT_TRUE( p.get( StringId( "missing" ) ).isNone() );
+
+    p.set( StringId( "alpha" ), Variant( base::math::vec4f( 5, 6, 7, 8 ) ) );
+    EXPECT_EQ( 3u, p.size() );
+    EXPECT_EQ( 7.0f, p.get( StringId( "alpha" ) ).asVec4().z );
+    EXPECT_EQ( 2.0f, p.get( StringId( "color" ) ).asVec4().y );
+    EXPECT_EQ( 3, p.get( StringId( "count" ) ).asInt() );
+}
+
+TEST( params, retype_keeps_size )
+{
+    Params p;
+    p.set( StringId( "color" ), Variant( base::math::vec4f( 1, 2, 3, 4 ) ) );
+    p.set( StringId( "value" ), Variant( 0.5f ) );
+    p.set( StringId( "count" ), Variant( 3 ) );
+    const u32 packed = p.packedSize();
+    for ( u32 i = 0; i < 100; i++ ) {
+        p.set( StringId( "value" ), Variant( base::math::Matrix4::Identity() ) );
+        p.set( StringId( "value" ), Variant( 0.25f ) );
+    }
+    EXPECT_EQ( packed, p.packedSize() );
+    EXPECT_EQ( 0.25f, p.get( StringId( "value" ) ).asFloat() );
+    EXPECT_EQ( 2.0f, p.get( StringId( "color" ) ).asVec4().y );
+    EXPECT_EQ( 3, p.get( StringId( "count" ) ).asInt() );
+}
+
+TEST( params, string )
+{
+    Params p;
+    p.set( StringId( "diffuse" ), Variant( "textures/stone.png" ) );
+    EXPECT_EQ( ParamType::String, p.type( 0 ) );
+    EXPECT_EQ( sizeof( base::u64 ), Params::typeSize( p.type( 0 ) ) );
+    EXPECT_STREQ( "textures/stone.png", p.value( 0 ).asString() );
+}
+
+TEST( params, merge )
+{
+    Params material, mesh;
+    material.set( StringId( "a" ), Variant( 1.0f ) );
+    material.set( StringId( "b" ), Variant( 2.0f ) );
+    material.set( StringId( "c" ), Variant( 3.0f ) );
+    mesh.set( StringId( "b" ), Variant( 20.0f ) );
+    mesh.set( StringId( "d" ), Variant( 40.0f ) );
+
+    Params merged = material;
+    merged.merge( mesh );
+    ASSERT_EQ( 4u, merged.size() );
+    for ( u32 i = 1; i < merged.size(); i++ )
+        EXPECT_TRUE( merged.key( i - 1 ) < merged.key( i ) );
+    EXPECT_EQ( 1.0f, merged.get( StringId( "a" ) ).asFloat() );
+    EXPECT_EQ( 20.0f, merged.get( StringId( "b" ) ).asFloat() );
+    EXPECT_EQ( 3.0f, merged.get( StringId( "c" ) ).asFloat() );
+    EXPECT_EQ( 40.0f, merged.get( StringId( "d" ) ).asFloat() );
+
+    Params same;
+    same.set( StringId( "d" ), Variant( 40.0f ) );
+    same.set( StringId( "b" ), Variant( 20.0f ) );
+    EXPECT_TRUE( same == mesh );
+    same.set( StringId( "b" ), Variant( 21.0f ) );
+    EXPECT_TRUE( same != mesh );
+}
+
+TEST( params, variant_string_interned )
+{
+    std::string name( "textures/stone.png" );
+    Variant a( name.c_str() );
+    Variant b( "textures/stone.png" );
+    EXPECT_EQ( a.asString(), b.asString() );
+    EXPECT_TRUE( a == b );
+    EXPECT_TRUE( a.asStringId() == StringId( "textures/stone.png" ) );
+
+    Variant c( std::move( a ) );
+    EXPECT_STREQ( "textures/stone.png", c.asString() );
+}
@@ -0,0 +1,116 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/profiler.h"
+#include <sstream>
+#include <thread>
+
+using base::Profiler;
+using base::ProfilerSample;
+using base::u32;
+
+TEST( profiler, intern )
+{
+    u32 a = Profiler::intern( "physics" );
+    u32 b = Profiler::intern( "render" );
+    EXPECT_NE( a, b );
+    EXPECT_EQ( a, Profiler::intern( "physics" ) );
+    EXPECT_EQ( "render", Profiler::name( b ) );
+}
+
+TEST( profiler, nesting )
+{
+    Profiler::init();
+    {
+        PROFILER_SCOPE( "frame" );
+        {
+            PROFILER_SCOPE( "physics" );
+        }
+        {
+            PROFILER_SCOPE( "render" );
+            PROFILER_SCOPE( "draw" );
+        }
+    }
+    Profiler::endFrame();
+
+    const std::vector<ProfilerSample>& frame = Profiler::frame();
+    ASSERT_EQ( 4u, frame.size() );
+    EXPECT_EQ( "frame", Profiler::name( frame[0].id ) );
+    EXPECT_EQ( -1, frame[0].parent );
+    EXPECT_EQ( 0, frame[1].parent );
+    EXPECT_EQ( 1u, frame[1].depth );
+    EXPECT_EQ( 0, frame[2].parent );
+    EXPECT_EQ( 2, frame[3].parent );
+    EXPECT_EQ( 2u, frame[3].depth );
+    EXPECT_GE( frame[0].duration, frame[2].duration );
+
+    Profiler::endFrame();
+    EXPECT_TRUE( Profiler::frame().empty() );
+    Profiler::shutdown();
+}
+
+TEST( profiler, scope_over_frames )
+{
+    Profiler::init();
+    u32 id = Profiler::intern( "loading" );
+    Profiler::begin( id );
+    Profiler::endFrame();
+    ASSERT_EQ( 1u, Profiler::frame().size() );
+    ProfilerSample first = Profiler::frame()[0];
+
+    // continued sample starts at frame marker, after the end of the first part
+    Profiler::endFrame();
+    ASSERT_EQ( 1u, Profiler::frame().size() );
+    ProfilerSample second = Profiler::frame()[0];
+    EXPECT_EQ( id, second.id );
+    EXPECT_GE( second.start, first.start + first.duration );
+
+    Profiler::end( id );
+    Profiler::endFrame();
+    ASSERT_EQ( 1u, Profiler::frame().size() );
+    EXPECT_GE( Profiler::frame()[0].start, second.start + second.duration );
+    Profiler::shutdown();
+}
+
+TEST( profiler, threads )
+{
+    Profiler::init();
+    auto work = []() {
+        for ( int i = 0; i < 100; i++ ) {
+            PROFILER_SCOPE( "job" );
+        }
+    };
+    std::thread t1( work ), t2( work );
+    t1.join();
+    t2.join();
+    Profiler::endFrame();
+
+    const std::vector<ProfilerSample>& frame = Profiler::frame();
+    ASSERT_EQ( 200u, frame.size() );
+    EXPECT_NE( frame.front().thread, frame.back().thread );
+    EXPECT_EQ( 0u, Profiler::dropped() );
+    Profiler::shutdown();
+}
+
+TEST( profiler, report )
+{
+    Profiler::init();
+    {
+        PROFILER_SCOPE( "b" );
+        PROFILER_SCOPE( "a" );
+    }
+    Profiler::endFrame();
+
+    std::stringstream header;
+    Profiler::reportHeader( &header );
+    EXPECT_EQ( "a,b\n", header.str() );
+
+    std::stringstream trace;
+    Profiler::writeChromeTrace( &trace );
+    EXPECT_NE( std::string::npos, trace.str().find( "\"name\":\"a\"" ) );
+    EXPECT_NE( std::string::npos, trace.str().find( "\"ph\":\"X\"" ) );
+    Profiler::shutdown();
+}
@@ -5,6 +5,7 @@
  **/
 #include "gtest/gtest.h"
 #include "math/quat.h"
+#include "math/matrix-inl.h"
 #include "math/vec3.h"
 
 using base::math::vec3f;
@@ -70,3 +71,26 @@ TEST( quat, rotate_vector )
     vec3f expected = temp.getXYZ();
     EXPECT_EQ( expected, c );
 }
+
+TEST( quat, matrix )
+{
+    Quat q = Quat::GetRotation( vec3f( 1.f, 2.f, 3.f ), 0.8f );
+    const vec3f v( 2.f, -3.f, 4.f );
+    vec3f expected = q.RotatePoint( v );
+    vec3f r = ( q.GetMatrix() * v ).xyz();
+    EXPECT_NEAR( expected.x, r.x, 1e-5f );
+    EXPECT_NEAR( expected.y, r.y, 1e-5f );
+    EXPECT_NEAR( expected.z, r.z, 1e-5f );
+}
+
+TEST( quat, rotation_composition )
+{
+    Quat a = Quat::GetRotationX( 0.5f );
+    Quat b = Quat::GetRotationY( -1.2f );
+    const vec3f v( 1.f, 2.f, 3.f );
+    vec3f composed = ( a * b ).RotatePoint( v );
+    vec3f sequence = a.RotatePoint( b.RotatePoint( v ) );
+    EXPECT_NEAR( sequence.x, composed.x, 1e-5f );
+    EXPECT_NEAR( sequence.y, composed.y, 1e-5f );
+    EXPECT_NEAR( sequence.z, composed.z, 1e-5f );
+}
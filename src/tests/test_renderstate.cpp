@@ -0,0 +1,139 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "render/renderstate.h"
+#include "render/gpuprogram.h"
+#include "render/mesh.h"
+#include "render/meshbuffers.h"
+#include "tests/glstub.h"
+
+using namespace base;
+using namespace base::opengl;
+
+namespace {
+
+//! Mesh with position and normal, programs reading both or only position
+struct render_state : public glstub::Test
+{
+    void SetUp() {
+        glstub::Test::SetUp();
+        programs[0] = glstub::makeProgram( GL, { { "position", VertexAttrs::tagPosition, 0 }, { "normal", VertexAttrs::tagNormal, 0 } } );
+        programs[1] = glstub::makeProgram( GL, { { "position", VertexAttrs::tagPosition, 0 } } );
+        mesh = new Mesh;
+        mesh->addAttribute( VertexAttrs::tagPosition ).addAttribute( VertexAttrs::tagNormal );
+        mesh->vertexCount( 4 ).indexCount( 6, IndexTypes::UInt16 );
+        mesh->complete();
+    }
+    void TearDown() {
+        delete mesh;
+        delete programs[0];
+        delete programs[1];
+        glstub::Test::TearDown();
+    }
+
+    void draw( u32 program, const Mesh& m, u32 from = 0, u32 count = 6 ) {
+        GL.setProgram( programs[program] );
+        GL.renderState().render( m, from, count );
+    }
+
+    GpuProgram* programs[2];
+    Mesh* mesh;
+};
+
+} // namespace
+
+TEST_F( render_state, mesh_uploaded_once )
+{
+    const glstub::Calls& calls = glstub::calls();
+    for ( u32 i = 0; i < 10; i++ )
+        draw( 0, *mesh );
+    EXPECT_EQ( 10u, calls.draws );
+    EXPECT_EQ( 2u, calls.genBuffers );
+    EXPECT_EQ( 2u, calls.bufferData );
+    // attributes are set up once, draws only bind
+    EXPECT_EQ( 1u, calls.genVertexArrays );
+    EXPECT_EQ( 1u, calls.bindVertexArray );
+    EXPECT_EQ( 2u, calls.enableAttrib );
+    EXPECT_EQ( 2u, calls.attribPointer );
+    EXPECT_EQ( 0u, calls.disableAttrib );
+
+    // copy shares uploaded data
+    Mesh copy = *mesh;
+    draw( 0, copy );
+    EXPECT_EQ( 2u, calls.bufferData );
+    EXPECT_EQ( 1u, calls.genVertexArrays );
+}
+
+TEST_F( render_state, vertex_array_per_program )
+{
+    const glstub::Calls& calls = glstub::calls();
+    draw( 0, *mesh );
+    draw( 1, *mesh );
+    EXPECT_EQ( 2u, calls.genVertexArrays );
+    // second program does not read normals
+    EXPECT_EQ( 3u, calls.attribPointer );
+    draw( 0, *mesh );
+    draw( 1, *mesh );
+    EXPECT_EQ( 2u, calls.genVertexArrays );
+    EXPECT_EQ( 4u, calls.bindVertexArray );
+    EXPECT_EQ( 2u, calls.bufferData );
+
+    delete mesh;
+    mesh = nullptr;
+    EXPECT_EQ( 2u, calls.deleteVertexArrays );
+}
+
+TEST_F( render_state, index_offset )
+{
+    draw( 0, *mesh, 3, 3 );
+    ASSERT_EQ( 1u, glstub::calls().drawOffsets.size() );
+    EXPECT_EQ( 3 * sizeof( u16 ), glstub::calls().drawOffsets[0] );
+}
+
+TEST_F( render_state, index_buffer_follows_vertex_array )
+{
+    Mesh* second = new Mesh;
+    second->addAttribute( VertexAttrs::tagPosition ).vertexCount( 4 ).indexCount( 6, IndexTypes::UInt16 );
+    second->complete();
+    // uploads bind index buffer outside of vertex arrays, cache must not skip binds into new ones
+    for ( u32 program = 0; program < 2; program++ ) {
+        draw( program, *mesh );
+        draw( program, *second );
+    }
+    std::map<u32, u32>& bound = glstub::calls().elementBuffers;
+    u32 first = bound[mesh->upload( GL ).vertexArray( *programs[0] )];
+    u32 other = bound[second->upload( GL ).vertexArray( *programs[0] )];
+    EXPECT_NE( 0u, first );
+    EXPECT_NE( 0u, other );
+    EXPECT_NE( first, other );
+    EXPECT_EQ( first, bound[mesh->upload( GL ).vertexArray( *programs[1] )] );
+    EXPECT_EQ( other, bound[second->upload( GL ).vertexArray( *programs[1] )] );
+    delete second;
+}
+
+TEST_F( render_state, vertex_arrays_freed_with_program )
+{
+    const glstub::Calls& calls = glstub::calls();
+    draw( 0, *mesh );
+    draw( 1, *mesh );
+    EXPECT_EQ( 2u, calls.genVertexArrays );
+
+    delete programs[1];
+    programs[1] = nullptr;
+    EXPECT_EQ( 1u, calls.deleteVertexArrays );
+    draw( 0, *mesh );
+    EXPECT_EQ( 2u, calls.genVertexArrays );
+
+    // new program gets its own vertex array even at address of deleted one
+    programs[1] = glstub::makeProgram( GL, { { "position", VertexAttrs::tagPosition, 0 } } );
+    draw( 1, *mesh );
+    EXPECT_EQ( 3u, calls.genVertexArrays );
+    EXPECT_EQ( 4u, calls.draws );
+
+    delete mesh;
+    mesh = nullptr;
+    EXPECT_EQ( 3u, calls.deleteVertexArrays );
+}
@@ -0,0 +1,115 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "game/signal.h"
+#include "game/components/transform.h"
+#include "math/matrix-inl.h"
+#include <vector>
+
+using namespace base;
+using namespace base::game;
+
+namespace {
+
+struct Listener
+{
+    std::vector<int>* log;
+    int id;
+    void notify() { log->push_back( id ); }
+};
+
+void increment( void* p )
+{
+    ++*static_cast<int*>( p );
+}
+
+} // namespace
+
+TEST( signal, connect_emit )
+{
+    Signal signal;
+    int counter = 0;
+    Connection a = signal.connect( increment, &counter );
+    Connection b = signal.connect( increment, &counter );
+    EXPECT_NE( 0u, a );
+    EXPECT_NE( a, b );
+    EXPECT_EQ( 2u, signal.size() );
+    signal.emit();
+    EXPECT_EQ( 2, counter );
+
+    EXPECT_TRUE( signal.disconnect( a ) );
+    EXPECT_FALSE( signal.disconnect( a ) );
+    EXPECT_FALSE( signal.connected( a ) );
+    EXPECT_TRUE( signal.connected( b ) );
+    signal.emit();
+    EXPECT_EQ( 3, counter );
+    EXPECT_FALSE( signal.disconnect( 0 ) );
+}
+
+TEST( signal, stale_handle )
+{
+    Signal signal;
+    int counter = 0;
+    Connection a = signal.connect( increment, &counter );
+    signal.disconnect( a );
+    // slot of handle is reused with new generation
+    Connection b = signal.connect( increment, &counter );
+    EXPECT_NE( a, b );
+    EXPECT_FALSE( signal.disconnect( a ) );
+    EXPECT_TRUE( signal.connected( b ) );
+    signal.emit();
+    EXPECT_EQ( 1, counter );
+}
+
+TEST( signal, member_slots )
+{
+    Signal signal;
+    std::vector<int> log;
+    Listener listeners[4];
+    Connection connections[4];
+    for ( int i = 0; i < 4; i++ ) {
+        listeners[i].log = &log;
+        listeners[i].id = i;
+        connections[i] = signal.connect<Listener, &Listener::notify>( &listeners[i] );
+    }
+    // removing from the middle moves the last slot into the hole
+    signal.disconnect( connections[1] );
+    signal.emit();
+    ASSERT_EQ( 3u, log.size() );
+    EXPECT_EQ( 0, log[0] );
+    EXPECT_EQ( 3, log[1] );
+    EXPECT_EQ( 2, log[2] );
+
+    log.clear();
+    signal.disconnect( connections[3] );
+    signal.disconnect( connections[0] );
+    signal.emit();
+    ASSERT_EQ( 1u, log.size() );
+    EXPECT_EQ( 2, log[0] );
+}
+
+TEST( signal, transform_hierarchy )
+{
+    Transform root, child, grandchild;
+    child.setParent( &root );
+    grandchild.setParent( &child );
+    EXPECT_EQ( 1u, root.signal_.size() );
+    EXPECT_EQ( 1u, child.signal_.size() );
+
+    root.setPosition( math::vec3f( 1, 2, 3 ) );
+    child.setPosition( math::vec3f( 0, 1, 0 ) );
+    root.update();
+    EXPECT_FLOAT_EQ( 1.0f, grandchild.world().Elem( 3, 0 ) );
+    EXPECT_FLOAT_EQ( 3.0f, grandchild.world().Elem( 3, 1 ) );
+    EXPECT_FLOAT_EQ( 3.0f, grandchild.world().Elem( 3, 2 ) );
+
+    // reparenting disconnects from old parent
+    grandchild.setParent( &root );
+    EXPECT_EQ( 2u, root.signal_.size() );
+    EXPECT_EQ( 0u, child.signal_.size() );
+    grandchild.setParent( nullptr );
+    EXPECT_EQ( 1u, root.signal_.size() );
+}
@@ -0,0 +1,95 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/stream.h"
+#include <stdio.h>
+
+using base::MappedFile;
+using base::FileBinary;
+using base::u8;
+using base::u32;
+using base::u64;
+
+namespace {
+
+const char* kFileName = "test_stream.bin";
+
+void writeTestFile( u32 count )
+{
+    FILE* f = fopen( kFileName, "wb" );
+    for ( u32 i = 0; i < count; i++ )
+        fwrite( &i, sizeof( i ), 1, f );
+    fclose( f );
+}
+
+}
+
+TEST( stream, mapped_file )
+{
+    writeTestFile( 1024 );
+    {
+        MappedFile file( kFileName );
+        ASSERT_TRUE( file.isOpen() );
+        EXPECT_EQ( 4096u, file.size() );
+
+        const u32* values = reinterpret_cast<const u32*>( file.view( 0, file.size() ) );
+        ASSERT_TRUE( values != nullptr );
+        EXPECT_EQ( 1023u, values[1023] );
+        EXPECT_TRUE( file.view( 4000, 100 ) == nullptr );
+        EXPECT_TRUE( file.view( 4096, 0 ) != nullptr );
+
+        file.setPosition( 8 );
+        EXPECT_EQ( 2u, file.readType<u32>() );
+        const u8* ptr = file.readView( 4 );
+        EXPECT_EQ( file.data() + 12, ptr );
+        EXPECT_EQ( 16u, file.position() );
+
+        file.advise( MappedFile::Access::Random, 100, 200 );
+        EXPECT_EQ( 500u, values[500] );
+    }
+    remove( kFileName );
+}
+
+TEST( stream, mapped_file_missing )
+{
+    MappedFile file( "no_such_file.bin" );
+    EXPECT_FALSE( file.isOpen() );
+    EXPECT_TRUE( file.data() == nullptr );
+    EXPECT_EQ( 0u, file.size() );
+}
+
+TEST( stream, file_binary )
+{
+    writeTestFile( 16 );
+    {
+        FileBinary file( kFileName );
+        EXPECT_EQ( 64u, file.size() );
+        EXPECT_EQ( 0u, file.readType<u32>() );
+        EXPECT_EQ( 1u, file.readType<u32>() );
+        file.setPosition( 60 );
+        EXPECT_EQ( 15u, file.readType<u32>() );
+    }
+    remove( kFileName );
+}
+
+TEST( stream, file_binary_read_write )
+{
+    writeTestFile( 16 );
+    {
+        // read and write alternate at adjacent positions, cached position matches
+        FileBinary file( kFileName );
+        EXPECT_EQ( 0u, file.readType<u32>() );
+        file.write( u32( 100 ) );
+        EXPECT_EQ( 2u, file.readType<u32>() );
+        file.write( u32( 300 ) );
+        file.setPosition( 4 );
+        EXPECT_EQ( 100u, file.readType<u32>() );
+        EXPECT_EQ( 2u, file.readType<u32>() );
+        EXPECT_EQ( 300u, file.readType<u32>() );
+        EXPECT_EQ( 4u, file.readType<u32>() );
+    }
+    remove( kFileName );
+}
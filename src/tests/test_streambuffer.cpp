@@ -0,0 +1,123 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "render/streambuffer.h"
+#include "tests/glstub.h"
+
+using namespace base;
+using namespace base::opengl;
+
+namespace {
+
+struct stream_buffer : public ::testing::Test
+{
+    void SetUp() {
+        glstub::init( GL );
+    }
+
+    DeviceContext GL;
+};
+
+} // namespace
+
+TEST_F( stream_buffer, persistent_allocations )
+{
+    StreamBuffer stream( GL, BufferTarget::Uniform, 1000 );
+    ASSERT_TRUE( stream.persistent() );
+    EXPECT_EQ( 1024u, stream.frameSize() );
+    EXPECT_EQ( StreamBuffer::kFrames * 1024u, glstub::calls().storage.size() );
+
+    StreamBuffer::Allocation a = stream.allocate( 10 );
+    StreamBuffer::Allocation b = stream.allocate( 64, 256 );
+    StreamBuffer::Allocation c = stream.allocate( 4, 4 );
+    EXPECT_EQ( 0u, a.offset );
+    EXPECT_EQ( 256u, b.offset );
+    EXPECT_EQ( 320u, c.offset );
+    EXPECT_EQ( 324u, stream.used() );
+    // write pointer is mapped memory at offset
+    memset( b.data, 0x5a, 64 );
+    EXPECT_EQ( 0x5a, glstub::calls().storage[b.offset] );
+    EXPECT_EQ( 0x5a, glstub::calls().storage[b.offset + 63] );
+
+    // full region
+    EXPECT_TRUE( stream.allocate( 2048 ).data == nullptr );
+    EXPECT_EQ( 324u, stream.used() );
+    EXPECT_EQ( 336u + 2048u, stream.needed() );
+
+    // next frames take next regions, then the first one again
+    for ( u32 frame = 1; frame <= StreamBuffer::kFrames; frame++ ) {
+        stream.endFrame();
+        stream.beginFrame();
+        EXPECT_EQ( 0u, stream.used() );
+        EXPECT_EQ( 0u, stream.needed() );
+        EXPECT_EQ( ( frame % StreamBuffer::kFrames ) * 1024u, stream.allocate( 16 ).offset );
+    }
+    EXPECT_TRUE( glstub::calls().subDataSizes.empty() );
+}
+
+TEST_F( stream_buffer, waits_for_fence_of_reused_region )
+{
+    StreamBuffer stream( GL, BufferTarget::Array, 1024 );
+    for ( u32 frame = 0; frame < StreamBuffer::kFrames - 1; frame++ ) {
+        stream.endFrame();
+        stream.beginFrame();
+    }
+    // regions of frames in flight are not reused yet
+    EXPECT_EQ( 0u, glstub::calls().clientWaits );
+    EXPECT_EQ( StreamBuffer::kFrames - 1, glstub::calls().fences );
+
+    glstub::calls().timeouts = 2;
+    stream.endFrame();
+    stream.beginFrame();
+    EXPECT_EQ( 3u, glstub::calls().clientWaits );
+    EXPECT_EQ( 1u, stream.waits() );
+    EXPECT_EQ( StreamBuffer::kFrames - 1, glstub::calls().fences );
+
+    // signaled fence does not count as wait
+    stream.endFrame();
+    stream.beginFrame();
+    EXPECT_EQ( 1u, stream.waits() );
+}
+
+TEST_F( stream_buffer, staged_upload_without_storage )
+{
+    GL.BufferStorage = nullptr;
+    StreamBuffer stream( GL, BufferTarget::Array, 1024 );
+    ASSERT_FALSE( stream.persistent() );
+    EXPECT_EQ( 1u, glstub::calls().bufferData );
+
+    for ( u32 i = 0; i < 8; i++ )
+        ASSERT_TRUE( stream.allocate( 12, 4 ).data != nullptr );
+    stream.flush();
+    // many allocations, one upload
+    ASSERT_EQ( 1u, glstub::calls().subDataSizes.size() );
+    EXPECT_EQ( 0u, glstub::calls().subDataOffsets[0] );
+    EXPECT_EQ( 96u, glstub::calls().subDataSizes[0] );
+
+    stream.allocate( 4 );
+    stream.endFrame();
+    ASSERT_EQ( 2u, glstub::calls().subDataSizes.size() );
+    EXPECT_EQ( 96u, glstub::calls().subDataOffsets[1] );
+    stream.flush();
+    EXPECT_EQ( 2u, glstub::calls().subDataSizes.size() );
+
+    stream.beginFrame();
+    stream.allocate( 8 );
+    stream.endFrame();
+    EXPECT_EQ( 1024u, glstub::calls().subDataOffsets[2] );
+}
+
+TEST_F( stream_buffer, frame_index_without_sync )
+{
+    GL.FenceSync = nullptr;
+    StreamBuffer stream( GL, BufferTarget::Array, 1024 );
+    for ( u32 frame = 0; frame < 2 * StreamBuffer::kFrames + 1; frame++ ) {
+        stream.endFrame();
+        stream.beginFrame();
+    }
+    EXPECT_EQ( 0u, glstub::calls().clientWaits );
+    EXPECT_EQ( 1024u, stream.allocate( 4 ).offset );
+}
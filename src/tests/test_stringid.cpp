@@ -0,0 +1,51 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/stringid.h"
+
+using base::StringId;
+using base::hashString64;
+using base::hashString32;
+
+static_assert( hashString64( "" ) == 14695981039346656037ULL, "FNV-1a offset basis" );
+static_assert( hashString64( "a" ) == 0xaf63dc4c8601ec8cULL, "FNV-1a 64 of 'a'" );
+static_assert( hashString32( "a" ) == 0xe40c292cu, "FNV-1a 32 of 'a'" );
+
+TEST( stringid, compile_time_equals_runtime )
+{
+    EXPECT_EQ( StringId( "mvp" ), STRING_ID( "mvp" ) );
+    EXPECT_EQ( StringId::hash( "default_material" ), hashString64( "default_material" ) );
+    EXPECT_NE( StringId( "mvp" ), StringId( "mv" ) );
+}
+
+TEST( stringid, interned )
+{
+    std::string name = "themodel";
+    StringId id( name );
+    EXPECT_STREQ( "themodel", id.c_str() );
+    EXPECT_STREQ( "themodel", StringId::fromValue( id.value() ).c_str() );
+    EXPECT_STREQ( "#000000000000002a", StringId::fromValue( 42 ).c_str() );
+    EXPECT_STREQ( "", StringId().c_str() );
+    EXPECT_TRUE( StringId().isEmpty() );
+}
+
+TEST( stringid, concatenation )
+{
+    StringId obj( "camera1" );
+    EXPECT_EQ( StringId( "camera1.transform" ).value(), StringId::hash( ".transform", obj.value() ) );
+}
+
+TEST( stringid, literal_in_loop )
+{
+    // same call site gives the same id on every pass
+    for ( int i = 0; i < 3; i++ ) {
+        StringId id = STRING_ID( "loop_literal" );
+        EXPECT_EQ( hashString64( "loop_literal" ), id.value() );
+#ifdef _DEBUG
+        EXPECT_STREQ( "loop_literal", id.c_str() );
+#endif
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/timer.h"
+#include <math.h>
+#include <stdio.h>
+#include <thread>
+
+using base::Clock;
+using base::ClockSelfTest;
+using base::Timer;
+using base::u64;
+
+TEST( timer, monotonic )
+{
+    u64 a = Clock::nanoseconds();
+    u64 b = Clock::nanoseconds();
+    EXPECT_GE( b, a );
+
+    u64 c0 = Clock::cycles();
+    std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+    u64 c1 = Clock::cycles();
+    EXPECT_GT( c1, c0 );
+    u64 duration = Clock::cyclesToDuration( c1 - c0 );
+    EXPECT_GE( duration, 4000000u );
+    EXPECT_LT( duration, 500000000u );
+
+    // converted cycles are on the same time line as nanoseconds()
+    u64 now = Clock::nanoseconds();
+    u64 converted = Clock::cyclesToNanoseconds( Clock::cycles() );
+    EXPECT_LT( converted > now ? converted - now : now - converted, 1000000u );
+}
+
+TEST( timer, elapsed )
+{
+    Timer timer;
+    std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+    EXPECT_GE( timer.elapsedNanoseconds(), 2000000u );
+    EXPECT_GE( timer.elapsed(), 2.0f );
+    u64 elapsed = timer.resetNanoseconds();
+    EXPECT_GE( elapsed, 2000000u );
+    EXPECT_LT( timer.elapsedNanoseconds(), elapsed );
+}
+
+TEST( timer, self_test )
+{
+    ClockSelfTest t = Clock::selfTest( 50 );
+    printf( "nanoseconds(): %.1f ns/call\n", t.nanosecondsOverhead );
+    printf( "cycles():      %.1f ns/call (%s, %.3f cycles/ns)\n",
+        t.cyclesOverhead, t.tsc ? "tsc" : "monotonic clock", t.cyclesPerNanosecond );
+    printf( "drift:         %.1f ppm\n", t.driftPpm );
+    EXPECT_LT( t.nanosecondsOverhead, 10000.0 );
+    EXPECT_LT( t.cyclesOverhead, 10000.0 );
+    // 0.1% over 50 ms is 50 us, enough to resolve scopes of a few us
+    EXPECT_LT( fabs( t.driftPpm ), 1000.0 );
+}
@@ -0,0 +1,339 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "render/uniformblock.h"
+#include "render/commandbuffer.h"
+#include "render/streambuffer.h"
+#include "render/glcontext.h"
+#include "render/gpuprogram.h"
+#include "render/mesh.h"
+#include "base/parameter.h"
+#include "tests/glstub.h"
+#include <string.h>
+
+using namespace base;
+using namespace base::opengl;
+
+namespace {
+
+//! Device context with stub functions and program which declares Frame, Material and Object blocks
+struct uniform_block : public glstub::Test
+{
+    void SetUp() {
+        glstub::Test::SetUp();
+        glstub::calls().blocks = true;
+        program = glstub::makeProgram( GL );
+        for ( u32 i = 0; i < 2; i++ )
+            materials[i].set( StringId( "color" ), Variant( math::vec4f( static_cast<f32>( i + 1 ), 0.0f, 0.0f, 1.0f ) ) );
+        mesh = new Mesh;
+        mesh->addAttribute( VertexAttrs::tagPosition ).vertexCount( 3 ).indexCount( 3, IndexTypes::UInt16 );
+        mesh->complete();
+    }
+    void TearDown() {
+        delete mesh;
+        delete program;
+        glstub::Test::TearDown();
+    }
+
+    DrawCommand command( u32 material, const math::Matrix4* matrix ) {
+        DrawCommand c;
+        c.mesh = mesh;
+        c.program = program;
+        c.materialParams = &materials[material];
+        c.meshParams = nullptr;
+        c.mvp = matrix;
+        c.instances = 1;
+        c.from = 0;
+        c.count = 3;
+        return c;
+    }
+
+    GpuProgram* program;
+    Params materials[2];
+    Mesh* mesh;
+};
+
+} // namespace
+
+TEST_F( uniform_block, reflection )
+{
+    ASSERT_TRUE( program->hasBlocks() );
+    const UniformBlockLayout& frame = program->block( UniformBlocks::Frame );
+    const UniformBlockLayout& material = program->block( UniformBlocks::Material );
+    const UniformBlockLayout& object = program->block( UniformBlocks::Object );
+    ASSERT_TRUE( frame.valid() );
+    ASSERT_TRUE( material.valid() );
+    ASSERT_TRUE( object.valid() );
+    EXPECT_EQ( 1u, frame.index );
+    EXPECT_EQ( 16u, frame.size );
+    EXPECT_EQ( 64u, object.size );
+    EXPECT_TRUE( frame.find( StringId( "time" ) ) != nullptr );
+    EXPECT_TRUE( material.find( StringId( "color" ) ) != nullptr );
+
+    // instance name is stripped from member name
+    const UniformBlockLayout::Member* mvp = object.find( StringId( "mvp" ) );
+    ASSERT_TRUE( mvp != nullptr );
+    EXPECT_EQ( static_cast<u32>( GL_FLOAT_MAT4 ), mvp->type );
+    EXPECT_EQ( 16u, mvp->matrixStride );
+
+    // binding points do not depend on block index in program
+    EXPECT_EQ( static_cast<u32>( UniformBlocks::Object ), glstub::calls().blockBindings[0] );
+    EXPECT_EQ( static_cast<u32>( UniformBlocks::Frame ), glstub::calls().blockBindings[1] );
+    EXPECT_EQ( static_cast<u32>( UniformBlocks::Material ), glstub::calls().blockBindings[2] );
+
+    // block members are not set as uniforms
+    program->setParams( materials[0] );
+    EXPECT_EQ( 0u, glstub::calls().uniforms );
+}
+
+TEST( uniform_block_layout, pack )
+{
+    UniformBlockLayout layout;
+    layout.binding = UniformBlocks::Material;
+    layout.size = 96;
+    UniformBlockLayout::Member flag = { StringId( "flag" ), GL_BOOL, 0, 0, 1, 0 };
+    UniformBlockLayout::Member color = { StringId( "color" ), GL_FLOAT_VEC4, 16, 0, 1, 0 };
+    UniformBlockLayout::Member matrix = { StringId( "matrix" ), GL_FLOAT_MAT4, 32, 16, 1, 0 };
+    layout.members.push_back( flag );
+    layout.members.push_back( color );
+    layout.members.push_back( matrix );
+
+    math::Matrix4 m( math::vec4f( 1.0f, 2.0f, 3.0f, 4.0f ), math::vec4f( 5.0f, 6.0f, 7.0f, 8.0f ),
+        math::vec4f( 9.0f, 10.0f, 11.0f, 12.0f ), math::vec4f( 13.0f, 14.0f, 15.0f, 16.0f ) );
+    Params params;
+    params.set( StringId( "flag" ), Variant( true ) );
+    params.set( StringId( "color" ), Variant( math::vec4f( 0.5f, 0.25f, 0.125f, 1.0f ) ) );
+    params.set( StringId( "matrix" ), Variant( m ) );
+    params.set( StringId( "other" ), Variant( 1.0f ) );
+
+    u8 block[96];
+    memset( block, 0xff, sizeof( block ) );
+    layout.pack( params, block );
+
+    u32 flagValue;
+    memcpy( &flagValue, block, sizeof( flagValue ) );
+    EXPECT_EQ( 1u, flagValue );
+    f32 values[20];
+    memcpy( values, block + 16, sizeof( values ) );
+    EXPECT_EQ( 0.5f, values[0] );
+    EXPECT_EQ( 1.0f, values[3] );
+    for ( u32 i = 0; i < 16; i++ )
+        EXPECT_EQ( static_cast<f32>( i + 1 ), values[4 + i] );
+
+    // member of other type is reported and left as is
+    u8 before[16];
+    memcpy( before, block + 16, sizeof( before ) );
+    EXPECT_TRUE( layout.write( StringId( "color" ), ParamType::Float, values, block ) );
+    EXPECT_EQ( 0, memcmp( before, block + 16, sizeof( before ) ) );
+    EXPECT_FALSE( layout.write( StringId( "missing" ), ParamType::Float, values, block ) );
+    EXPECT_TRUE( layout.write( StringId( "color" ), ParamType::Vec4, values, block, 1 ) );
+    EXPECT_EQ( 0, memcmp( before, block + 16, sizeof( before ) ) );
+}
+
+TEST_F( uniform_block, submit_binds_ranges )
+{
+    math::Matrix4 matrices[4];
+    for ( u32 i = 0; i < 4; i++ ) {
+        f32 v = static_cast<f32>( i );
+        matrices[i] = math::Matrix4( math::vec4f( v, 0.0f, 0.0f, 0.0f ), math::vec4f( 0.0f, v, 0.0f, 0.0f ),
+            math::vec4f( 0.0f, 0.0f, v, 0.0f ), math::vec4f( 0.0f, 0.0f, 0.0f, 1.0f ) );
+    }
+    CommandBuffer commands;
+    for ( u32 i = 0; i < 4; i++ )
+        commands.add( 0, static_cast<f32>( i ), command( i % 2, &matrices[i] ) );
+
+    StreamBuffer stream( GL, BufferTarget::Uniform, 4096 );
+    ASSERT_TRUE( stream.persistent() );
+    stream.beginFrame();
+    Params pass;
+    pass.set( StringId( "time" ), Variant( 2.0f ) );
+    CommandBuffer::Stats stats = commands.submit( GL, pass, &stream );
+    stream.endFrame();
+
+    EXPECT_EQ( 4u, stats.draws );
+    EXPECT_EQ( 4u, glstub::calls().draws );
+    EXPECT_EQ( 0u, glstub::calls().uniforms );
+
+    // one frame range, one range per material, one object range per draw
+    u32 counts[UniformBlocks::Count] = { 0, 0, 0 };
+    const std::vector<u8>& storage = glstub::calls().storage;
+    for ( const glstub::Range& range : glstub::calls().ranges ) {
+        ASSERT_LT( range.index, static_cast<u32>( UniformBlocks::Count ) );
+        counts[range.index]++;
+        EXPECT_EQ( 0u, range.offset % 256 );
+        EXPECT_EQ( program->block( static_cast<UniformBlockBinding>( range.index ) ).size, range.size );
+        f32 first;
+        memcpy( &first, storage.data() + range.offset, sizeof( first ) );
+        if ( range.index == UniformBlocks::Frame ) {
+            EXPECT_EQ( 2.0f, first );
+        } else if ( range.index == UniformBlocks::Material ) {
+            EXPECT_TRUE( first == 1.0f || first == 2.0f );
+        }
+    }
+    EXPECT_EQ( 1u, counts[UniformBlocks::Frame] );
+    EXPECT_EQ( 2u, counts[UniformBlocks::Material] );
+    EXPECT_EQ( 4u, counts[UniformBlocks::Object] );
+
+    // object ranges follow sorted order
+    u32 draw = 0;
+    for ( const glstub::Range& range : glstub::calls().ranges ) {
+        if ( range.index != UniformBlocks::Object )
+            continue;
+        const math::Matrix4* mvp = commands.sorted( draw++ ).mvp;
+        EXPECT_EQ( 0, memcmp( mvp, storage.data() + range.offset, 16 * sizeof( f32 ) ) );
+    }
+}
+
+TEST_F( uniform_block, frame_packed_once )
+{
+    GpuProgram* other = glstub::makeProgram( GL );
+    math::Matrix4 matrix = math::Matrix4::Identity();
+    CommandBuffer commands;
+    for ( u32 i = 0; i < 4; i++ ) {
+        DrawCommand c = command( 0, &matrix );
+        if ( i % 2 == 1 )
+            c.program = other;
+        commands.add( 0, static_cast<f32>( i ), c );
+    }
+
+    StreamBuffer stream( GL, BufferTarget::Uniform, 4096 );
+    stream.beginFrame();
+    CommandBuffer::Stats stats = commands.submit( GL, Params(), &stream );
+    stream.endFrame();
+
+    // programs with same Frame layout use one range, binding point keeps it
+    EXPECT_EQ( 2u, stats.programChanges );
+    u32 frames = 0;
+    for ( const glstub::Range& range : glstub::calls().ranges ) {
+        if ( range.index == UniformBlocks::Frame )
+            frames++;
+    }
+    EXPECT_EQ( 1u, frames );
+    // frame, material for each program and object for each draw, last one is not padded
+    EXPECT_EQ( 6 * 256u + program->block( UniformBlocks::Object ).size, stream.used() );
+    delete other;
+}
+
+TEST_F( uniform_block, skip_draws_without_material_block )
+{
+    math::Matrix4 matrices[4];
+    CommandBuffer commands;
+    for ( u32 i = 0; i < 4; i++ ) {
+        matrices[i] = math::Matrix4::Identity();
+        commands.add( 0, static_cast<f32>( i ), command( i / 2, &matrices[i] ) );
+    }
+
+    // room for frame, first material and its two draws only
+    StreamBuffer stream( GL, BufferTarget::Uniform, 4 * 256 );
+    stream.beginFrame();
+    CommandBuffer::Stats stats = commands.submit( GL, Params(), &stream );
+    stream.endFrame();
+
+    // draws of second material would read values of first one
+    EXPECT_EQ( 2u, stats.draws );
+    EXPECT_EQ( 2u, glstub::calls().draws );
+    u32 materials = 0;
+    for ( const glstub::Range& range : glstub::calls().ranges ) {
+        if ( range.index == UniformBlocks::Material )
+            materials++;
+    }
+    EXPECT_EQ( 1u, materials );
+}
+
+TEST_F( uniform_block, skip_draws_without_object_block )
+{
+    math::Matrix4 matrices[4];
+    CommandBuffer commands;
+    for ( u32 i = 0; i < 4; i++ ) {
+        matrices[i] = math::Matrix4::Identity();
+        commands.add( 0, static_cast<f32>( i ), command( 0, &matrices[i] ) );
+    }
+
+    // room for frame, material and first draw only
+    StreamBuffer stream( GL, BufferTarget::Uniform, 3 * 256 );
+    stream.beginFrame();
+    CommandBuffer::Stats stats = commands.submit( GL, Params(), &stream );
+
+    // other draws would take matrix of the first one
+    EXPECT_EQ( 1u, stats.draws );
+    EXPECT_EQ( 1u, glstub::calls().draws );
+    u32 objects = 0;
+    for ( const glstub::Range& range : glstub::calls().ranges ) {
+        if ( range.index == UniformBlocks::Object )
+            objects++;
+    }
+    EXPECT_EQ( 1u, objects );
+    // stream knows size which would hold all blocks
+    EXPECT_EQ( 5 * 256u + program->block( UniformBlocks::Object ).size, stream.needed() );
+    stream.endFrame();
+
+    StreamBuffer larger( GL, BufferTarget::Uniform, stream.needed() );
+    larger.beginFrame();
+    stats = commands.submit( GL, Params(), &larger );
+    larger.endFrame();
+    EXPECT_EQ( 4u, stats.draws );
+}
+
+typedef glstub::Test uniform_block_instanced;
+
+TEST_F( uniform_block_instanced, submit_draws_instances )
+{
+    glstub::calls().blocks = true;
+    glstub::calls().instanceArray = true;
+    GpuProgram* program = glstub::makeProgram( GL );
+    // array name comes with [0] suffix
+    ASSERT_TRUE( program->block( UniformBlocks::Object ).find( StringId( "mvp" ) ) != nullptr );
+    EXPECT_EQ( 4u, program->instanceCapacity() );
+
+    Mesh* mesh = new Mesh;
+    mesh->addAttribute( VertexAttrs::tagPosition ).vertexCount( 3 ).indexCount( 3, IndexTypes::UInt16 );
+    mesh->complete();
+    Params material;
+    math::Matrix4 matrices[6];
+    for ( u32 i = 0; i < 6; i++ ) {
+        matrices[i] = math::Matrix4::Identity();
+        matrices[i].SetElem( 0, 0, static_cast<f32>( i + 1 ) );
+    }
+    DrawCommand c;
+    c.mesh = mesh;
+    c.program = program;
+    c.materialParams = &material;
+    c.meshParams = nullptr;
+    c.mvp = matrices;
+    c.instances = 6;
+    c.from = 0;
+    c.count = 3;
+    CommandBuffer commands;
+    commands.add( 0, 1.0f, c );
+
+    StreamBuffer* stream = new StreamBuffer( GL, BufferTarget::Uniform, 4096 );
+    stream->beginFrame();
+    CommandBuffer::Stats stats = commands.submit( GL, Params(), stream );
+    stream->endFrame();
+
+    // 6 instances by 4 per draw
+    EXPECT_EQ( 2u, stats.draws );
+    EXPECT_EQ( 6u, stats.instances );
+    ASSERT_EQ( 2u, glstub::calls().drawInstances.size() );
+    EXPECT_EQ( 4u, glstub::calls().drawInstances[0] );
+    EXPECT_EQ( 2u, glstub::calls().drawInstances[1] );
+    std::vector<u32> objects;
+    for ( const glstub::Range& range : glstub::calls().ranges ) {
+        if ( range.index == UniformBlocks::Object )
+            objects.push_back( range.offset );
+    }
+    ASSERT_EQ( 2u, objects.size() );
+    // matrices follow each other by array stride
+    const std::vector<u8>& storage = glstub::calls().storage;
+    for ( u32 i = 0; i < 6; i++ ) {
+        const u8* element = storage.data() + objects[i / 4] + ( i % 4 ) * 64;
+        EXPECT_EQ( 0, memcmp( &matrices[i], element, 16 * sizeof( f32 ) ) );
+    }
+
+    delete stream;
+    delete mesh;
+    delete program;
+}
@@ -0,0 +1,272 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "render/vertexformat.h"
+#include "render/meshbuffers.h"
+#include "render/renderstate.h"
+#include "render/gpuprogram.h"
+#include "render/mesh.h"
+#include "math/vec3.h"
+#include "tests/glstub.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace base;
+using namespace base::opengl;
+
+namespace {
+
+f32 snorm10( u32 packed, u32 shift )
+{
+    i32 v = static_cast<i32>( packed << ( 22 - shift ) ) >> 22;
+    return static_cast<f32>( v ) / 511.0f;
+}
+
+math::vec3f decodeOctahedral( const i16* e )
+{
+    math::vec3f n( e[0] / 32767.0f, e[1] / 32767.0f, 0.0f );
+    n.z = 1.0f - fabsf( n.x ) - fabsf( n.y );
+    if ( n.z < 0.0f ) {
+        f32 x = n.x;
+        n.x = ( 1.0f - fabsf( n.y ) ) * ( x >= 0.0f ? 1.0f : -1.0f );
+        n.y = ( 1.0f - fabsf( x ) ) * ( n.y >= 0.0f ? 1.0f : -1.0f );
+    }
+    f32 length = sqrtf( n.x * n.x + n.y * n.y + n.z * n.z );
+    return math::vec3f( n.x / length, n.y / length, n.z / length );
+}
+
+math::vec3f randomUnit()
+{
+    math::vec3f v;
+    f32 length = 0.0f;
+    do {
+        v = math::vec3f( rand() / ( RAND_MAX * 0.5f ) - 1.0f, rand() / ( RAND_MAX * 0.5f ) - 1.0f,
+            rand() / ( RAND_MAX * 0.5f ) - 1.0f );
+        length = sqrtf( v.x * v.x + v.y * v.y + v.z * v.z );
+    } while ( length < 0.1f || length > 1.0f );
+    return math::vec3f( v.x / length, v.y / length, v.z / length );
+}
+
+//! Stub context and program reading position, normal and texture coordinates
+struct vertex_format : public glstub::Test
+{
+    void SetUp() {
+        glstub::Test::SetUp();
+        program = glstub::makeProgram( GL, { { "position", VertexAttrs::tagPosition, 0 },
+            { "normal", VertexAttrs::tagNormal, 0 }, { "uv", VertexAttrs::tagTexture, 0 } } );
+    }
+    void TearDown() {
+        delete program;
+        glstub::Test::TearDown();
+    }
+
+    void fill( Mesh& mesh, u32 vertexCount, IndexType indexType ) {
+        mesh.addAttribute( VertexAttrs::tagPosition ).addAttribute( VertexAttrs::tagNormal ).addAttribute( VertexAttrs::tagTexture );
+        mesh.vertexCount( vertexCount ).indexCount( 3, indexType );
+        mesh.complete();
+        math::vec3f* positions = mesh.findAttribute<math::vec3f>( VertexAttrs::tagPosition );
+        math::vec3f* normals = mesh.findAttribute<math::vec3f>( VertexAttrs::tagNormal );
+        math::vec2f* uvs = mesh.findAttribute<math::vec2f>( VertexAttrs::tagTexture );
+        for ( u32 i = 0; i < vertexCount; i++ ) {
+            positions[i] = math::vec3f( 1.0f, 2.0f, 3.0f );
+            normals[i] = math::vec3f( 0.0f, 0.0f, 1.0f );
+            uvs[i] = math::vec2f( 0.5f, 0.25f );
+        }
+        if ( indexType == IndexTypes::UInt32 ) {
+            u32* indices = static_cast<u32*>( mesh.indices() );
+            indices[0] = 0;
+            indices[1] = 1;
+            indices[2] = vertexCount - 1;
+        } else {
+            u16* indices = static_cast<u16*>( mesh.indices() );
+            indices[0] = 0;
+            indices[1] = 1;
+            indices[2] = static_cast<u16>( vertexCount - 1 );
+        }
+    }
+
+    void draw( const Mesh& mesh ) {
+        GL.setProgram( program );
+        GL.renderState().render( mesh, 0, 3 );
+    }
+
+    GpuProgram* program;
+};
+
+} // namespace
+
+TEST( vertex_formats, half )
+{
+    EXPECT_EQ( 0x0000, VertexFormats::FloatToHalf( 0.0f ) );
+    EXPECT_EQ( 0x8000, VertexFormats::FloatToHalf( -0.0f ) );
+    EXPECT_EQ( 0x3c00, VertexFormats::FloatToHalf( 1.0f ) );
+    EXPECT_EQ( 0x3800, VertexFormats::FloatToHalf( 0.5f ) );
+    EXPECT_EQ( 0xc000, VertexFormats::FloatToHalf( -2.0f ) );
+    EXPECT_EQ( 0x3555, VertexFormats::FloatToHalf( 1.0f / 3.0f ) );
+    EXPECT_EQ( 0x7bff, VertexFormats::FloatToHalf( 65504.0f ) );
+    EXPECT_EQ( 0x7c00, VertexFormats::FloatToHalf( 65536.0f ) );
+    EXPECT_EQ( 0xfc00, VertexFormats::FloatToHalf( -1e10f ) );
+    // smallest denormal and value rounding to it
+    EXPECT_EQ( 0x0001, VertexFormats::FloatToHalf( 5.9604645e-8f ) );
+    EXPECT_EQ( 0x0001, VertexFormats::FloatToHalf( 4.0e-8f ) );
+    EXPECT_EQ( 0x0000, VertexFormats::FloatToHalf( 2.0e-8f ) );
+    // ties go to even mantissa
+    EXPECT_EQ( 0x3c00, VertexFormats::FloatToHalf( 1.0f + 1.0f / 2048.0f ) );
+    EXPECT_EQ( 0x3c02, VertexFormats::FloatToHalf( 1.0f + 3.0f / 2048.0f ) );
+}
+
+TEST( vertex_formats, sizes )
+{
+    EXPECT_EQ( 12u, VertexFormats::GetSize( VertexFormats::Float, VertexAttrs::tagNormal ) );
+    EXPECT_EQ( 8u, VertexFormats::GetSize( VertexFormats::Half, VertexAttrs::tagPosition ) );
+    EXPECT_EQ( 4u, VertexFormats::GetComponentCount( VertexFormats::Half, VertexAttrs::tagPosition ) );
+    EXPECT_EQ( 4u, VertexFormats::GetSize( VertexFormats::Half, VertexAttrs::tagTexture ) );
+    EXPECT_EQ( 4u, VertexFormats::GetSize( VertexFormats::Int2101010, VertexAttrs::tagNormal ) );
+    EXPECT_EQ( 4u, VertexFormats::GetSize( VertexFormats::Octahedral, VertexAttrs::tagTangent ) );
+    EXPECT_EQ( 4u, VertexFormats::GetSize( VertexFormats::Unorm8, VertexAttrs::tagColor ) );
+    EXPECT_FALSE( VertexFormats::IsCompatible( VertexFormats::Int2101010, VertexAttrs::tagTexture ) );
+    EXPECT_FALSE( VertexFormats::IsCompatible( VertexFormats::Octahedral, VertexAttrs::tagColor ) );
+    EXPECT_TRUE( VertexFormats::IsCompatible( VertexFormats::Unorm8, VertexAttrs::tagColor ) );
+}
+
+TEST( vertex_formats, unit_vectors )
+{
+    srand( 11 );
+    for ( u32 i = 0; i < 1000; i++ ) {
+        math::vec3f n = randomUnit();
+
+        u32 packed;
+        VertexFormats::Encode( VertexFormats::Int2101010, VertexAttrs::tagNormal,
+            reinterpret_cast<const u8*>( &n ), 1, reinterpret_cast<u8*>( &packed ), sizeof( packed ) );
+        EXPECT_NEAR( n.x, snorm10( packed, 0 ), 1.0f / 1022.0f );
+        EXPECT_NEAR( n.y, snorm10( packed, 10 ), 1.0f / 1022.0f );
+        EXPECT_NEAR( n.z, snorm10( packed, 20 ), 1.0f / 1022.0f );
+        EXPECT_EQ( 0u, packed >> 30 );
+
+        i16 e[2];
+        VertexFormats::Encode( VertexFormats::Octahedral, VertexAttrs::tagNormal,
+            reinterpret_cast<const u8*>( &n ), 1, reinterpret_cast<u8*>( e ), sizeof( e ) );
+        math::vec3f d = decodeOctahedral( e );
+        EXPECT_NEAR( n.x, d.x, 1e-4f );
+        EXPECT_NEAR( n.y, d.y, 1e-4f );
+        EXPECT_NEAR( n.z, d.z, 1e-4f );
+    }
+}
+
+TEST( vertex_formats, color )
+{
+    math::vec4f colors[2] = { math::vec4f( 1.0f, 0.0f, 0.5f, 1.0f ), math::vec4f( 2.0f, -1.0f, 0.2f, 0.0f ) };
+    u32 packed[2];
+    VertexFormats::Encode( VertexFormats::Unorm8, VertexAttrs::tagColor,
+        reinterpret_cast<const u8*>( colors ), 2, reinterpret_cast<u8*>( packed ), sizeof( u32 ) );
+    EXPECT_EQ( 0xff8000ffu, packed[0] );
+    EXPECT_EQ( 0x003300ffu, packed[1] );
+}
+
+TEST_F( vertex_format, planar_float_by_default )
+{
+    Mesh mesh;
+    fill( mesh, 100, IndexTypes::UInt16 );
+    draw( mesh );
+    const glstub::Calls& calls = glstub::calls();
+    ASSERT_EQ( 2u, calls.bufferSizes.size() );
+    EXPECT_EQ( 100u * 32, calls.bufferSizes[0] );
+    EXPECT_EQ( 100u * 32, mesh.rawSize() );
+    ASSERT_EQ( 3u, calls.pointers.size() );
+    EXPECT_EQ( static_cast<u32>( GL_FLOAT ), calls.pointers[1].type );
+    EXPECT_FALSE( calls.pointers[1].normalized );
+    EXPECT_EQ( 12u, calls.pointers[1].stride );
+    EXPECT_EQ( 100u * 12, calls.pointers[1].offset );
+}
+
+TEST_F( vertex_format, compact_interleaved )
+{
+    Mesh mesh;
+    mesh.vertexLayout( VertexLayout::compact() );
+    fill( mesh, 100, IndexTypes::UInt32 );
+    draw( mesh );
+    const glstub::Calls& calls = glstub::calls();
+    // 8 bytes of position, 4 of normal, 4 of uv instead of 32
+    ASSERT_EQ( 2u, calls.bufferSizes.size() );
+    EXPECT_EQ( 100u * 16, calls.bufferSizes[0] );
+    EXPECT_EQ( 100u * 16, mesh.upload( GL ).vertexBytes() );
+    // and 16-bit indices
+    EXPECT_EQ( 3u * 2, calls.bufferSizes[1] );
+    ASSERT_EQ( 1u, calls.drawTypes.size() );
+    EXPECT_EQ( static_cast<u32>( GL_UNSIGNED_SHORT ), calls.drawTypes[0] );
+
+    ASSERT_EQ( 3u, calls.pointers.size() );
+    const glstub::Pointer& position = calls.pointers[0];
+    const glstub::Pointer& normal = calls.pointers[1];
+    const glstub::Pointer& uv = calls.pointers[2];
+    EXPECT_EQ( static_cast<u32>( GL_HALF_FLOAT ), position.type );
+    EXPECT_EQ( 4u, position.size );
+    EXPECT_EQ( 0u, position.offset );
+    EXPECT_EQ( static_cast<u32>( GL_INT_2_10_10_10_REV ), normal.type );
+    EXPECT_TRUE( normal.normalized );
+    EXPECT_EQ( 8u, normal.offset );
+    EXPECT_EQ( static_cast<u32>( GL_HALF_FLOAT ), uv.type );
+    EXPECT_EQ( 12u, uv.offset );
+    EXPECT_EQ( 16u, position.stride );
+    EXPECT_EQ( 16u, normal.stride );
+    EXPECT_EQ( 16u, uv.stride );
+}
+
+TEST( vertex_formats, position_format )
+{
+    // unit cube around origin keeps half precision
+    f32 cube[] = { -1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+    EXPECT_EQ( VertexFormats::Half, VertexFormats::PositionFormat( cube, 2 ) );
+    // small mesh far from origin would be rounded by half of its size
+    f32 far[] = { 1000.0f, 0.0f, 0.0f, 1001.0f, 1.0f, 1.0f };
+    EXPECT_EQ( VertexFormats::Float, VertexFormats::PositionFormat( far, 2 ) );
+    // large one at same place loses same amount, which is small for its size
+    f32 large[] = { 0.0f, 0.0f, 0.0f, 1000.0f, 1000.0f, 1000.0f };
+    EXPECT_EQ( VertexFormats::Half, VertexFormats::PositionFormat( large, 2 ) );
+    // out of half range
+    f32 huge[] = { -70000.0f, 0.0f, 0.0f, 70000.0f, 0.0f, 0.0f };
+    EXPECT_EQ( VertexFormats::Float, VertexFormats::PositionFormat( huge, 2 ) );
+}
+
+TEST_F( vertex_format, packed_normals_need_gl33 )
+{
+    glstub::calls().oldContext = true;
+    Mesh mesh;
+    mesh.vertexLayout( VertexLayout::compact() );
+    fill( mesh, 100, IndexTypes::UInt16 );
+    draw( mesh );
+    const glstub::Calls& calls = glstub::calls();
+    // normal goes as floats, other attributes keep their formats
+    ASSERT_EQ( 3u, calls.pointers.size() );
+    EXPECT_EQ( static_cast<u32>( GL_HALF_FLOAT ), calls.pointers[0].type );
+    EXPECT_EQ( static_cast<u32>( GL_FLOAT ), calls.pointers[1].type );
+    EXPECT_FALSE( calls.pointers[1].normalized );
+    EXPECT_EQ( 24u, calls.pointers[1].stride );
+}
+
+TEST_F( vertex_format, packed_normals_by_extension )
+{
+    glstub::calls().oldContext = true;
+    glstub::calls().extensions.push_back( "GL_ARB_texture_storage" );
+    glstub::calls().extensions.push_back( "GL_ARB_vertex_type_2_10_10_10_rev" );
+    Mesh mesh;
+    mesh.vertexLayout( VertexLayout::compact() );
+    fill( mesh, 100, IndexTypes::UInt16 );
+    draw( mesh );
+    ASSERT_EQ( 3u, glstub::calls().pointers.size() );
+    EXPECT_EQ( static_cast<u32>( GL_INT_2_10_10_10_REV ), glstub::calls().pointers[1].type );
+}
+
+TEST_F( vertex_format, wide_indices_stay )
+{
+    Mesh mesh;
+    fill( mesh, 70000, IndexTypes::UInt32 );
+    draw( mesh );
+    EXPECT_EQ( 3u * 4, glstub::calls().bufferSizes[1] );
+    EXPECT_EQ( static_cast<u32>( GL_UNSIGNED_INT ), glstub::calls().drawTypes[0] );
+    EXPECT_EQ( IndexTypes::UInt32, mesh.upload( GL ).indexType() );
+}
@@ -0,0 +1,183 @@
+/**
+ * \file
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ **/
+#include "gtest/gtest.h"
+#include "base/lz.h"
+#include "base/pack.h"
+#include "base/vfs.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace base;
+using base::u8;
+using base::u32;
+using base::u64;
+
+namespace {
+
+std::vector<u8> bytes( const std::string& s )
+{
+    return std::vector<u8>( s.begin(), s.end() );
+}
+
+std::string text( const vfs::File& f )
+{
+    return std::string( reinterpret_cast<const char*>( f.data() ), static_cast<size_t>( f.size() ) );
+}
+
+void roundtrip( const std::vector<u8>& source )
+{
+    u32 size = static_cast<u32>( source.size() );
+    std::vector<u8> packed( lz::compressBound( size ) );
+    u32 packedSize = lz::compress( source.data(), size, packed.data(), static_cast<u32>( packed.size() ) );
+    ASSERT_NE( 0u, packedSize );
+    std::vector<u8> unpacked( size );
+    EXPECT_TRUE( lz::decompress( packed.data(), packedSize, unpacked.data(), size ) );
+    EXPECT_EQ( source, unpacked );
+}
+
+} // namespace
+
+TEST( lz, roundtrip )
+{
+    roundtrip( std::vector<u8>() );
+    roundtrip( bytes( "abc" ) );
+    std::string repeated;
+    for ( u32 i = 0; i < 1000; i++ )
+        repeated += "shader uniform vec4 ";
+    roundtrip( bytes( repeated ) );
+    std::vector<u8> noise( 70000 );
+    u32 seed = 1;
+    for ( u8& b : noise ) {
+        seed = seed * 1103515245 + 12345;
+        b = static_cast<u8>( seed >> 16 );
+    }
+    roundtrip( noise );
+    // long runs use extended length bytes and overlapping matches
+    roundtrip( std::vector<u8>( 100000, 7 ) );
+}
+
+TEST( lz, ratio )
+{
+    std::string repeated;
+    for ( u32 i = 0; i < 1000; i++ )
+        repeated += "shader uniform vec4 ";
+    std::vector<u8> packed( lz::compressBound( static_cast<u32>( repeated.size() ) ) );
+    u32 size = lz::compress( reinterpret_cast<const u8*>( repeated.data() ),
+        static_cast<u32>( repeated.size() ), packed.data(), static_cast<u32>( packed.size() ) );
+    EXPECT_LT( size, repeated.size() / 10 );
+}
+
+TEST( lz, corrupted )
+{
+    std::vector<u8> source( 1000, 1 );
+    std::vector<u8> packed( lz::compressBound( 1000 ) );
+    u32 size = lz::compress( source.data(), 1000, packed.data(), static_cast<u32>( packed.size() ) );
+    std::vector<u8> out( 1000 );
+    EXPECT_FALSE( lz::decompress( packed.data(), size - 1, out.data(), 1000 ) );
+    EXPECT_FALSE( lz::decompress( packed.data(), size, out.data(), 999 ) );
+}
+
+struct vfs_pack : public ::testing::Test
+{
+    void SetUp() {
+        std::string shader;
+        for ( u32 i = 0; i < 200; i++ )
+            shader += "uniform mat4 transform;\n";
+        PackWriter writer( 64 );
+        std::vector<u8> a = bytes( "first" );
+        std::vector<u8> b = bytes( shader );
+        writer.add( "./textures\\stone.png", a.data(), a.size(), true );
+        writer.add( "shaders/global.shader", b.data(), b.size(), true );
+        writer.add( "empty.txt", nullptr, 0, false );
+        ASSERT_TRUE( writer.write( "test_vfs.pack" ) );
+        content = shader;
+
+        FILE* f = fopen( "test_vfs_loose.txt", "wb" );
+        fputs( "loose", f );
+        fclose( f );
+    }
+    void TearDown() {
+        vfs::unmountAll();
+        remove( "test_vfs.pack" );
+        remove( "test_vfs_loose.txt" );
+    }
+    std::string content;
+};
+
+TEST_F( vfs_pack, layout )
+{
+    PackFile pack( "test_vfs.pack" );
+    ASSERT_TRUE( pack.isOpen() );
+    EXPECT_EQ( 3u, pack.count() );
+    for ( u32 i = 1; i < pack.count(); i++ )
+        EXPECT_LT( pack.entry( i - 1 ).hash, pack.entry( i ).hash );
+    for ( u32 i = 0; i < pack.count(); i++ )
+        EXPECT_EQ( 0u, pack.entry( i ).offset % 64 );
+
+    const PackEntry* stone = pack.find( "textures/stone.png" );
+    ASSERT_TRUE( stone != nullptr );
+    EXPECT_STREQ( "textures/stone.png", pack.name( *stone ) );
+    // too short to compress
+    EXPECT_EQ( 0u, stone->flags & PackEntry::Compressed );
+    EXPECT_EQ( 0, memcmp( "first", pack.payload( *stone ), 5 ) );
+
+    const PackEntry* shader = pack.find( "shaders/global.shader" );
+    ASSERT_TRUE( shader != nullptr );
+    EXPECT_NE( 0u, shader->flags & PackEntry::Compressed );
+    EXPECT_LT( shader->storedSize, shader->size );
+    EXPECT_TRUE( pack.find( "shaders/missing.shader" ) == nullptr );
+}
+
+TEST_F( vfs_pack, resolve )
+{
+    ASSERT_TRUE( vfs::mount( "test_vfs.pack" ) );
+    EXPECT_EQ( 1u, vfs::mountCount() );
+
+    vfs::File stone( "textures//stone.png" );
+    ASSERT_TRUE( stone.isOpen() );
+    EXPECT_TRUE( stone.packed() );
+    EXPECT_EQ( "first", text( stone ) );
+
+    vfs::File shader( "./shaders/global.shader" );
+    ASSERT_TRUE( shader.isOpen() );
+    EXPECT_EQ( content, text( shader ) );
+
+    vfs::File empty( "empty.txt" );
+    EXPECT_TRUE( empty.isOpen() );
+    EXPECT_EQ( 0u, empty.size() );
+
+    vfs::File loose( "test_vfs_loose.txt" );
+    ASSERT_TRUE( loose.isOpen() );
+    EXPECT_FALSE( loose.packed() );
+    EXPECT_EQ( "loose", text( loose ) );
+
+    vfs::File missing( "missing.txt" );
+    EXPECT_FALSE( missing.isOpen() );
+
+    EXPECT_TRUE( vfs::exists( "textures/stone.png" ) );
+    EXPECT_TRUE( vfs::exists( "test_vfs_loose.txt" ) );
+    EXPECT_FALSE( vfs::exists( "missing.txt" ) );
+    EXPECT_TRUE( vfs::packed( "empty.txt" ) );
+    EXPECT_FALSE( vfs::packed( "test_vfs_loose.txt" ) );
+}
+
+TEST_F( vfs_pack, mount_point )
+{
+    ASSERT_TRUE( vfs::mount( "test_vfs.pack", "data" ) );
+    EXPECT_TRUE( vfs::packed( "data/textures/stone.png" ) );
+    EXPECT_TRUE( vfs::packed( "data\\shaders\\global.shader" ) );
+    EXPECT_FALSE( vfs::packed( "textures/stone.png" ) );
+    EXPECT_FALSE( vfs::packed( "database/textures/stone.png" ) );
+}
+
+TEST_F( vfs_pack, not_a_pack )
+{
+    EXPECT_FALSE( vfs::mount( "test_vfs_loose.txt" ) );
+    EXPECT_FALSE( vfs::mount( "missing.pack" ) );
+    EXPECT_EQ( 0u, vfs::mountCount() );
+}
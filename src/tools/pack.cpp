@@ -0,0 +1,117 @@
+/**
+ * \file
+ * \brief       packs directory into archive readable by base::vfs
+ * \author      Alexey Vasilyev <alexa.infra@gmail.com>
+ * \copyright   MIT License
+ *
+ * usage: negine-pack [-z] [-a alignment] <directory> <output.pack>
+ **/
+#include "base/pack.h"
+#include "base/io.h"
+#include "base/memorytags.h"
+#include "base/path.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef OS_WIN
+# include <windows.h>
+#else
+# include <dirent.h>
+# include <sys/stat.h>
+#endif
+
+using namespace base;
+
+//! Collects paths of regular files relative to root
+static void listFiles(const std::string& root, const std::string& relative, std::vector<std::string>& files)
+{
+    std::string dir = relative.empty() ? root : root + "/" + relative;
+#ifdef OS_WIN
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((dir + "/*").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+    do {
+        std::string name = data.cFileName;
+        if (name == "." || name == "..")
+            continue;
+        std::string child = relative.empty() ? name : relative + "/" + name;
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            listFiles(root, child, files);
+        else
+            files.push_back(child);
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+#else
+    DIR* d = opendir(dir.c_str());
+    if (d == nullptr)
+        return;
+    while (dirent* e = readdir(d)) {
+        std::string name = e->d_name;
+        if (name == "." || name == "..")
+            continue;
+        std::string child = relative.empty() ? name : relative + "/" + name;
+        struct stat st;
+        if (stat((root + "/" + child).c_str(), &st) != 0)
+            continue;
+        if (S_ISDIR(st.st_mode))
+            listFiles(root, child, files);
+        else if (S_ISREG(st.st_mode))
+            files.push_back(child);
+    }
+    closedir(d);
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    bool compress = false;
+    u32 alignment = 16;
+    std::vector<const char*> args;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-z") == 0)
+            compress = true;
+        else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+            alignment = static_cast<u32>(atoi(argv[++i]));
+        else
+            args.push_back(argv[i]);
+    }
+    if (args.size() != 2) {
+        fprintf(stderr, "usage: negine-pack [-z] [-a alignment] <directory> <output.pack>\n");
+        return 1;
+    }
+    std::string root = path::normpath(args[0]);
+    if (root.size() > 1 && root.back() == '/')
+        root.pop_back();
+
+    memory::init();
+    std::vector<std::string> files;
+    listFiles(root, "", files);
+
+    PackWriter writer(alignment);
+    u64 total = 0;
+    bool ok = true;
+    for (const std::string& file : files) {
+        u8* data = nullptr;
+        u64 size = 0;
+        if (io::readFile(root + "/" + file, &data, &size) != io::Status::Ok) {
+            fprintf(stderr, "can't read %s\n", file.c_str());
+            ok = false;
+            break;
+        }
+        ok = writer.add(file, data, size, compress);
+        io::release(data);
+        if (!ok)
+            break;
+        total += size;
+    }
+    ok = ok && writer.write(args[1]);
+    if (ok)
+        printf("%u files, %llu bytes packed into %s\n", writer.count(),
+            static_cast<unsigned long long>(total), args[1]);
+    memory::shutdown();
+    return ok ? 0 : 1;
+}